@@ -756,6 +756,11 @@ EGLAPI EGLBoolean EGLAPIENTRY eglExportDMABUFImageMESA (EGLDisplay dpy, EGLImage
 #define EGL_PLATFORM_GBM_MESA             0x31D7
 #endif /* EGL_MESA_platform_gbm */
 
+#ifndef EGL_MESA_platform_surfaceless
+#define EGL_MESA_platform_surfaceless 1
+#define EGL_PLATFORM_SURFACELESS_MESA     0x31DD
+#endif /* EGL_MESA_platform_surfaceless */
+
 #ifndef EGL_NOK_swap_region
 #define EGL_NOK_swap_region 1
 typedef EGLBoolean (EGLAPIENTRYP PFNEGLSWAPBUFFERSREGIONNOKPROC) (EGLDisplay dpy, EGLSurface surface, EGLint numRects, const EGLint *rects);
@@ -906,6 +911,15 @@ EGLAPI EGLuint64NV EGLAPIENTRY eglGetSystemTimeNV (void);
 #define EGL_NATIVE_SURFACE_TIZEN          0x32A1
 #endif /* EGL_TIZEN_image_native_surface */
 
+/* Not in the Khronos registry; the token values are provisional. */
+#ifndef EGL_SWIFTSHADER_shared_memory_pbuffer
+#define EGL_SWIFTSHADER_shared_memory_pbuffer 1
+#define EGL_SHARED_MEMORY_SWIFTSHADER         0x3490
+#define EGL_SHARED_MEMORY_FD_SWIFTSHADER      0x3491
+#define EGL_SHARED_MEMORY_STRIDE_SWIFTSHADER  0x3492
+#define EGL_SHARED_MEMORY_FOURCC_SWIFTSHADER  0x3493
+#endif /* EGL_SWIFTSHADER_shared_memory_pbuffer */
+
 #ifdef __cplusplus
 }
 #endif
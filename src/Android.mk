@@ -19,15 +19,19 @@ endif
 COMMON_SRC_FILES := \
 	Common/CPUID.cpp \
 	Common/Configurator.cpp \
+	Common/Counters.cpp \
 	Common/DebugAndroid.cpp \
 	Common/GrallocAndroid.cpp \
 	Common/Half.cpp \
 	Common/Math.cpp \
 	Common/Memory.cpp \
 	Common/Resource.cpp \
+	Common/ResourceRing.cpp \
+	Common/SharedMemory.cpp \
 	Common/Socket.cpp \
 	Common/Thread.cpp \
-	Common/Timer.cpp
+	Common/Timer.cpp \
+	Common/Trace.cpp
 
 COMMON_SRC_FILES += \
 	Main/Config.cpp \
@@ -36,7 +40,9 @@ COMMON_SRC_FILES += \
 	Main/SwiftConfig.cpp
 
 COMMON_SRC_FILES += \
+	Reactor/CodeHeap.cpp \
 	Reactor/Nucleus.cpp \
+	Reactor/PerfJIT.cpp \
 	Reactor/Routine.cpp \
 	Reactor/RoutineManager.cpp
 
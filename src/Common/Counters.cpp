@@ -0,0 +1,204 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Counters.hpp"
+
+#include "Thread.hpp"
+#include "MutexLock.hpp"
+
+#include <stdio.h>
+
+namespace sw
+{
+	Counters::Shard Counters::shards[SHARDS];
+
+	namespace
+	{
+		struct Description
+		{
+			const char *name;
+			bool perThread;   // Also reported for each shard
+		};
+
+		const Description description[COUNTER_LAST + 1] =
+		{
+			{"swiftshader_frames", false},
+			{"swiftshader_draws", false},
+			{"swiftshader_primitives", false},
+			{"swiftshader_primitives_culled", false},
+			{"swiftshader_primitives_clipped", false},
+			{"swiftshader_primitives_backfacing", false},
+			{"swiftshader_primitives_scissored", false},
+			{"swiftshader_pixels", false},
+			{"swiftshader_fast_clears", false},
+			{"swiftshader_fast_clear_flushes", false},
+			{"swiftshader_texture_bytes", false},
+			{"swiftshader_routine_cache_hits", false},
+			{"swiftshader_routine_cache_misses", false},
+			{"swiftshader_shader_cache_hits", false},
+			{"swiftshader_shader_cache_misses", false},
+			{"swiftshader_jit_microseconds", false},
+			{"swiftshader_jit_code_bytes", false},
+			{"swiftshader_jit_heap_bytes", false},
+			{"swiftshader_streaming_ring_bytes", false},
+			{"swiftshader_streaming_stalls", false},
+			{"swiftshader_deferred_uploads", false},
+			{"swiftshader_vertex_ticks", true},
+			{"swiftshader_setup_ticks", true},
+			{"swiftshader_pixel_ticks", true},
+		};
+
+		#if defined(_WIN32)
+			void NTAPI releaseShard(void *value);
+		#else
+			void releaseShard(void *value);
+		#endif
+
+		Thread::LocalStorageKey shardKey = Thread::allocateLocalStorageKey(releaseShard);
+		BackoffLock shardMutex;
+		bool shardTaken[Counters::SHARDS - 1];   // Shards owned by a live thread. The last one is shared.
+
+		#if defined(_WIN32)
+			void NTAPI releaseShard(void *value)
+		#else
+			void releaseShard(void *value)
+		#endif
+		{
+			size_t shard = (size_t)value - 1;
+
+			if(shard < Counters::SHARDS - 1)
+			{
+				shardMutex.lock();
+				shardTaken[shard] = false;   // Keeps its counts for the next owner to add to
+				shardMutex.unlock();
+			}
+		}
+
+		std::string ltoa(int64_t value)
+		{
+			char string[32];
+			sprintf(string, "%lld", (long long)value);
+			return string;
+		}
+	}
+
+	int Counters::shard()
+	{
+		// Shards are stored off by one, so that zero means unassigned
+		size_t slot = (size_t)Thread::getLocalStorage(shardKey);
+
+		if(slot == 0)
+		{
+			size_t shard = 0;
+
+			shardMutex.lock();
+
+			while(shard < SHARDS - 1 && shardTaken[shard])
+			{
+				shard++;
+			}
+
+			if(shard < SHARDS - 1)
+			{
+				shardTaken[shard] = true;
+			}
+
+			shardMutex.unlock();
+
+			slot = shard + 1;
+			Thread::setLocalStorage(shardKey, (void*)slot);
+		}
+
+		return (int)(slot - 1);
+	}
+
+	int64_t Counters::get(Counter counter)
+	{
+		int64_t sum = 0;
+
+		for(int i = 0; i < SHARDS; i++)
+		{
+			sum += shards[i].value[counter];
+		}
+
+		return sum;
+	}
+
+	int64_t Counters::get(Counter counter, int shard)
+	{
+		return shards[shard].value[counter];
+	}
+
+	const char *Counters::name(Counter counter)
+	{
+		return description[counter].name;
+	}
+
+	std::string Counters::text()
+	{
+		std::string text;
+
+		for(int i = 0; i <= COUNTER_LAST; i++)
+		{
+			Counter counter = (Counter)i;
+
+			text += std::string(name(counter)) + " " + ltoa(get(counter)) + "\n";
+
+			if(description[i].perThread)
+			{
+				for(int j = 0; j < SHARDS; j++)
+				{
+					if(get(counter, j) != 0)
+					{
+						text += std::string(name(counter)) + "{thread=\"" + ltoa(j) + "\"} " + ltoa(get(counter, j)) + "\n";
+					}
+				}
+			}
+		}
+
+		return text;
+	}
+
+	std::string Counters::json()
+	{
+		std::string json = "{";
+
+		for(int i = 0; i <= COUNTER_LAST; i++)
+		{
+			Counter counter = (Counter)i;
+
+			json += std::string(i ? ", " : "") + "\"" + name(counter) + "\": ";
+
+			if(description[i].perThread)
+			{
+				json += "{\"total\": " + ltoa(get(counter)) + ", \"threads\": [";
+
+				for(int j = 0; j < SHARDS; j++)
+				{
+					json += std::string(j ? ", " : "") + ltoa(get(counter, j));
+				}
+
+				json += "]}";
+			}
+			else
+			{
+				json += ltoa(get(counter));
+			}
+		}
+
+		json += "}\n";
+
+		return json;
+	}
+}
@@ -0,0 +1,106 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Counters_hpp
+#define sw_Counters_hpp
+
+#include "Types.hpp"
+#include "Thread.hpp"
+
+#include <string>
+
+namespace sw
+{
+	enum Counter
+	{
+		COUNTER_FRAMES,
+		COUNTER_DRAWS,
+		COUNTER_PRIMITIVES,
+		COUNTER_PRIMITIVES_CULLED,
+		COUNTER_PRIMITIVES_CLIPPED,
+		COUNTER_PRIMITIVES_BACKFACING,   // Back-facing or zero-area triangles culled before clipping
+		COUNTER_PRIMITIVES_SCISSORED,    // Triangles outside the scissor rectangle culled before clipping
+		COUNTER_PIXELS,                  // Covered by primitives, before any per-pixel tests
+		COUNTER_FAST_CLEARS,
+		COUNTER_FAST_CLEAR_FLUSHES,
+		COUNTER_TEXTURE_BYTES,
+		COUNTER_ROUTINE_HITS,
+		COUNTER_ROUTINE_MISSES,
+		COUNTER_SHADER_CACHE_HITS,
+		COUNTER_SHADER_CACHE_MISSES,
+		COUNTER_JIT_MICROSECONDS,
+		COUNTER_JIT_CODE_BYTES,   // Current size of the routines in the code heap
+		COUNTER_JIT_HEAP_BYTES,   // Current size of the code heap's slabs
+		COUNTER_STREAMING_RING_BYTES,   // Current size of the client array streaming rings
+		COUNTER_STREAMING_STALLS,       // Client array uploads which waited for the renderer
+		COUNTER_DEFERRED_UPLOADS,       // Texture uploads from pixel unpack buffers run by the worker threads
+		COUNTER_VERTEX_TICKS,
+		COUNTER_SETUP_TICKS,
+		COUNTER_PIXEL_TICKS,
+
+		COUNTER_LAST = COUNTER_PIXEL_TICKS
+	};
+
+	// Always-on statistics. Each thread increments its own shard, so updates
+	// are plain adds without bus locking. Readers sum the shards on demand.
+	// Shards of exited threads are reused. When more threads are live than
+	// there are shards, the extra ones share the last shard with atomic adds.
+	class Counters
+	{
+	public:
+		enum {SHARDS = 16};
+
+		static void add(Counter counter, int64_t value);
+		static void increment(Counter counter);
+
+		static int64_t get(Counter counter);
+		static int64_t get(Counter counter, int shard);
+		static const char *name(Counter counter);
+
+		static std::string text();   // One "name value" line per counter
+		static std::string json();
+
+	private:
+		struct Shard
+		{
+			volatile int64_t value[COUNTER_LAST + 1];
+			char padding[64];   // Keep neighbouring shards off each other's cache lines
+		};
+
+		static int shard();
+
+		static Shard shards[SHARDS];
+	};
+
+	inline void Counters::add(Counter counter, int64_t value)
+	{
+		int shard = Counters::shard();
+
+		if(shard < SHARDS - 1)
+		{
+			shards[shard].value[counter] += value;   // Only written by this thread
+		}
+		else
+		{
+			atomicAdd(&shards[shard].value[counter], value);
+		}
+	}
+
+	inline void Counters::increment(Counter counter)
+	{
+		add(counter, 1);
+	}
+}
+
+#endif   // sw_Counters_hpp
@@ -146,6 +146,16 @@ void markExecutable(void *memory, size_t bytes)
 	#endif
 }
 
+void markWritable(void *memory, size_t bytes, bool executable)
+{
+	#if defined(_WIN32)
+		unsigned long oldProtection;
+		VirtualProtect(memory, bytes, executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE, &oldProtection);
+	#else
+		mprotect(memory, bytes, PROT_READ | PROT_WRITE | (executable ? PROT_EXEC : 0));
+	#endif
+}
+
 void deallocateExecutable(void *memory, size_t bytes)
 {
 	#if defined(_WIN32)
@@ -27,6 +27,7 @@ void deallocate(void *memory);
 
 void *allocateExecutable(size_t bytes);   // Allocates memory that can be made executable using markExecutable()
 void markExecutable(void *memory, size_t bytes);
+void markWritable(void *memory, size_t bytes, bool executable = false);   // Executable for pages shared with code that may be running
 void deallocateExecutable(void *memory, size_t bytes);
 }
 
@@ -15,9 +15,167 @@
 #include "Resource.hpp"
 
 #include "Memory.hpp"
+#include "Trace.hpp"
+
+#include <chrono>
 
 namespace sw
 {
+	BackoffLock Timeline::criticalSection;
+	std::condition_variable_any Timeline::unblock;
+	volatile int Timeline::blocked = 0;
+
+	int64_t Timeline::submitted = 0;
+	volatile int64_t Timeline::completed = 0;
+	bool Timeline::finished[WINDOW];
+
+	Resource *Timeline::orphans = 0;
+
+	int64_t Timeline::submit()
+	{
+		criticalSection.lock();
+
+		// Don't let the oldest unretired serial get overwritten
+		while(submitted - completed >= WINDOW)
+		{
+			TraceScope scope("Timeline::submit");
+
+			blocked++;
+			unblock.wait(criticalSection);
+			blocked--;
+		}
+
+		int64_t serial = ++submitted;
+		finished[serial % WINDOW] = false;
+
+		criticalSection.unlock();
+
+		return serial;
+	}
+
+	void Timeline::retire(int64_t serial)
+	{
+		criticalSection.lock();
+
+		finished[serial % WINDOW] = true;
+
+		while(completed < submitted && finished[(completed + 1) % WINDOW])
+		{
+			completed++;
+		}
+
+		Resource *retiredOrphans = 0;
+
+		for(Resource **orphan = &orphans; *orphan;)
+		{
+			Resource *resource = *orphan;
+
+			if(resource->serial <= completed)
+			{
+				*orphan = resource->next;
+				resource->next = retiredOrphans;
+				retiredOrphans = resource;
+			}
+			else
+			{
+				orphan = &resource->next;
+			}
+		}
+
+		if(blocked)
+		{
+			unblock.notify_all();
+		}
+
+		criticalSection.unlock();
+
+		while(retiredOrphans)
+		{
+			Resource *resource = retiredOrphans;
+			retiredOrphans = resource->next;
+
+			delete resource;
+		}
+	}
+
+	bool Timeline::retired(int64_t serial)
+	{
+		criticalSection.lock();
+		bool retired = serial <= completed;
+		criticalSection.unlock();
+
+		return retired;
+	}
+
+	void Timeline::wait(int64_t serial)
+	{
+		criticalSection.lock();
+
+		while(serial > completed)
+		{
+			TraceScope scope("Timeline::wait");
+
+			blocked++;
+			unblock.wait(criticalSection);
+			blocked--;
+		}
+
+		criticalSection.unlock();
+	}
+
+	bool Timeline::wait(int64_t serial, uint64_t timeout)
+	{
+		if(timeout >= (uint64_t)1 << 62)   // Effectively infinite, including GL_TIMEOUT_IGNORED and EGL_FOREVER_KHR
+		{
+			wait(serial);
+
+			return true;
+		}
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout);
+
+		criticalSection.lock();
+
+		while(serial > completed)
+		{
+			TraceScope scope("Timeline::wait");
+
+			blocked++;
+			std::cv_status status = unblock.wait_until(criticalSection, deadline);
+			blocked--;
+
+			if(status == std::cv_status::timeout)
+			{
+				break;
+			}
+		}
+
+		bool retired = serial <= completed;
+
+		criticalSection.unlock();
+
+		return retired;
+	}
+
+	void Timeline::orphan(Resource *resource)
+	{
+		criticalSection.lock();
+
+		if(resource->serial > completed)
+		{
+			resource->next = orphans;
+			orphans = resource;
+
+			criticalSection.unlock();
+
+			return;
+		}
+
+		criticalSection.unlock();
+
+		delete resource;
+	}
+
 	Resource::Resource(size_t bytes) : size(bytes)
 	{
 		blocked = 0;
@@ -26,6 +184,9 @@ namespace sw
 		count = 0;
 		orphaned = false;
 
+		serial = 0;
+		next = 0;
+
 		buffer = allocateZero(bytes);
 	}
 
@@ -36,6 +197,11 @@ namespace sw
 
 	void *Resource::lock(Accessor claimer)
 	{
+		if(claimer == PUBLIC || claimer == DESTRUCT)
+		{
+			Timeline::wait(serial);
+		}
+
 		criticalSection.lock();
 
 		while(count != 0 && accessor != claimer)
@@ -43,6 +209,7 @@ namespace sw
 			blocked++;
 			criticalSection.unlock();
 
+			TraceScope scope("Resource::lock");
 			unblock.wait();
 
 			criticalSection.lock();
@@ -59,6 +226,11 @@ namespace sw
 
 	void *Resource::lock(Accessor relinquisher, Accessor claimer)
 	{
+		if(claimer == PUBLIC || claimer == DESTRUCT)
+		{
+			Timeline::wait(serial);
+		}
+
 		criticalSection.lock();
 
 		// Release
@@ -76,7 +248,7 @@ namespace sw
 				{
 					criticalSection.unlock();
 
-					delete this;
+					Timeline::orphan(this);
 
 					return 0;
 				}
@@ -89,6 +261,7 @@ namespace sw
 			blocked++;
 			criticalSection.unlock();
 
+			TraceScope scope("Resource::lock");
 			unblock.wait();
 
 			criticalSection.lock();
@@ -119,7 +292,7 @@ namespace sw
 			{
 				criticalSection.unlock();
 
-				delete this;
+				Timeline::orphan(this);
 
 				return;
 			}
@@ -146,7 +319,7 @@ namespace sw
 				{
 					criticalSection.unlock();
 
-					delete this;
+					Timeline::orphan(this);
 
 					return;
 				}
@@ -164,7 +337,7 @@ namespace sw
 		{
 			criticalSection.unlock();
 
-			delete this;
+			Timeline::orphan(this);
 
 			return;
 		}
@@ -174,6 +347,11 @@ namespace sw
 		criticalSection.unlock();
 	}
 
+	bool Resource::inUse() const
+	{
+		return !Timeline::retired(serial);
+	}
+
 	const void *Resource::data() const
 	{
 		return buffer;
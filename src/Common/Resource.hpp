@@ -16,6 +16,10 @@
 #define sw_Resource_hpp
 
 #include "MutexLock.hpp"
+#include "Thread.hpp"
+#include "Types.hpp"
+
+#include <condition_variable>
 
 namespace sw
 {
@@ -27,6 +31,38 @@ namespace sw
 		DESTRUCT
 	};
 
+	class Resource;
+
+	// Renderer work is stamped with increasing submission serials. Work can
+	// retire out of order, but a serial only counts as retired once all work
+	// submitted before it has retired too.
+	class Timeline
+	{
+	public:
+		static int64_t submit();
+		static void retire(int64_t serial);
+		static bool retired(int64_t serial);
+		static void wait(int64_t serial);
+		static bool wait(int64_t serial, uint64_t timeout);   // Nanoseconds, returns whether the serial retired
+
+	private:
+		friend class Resource;
+
+		static void orphan(Resource *resource);   // Deletes the resource once its last use retired
+
+		enum {WINDOW = 1024};   // Maximum number of serials in flight
+
+		static BackoffLock criticalSection;
+		static std::condition_variable_any unblock;   // Wakes all waiters, as each waits for its own serial
+		static volatile int blocked;
+
+		static int64_t submitted;
+		static volatile int64_t completed;
+		static bool finished[WINDOW];
+
+		static Resource *orphans;
+	};
+
 	class Resource
 	{
 	public:
@@ -39,10 +75,16 @@ namespace sw
 		void unlock();
 		void unlock(Accessor relinquisher);
 
+		void *use(int64_t serial);   // Renderer access, retired through the Timeline
+		bool inUse() const;          // Whether unretired renderer work uses the resource
+		int64_t lastUse() const;     // Serial of the last renderer work using the resource
+
 		const void *data() const;
 		const size_t size;
 
 	private:
+		friend class Timeline;
+
 		~Resource();   // Always call destruct() instead
 
 		BackoffLock criticalSection;
@@ -53,8 +95,23 @@ namespace sw
 		volatile int count;
 		bool orphaned;
 
+		volatile int64_t serial;   // Last submission using this resource
+		Resource *next;            // Orphan list link
+
 		void *buffer;
 	};
+
+	inline void *Resource::use(int64_t serial)
+	{
+		atomicMax(&this->serial, serial);   // Contexts sharing the resource may submit out of order
+
+		return buffer;
+	}
+
+	inline int64_t Resource::lastUse() const
+	{
+		return serial;
+	}
 }
 
 #endif   // sw_Resource_hpp
@@ -0,0 +1,113 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ResourceRing.hpp"
+
+#include "Resource.hpp"
+#include "Counters.hpp"
+#include "Trace.hpp"
+
+namespace sw
+{
+	ResourceRing::ResourceRing(size_t segmentSize) : segmentSize(segmentSize)
+	{
+		current = 0;
+		writePosition = 0;
+
+		segments.push_back(allocateSegment(segmentSize));
+	}
+
+	ResourceRing::~ResourceRing()
+	{
+		for(Resource *segment : segments)
+		{
+			Counters::add(COUNTER_STREAMING_RING_BYTES, -(int64_t)(segment->size - PADDING));
+
+			segment->destruct();
+		}
+	}
+
+	Resource *ResourceRing::allocateSegment(size_t bytes)
+	{
+		Counters::add(COUNTER_STREAMING_RING_BYTES, bytes);
+
+		return new Resource(bytes + PADDING);
+	}
+
+	void ResourceRing::reserve(size_t bytes)
+	{
+		if(writePosition + bytes <= segments[current]->size - PADDING)
+		{
+			return;
+		}
+
+		size_t next = (current + 1) % segments.size();
+		Resource *segment = segments[next];
+
+		if(next != current && !segment->inUse() && segment->size - PADDING >= bytes)
+		{
+			current = next;
+		}
+		else if(segments.size() < MAX_SEGMENTS)
+		{
+			// The renderer is behind, so grow the ring instead of waiting
+			current = current + 1;
+			segments.insert(segments.begin() + current, allocateSegment(bytes > segmentSize ? bytes : segmentSize));
+		}
+		else
+		{
+			if(segment->inUse())
+			{
+				Counters::increment(COUNTER_STREAMING_STALLS);
+
+				TraceScope scope("ResourceRing::reserve");
+				segment->lock(PUBLIC);   // Waits for the draws using it to retire
+				segment->unlock();
+			}
+
+			if(segment->size - PADDING < bytes)
+			{
+				Counters::add(COUNTER_STREAMING_RING_BYTES, -(int64_t)(segment->size - PADDING));
+
+				segment->destruct();
+				segments[next] = allocateSegment(bytes);
+			}
+
+			current = next;
+		}
+
+		writePosition = 0;
+	}
+
+	void *ResourceRing::map(size_t bytes, size_t *offset)
+	{
+		// The reserved range is not in use by the renderer, so a private lock doesn't need to wait
+		char *buffer = (char*)segments[current]->lock(PRIVATE);
+
+		*offset = writePosition;
+		writePosition += bytes;
+
+		return buffer + *offset;
+	}
+
+	void ResourceRing::unmap()
+	{
+		segments[current]->unlock();
+	}
+
+	Resource *ResourceRing::getResource() const
+	{
+		return segments[current];
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_ResourceRing_hpp
+#define sw_ResourceRing_hpp
+
+#include <stddef.h>
+#include <vector>
+
+namespace sw
+{
+	class Resource;
+
+	// Streams data for draw calls through a ring of resources. A segment is
+	// only reused once the Timeline has retired the draws which read it, so
+	// writes don't wait for the renderer unless the ring has reached its
+	// maximum number of segments.
+	class ResourceRing
+	{
+	public:
+		ResourceRing(size_t segmentSize);
+		~ResourceRing();
+
+		// Reserves contiguous space in a single segment, which map() then
+		// hands out. Everything written for a draw call must be reserved at
+		// once, since segments are considered idle until a draw uses them.
+		void reserve(size_t bytes);
+
+		void *map(size_t bytes, size_t *offset);
+		void unmap();
+
+		Resource *getResource() const;
+
+	private:
+		enum {MAX_SEGMENTS = 8};
+		enum {PADDING = 1024};   // For SIMD processing of vertices and indices
+
+		Resource *allocateSegment(size_t bytes);
+
+		size_t segmentSize;
+		std::vector<Resource*> segments;
+		size_t current;
+		size_t writePosition;
+	};
+}
+
+#endif   // sw_ResourceRing_hpp
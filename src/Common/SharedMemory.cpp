@@ -0,0 +1,122 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SharedMemory.hpp"
+
+#if defined(__linux__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace sw
+{
+	SharedMemory *SharedMemory::create(size_t bytes)
+	{
+		#if defined(__linux__)
+			int descriptor = -1;
+
+			#if defined(__NR_memfd_create)
+				descriptor = (int)syscall(__NR_memfd_create, "SwiftShader", 1 /* MFD_CLOEXEC */);
+			#endif
+
+			#if defined(O_TMPFILE)
+				if(descriptor < 0)   // Kernels before 3.17
+				{
+					descriptor = open("/dev/shm", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+				}
+			#endif
+
+			if(descriptor < 0)
+			{
+				return nullptr;
+			}
+
+			if(ftruncate(descriptor, bytes) != 0)
+			{
+				close(descriptor);
+				return nullptr;
+			}
+
+			void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+			if(memory == MAP_FAILED)
+			{
+				close(descriptor);
+				return nullptr;
+			}
+
+			return new SharedMemory(descriptor, memory, bytes, bytes);
+		#else
+			return nullptr;
+		#endif
+	}
+
+	SharedMemory *SharedMemory::import(int fd, size_t bytes, size_t padding)
+	{
+		#if defined(__linux__)
+			int descriptor = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+			if(descriptor < 0)
+			{
+				return nullptr;
+			}
+
+			// Accessing a mapping past the end of the file raises SIGBUS. dma-bufs report their size through lseek().
+			off_t size = lseek(descriptor, 0, SEEK_END);
+
+			if(size < 0 || (size_t)size < bytes)
+			{
+				close(descriptor);
+				return nullptr;
+			}
+
+			// Private zero pages follow the file's pages, so that accesses to the padding stay in this process
+			size_t pageSize = sysconf(_SC_PAGESIZE);
+			size_t mapped = (bytes + padding + pageSize - 1) & ~(pageSize - 1);
+
+			void *memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+			if(memory == MAP_FAILED)
+			{
+				close(descriptor);
+				return nullptr;
+			}
+
+			if(mmap(memory, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, descriptor, 0) == MAP_FAILED)
+			{
+				munmap(memory, mapped);
+				close(descriptor);
+				return nullptr;
+			}
+
+			return new SharedMemory(descriptor, memory, bytes, mapped);
+		#else
+			return nullptr;
+		#endif
+	}
+
+	SharedMemory::SharedMemory(int descriptor, void *memory, size_t bytes, size_t mapped) : descriptor(descriptor), memory(memory), bytes(bytes), mapped(mapped)
+	{
+	}
+
+	SharedMemory::~SharedMemory()
+	{
+		#if defined(__linux__)
+			munmap(memory, mapped);
+			close(descriptor);
+		#endif
+	}
+}
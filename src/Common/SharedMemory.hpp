@@ -0,0 +1,45 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_SharedMemory_hpp
+#define sw_SharedMemory_hpp
+
+#include <stddef.h>
+
+namespace sw
+{
+	// Memory backed by an anonymous file, which other processes can map through its descriptor
+	class SharedMemory
+	{
+	public:
+		static SharedMemory *create(size_t bytes);   // Returns null if unsupported or out of memory
+		static SharedMemory *import(int fd, size_t bytes, size_t padding);   // Maps another process's memfd or dma-buf, followed by zeros. The descriptor is duplicated.
+
+		~SharedMemory();
+
+		void *data() const { return memory; }
+		int fd() const { return descriptor; }   // Owned by this object
+		size_t size() const { return bytes; }
+
+	private:
+		SharedMemory(int descriptor, void *memory, size_t bytes, size_t mapped);
+
+		const int descriptor;
+		void *const memory;
+		const size_t bytes;
+		const size_t mapped;   // Including the padding of imported memory
+	};
+}
+
+#endif   // sw_SharedMemory_hpp
@@ -25,9 +25,13 @@
 	#include <pthread.h>
 	#include <sched.h>
 	#include <unistd.h>
+	#include <errno.h>
+	#include <time.h>
 	#define TLS_OUT_OF_INDEXES (~0)
 #endif
 
+#include <stdint.h>
+
 namespace sw
 {
 	class Event;
@@ -46,11 +50,13 @@ namespace sw
 
 		#if defined(_WIN32)
 			typedef DWORD LocalStorageKey;
+			typedef PFLS_CALLBACK_FUNCTION LocalStorageDestructor;
 		#else
 			typedef pthread_key_t LocalStorageKey;
+			typedef void (*LocalStorageDestructor)(void *value);
 		#endif
 
-		static LocalStorageKey allocateLocalStorageKey();
+		static LocalStorageKey allocateLocalStorageKey(LocalStorageDestructor destructor = 0);   // Destructor is called with non-null values of exiting threads
 		static void freeLocalStorageKey(LocalStorageKey key);
 		static void setLocalStorage(LocalStorageKey key, void *value);
 		static void *getLocalStorage(LocalStorageKey key);
@@ -85,6 +91,7 @@ namespace sw
 
 		void signal();
 		void wait();
+		bool wait(int64_t nanoseconds);   // Returns false if it timed out
 
 	private:
 		#if defined(_WIN32)
@@ -104,6 +111,8 @@ namespace sw
 	int atomicIncrement(int volatile *value);
 	int atomicDecrement(int volatile *value);
 	int atomicAdd(int volatile *target, int value);
+	int64_t atomicAdd(int64_t volatile *target, int64_t value);
+	int64_t atomicMax(int64_t volatile *target, int64_t value);
 	void nop();
 }
 
@@ -129,13 +138,13 @@ namespace sw
 		#endif
 	}
 
-	inline Thread::LocalStorageKey Thread::allocateLocalStorageKey()
+	inline Thread::LocalStorageKey Thread::allocateLocalStorageKey(LocalStorageDestructor destructor)
 	{
 		#if defined(_WIN32)
-			return TlsAlloc();
+			return FlsAlloc(destructor);   // Fiber local storage acts as thread local storage, but supports destructors
 		#else
 			LocalStorageKey key;
-			pthread_key_create(&key, 0);
+			pthread_key_create(&key, destructor);
 			return key;
 		#endif
 	}
@@ -143,7 +152,7 @@ namespace sw
 	inline void Thread::freeLocalStorageKey(LocalStorageKey key)
 	{
 		#if defined(_WIN32)
-			TlsFree(key);
+			FlsFree(key);
 		#else
 			pthread_key_delete(key);
 		#endif
@@ -152,7 +161,7 @@ namespace sw
 	inline void Thread::setLocalStorage(LocalStorageKey key, void *value)
 	{
 		#if defined(_WIN32)
-			TlsSetValue(key, value);
+			FlsSetValue(key, value);
 		#else
 			pthread_setspecific(key, value);
 		#endif
@@ -161,7 +170,7 @@ namespace sw
 	inline void *Thread::getLocalStorage(LocalStorageKey key)
 	{
 		#if defined(_WIN32)
-			return TlsGetValue(key);
+			return FlsGetValue(key);
 		#else
 			return pthread_getspecific(key);
 		#endif
@@ -191,6 +200,28 @@ namespace sw
 		#endif
 	}
 
+	inline bool Event::wait(int64_t nanoseconds)
+	{
+		#if defined(_WIN32)
+			return WaitForSingleObject(handle, (DWORD)((nanoseconds + 999999) / 1000000)) == WAIT_OBJECT_0;
+		#else
+			timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			nanoseconds += deadline.tv_nsec;
+			deadline.tv_sec += (time_t)(nanoseconds / 1000000000);
+			deadline.tv_nsec = (long)(nanoseconds % 1000000000);
+
+			pthread_mutex_lock(&mutex);
+			int result = 0;
+			while(!signaled && result != ETIMEDOUT) result = pthread_cond_timedwait(&handle, &mutex, &deadline);
+			bool wasSignaled = signaled;
+			signaled = false;
+			pthread_mutex_unlock(&mutex);
+
+			return wasSignaled;
+		#endif
+	}
+
 	#if PERF_PROFILE
 	inline int64_t atomicExchange(volatile int64_t *target, int64_t value)
 	{
@@ -242,6 +273,38 @@ namespace sw
 		#endif
 	}
 
+	inline int64_t atomicAdd(volatile int64_t *target, int64_t value)
+	{
+		#if defined(_MSC_VER)
+			return InterlockedExchangeAdd64(target, value) + value;
+		#else
+			return __sync_add_and_fetch(target, value);
+		#endif
+	}
+
+	inline int64_t atomicMax(volatile int64_t *target, int64_t value)
+	{
+		int64_t current = *target;
+
+		while(current < value)
+		{
+			#if defined(_WIN32)
+				int64_t previous = InterlockedCompareExchange64(target, value, current);
+			#else
+				int64_t previous = __sync_val_compare_and_swap(target, current, value);
+			#endif
+
+			if(previous == current)
+			{
+				return value;
+			}
+
+			current = previous;
+		}
+
+		return current;
+	}
+
 	inline void nop()
 	{
 		#if defined(_WIN32)
@@ -0,0 +1,159 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Trace.hpp"
+
+#include "Thread.hpp"
+#include "MutexLock.hpp"
+#include "Timer.hpp"
+
+#include <stdio.h>
+
+namespace sw
+{
+	volatile bool Trace::active = false;
+
+	namespace
+	{
+		struct TraceEvent
+		{
+			const char *name;
+			int64_t start;
+			int64_t end;
+		};
+
+		struct Buffer
+		{
+			int thread;
+			volatile unsigned int head;   // Total number of events recorded
+			TraceEvent event[Trace::EVENTS];
+			bool exited;   // Kept for snapshots until a new thread reuses it
+			Buffer *next;
+		};
+
+		#if defined(_WIN32)
+			void NTAPI releaseBuffer(void *value);
+		#else
+			void releaseBuffer(void *value);
+		#endif
+
+		Thread::LocalStorageKey bufferKey = Thread::allocateLocalStorageKey(releaseBuffer);
+		BackoffLock bufferMutex;   // Protects the list of buffers, not their contents
+		Buffer *bufferList = 0;
+		int threadCount = 0;
+
+		const double microseconds = 1000000.0 / Timer::frequency();
+
+		#if defined(_WIN32)
+			void NTAPI releaseBuffer(void *value)
+		#else
+			void releaseBuffer(void *value)
+		#endif
+		{
+			bufferMutex.lock();
+			((Buffer*)value)->exited = true;
+			bufferMutex.unlock();
+		}
+
+		Buffer *threadBuffer()
+		{
+			Buffer *buffer = (Buffer*)Thread::getLocalStorage(bufferKey);
+
+			if(!buffer)
+			{
+				bufferMutex.lock();
+
+				for(buffer = bufferList; buffer; buffer = buffer->next)
+				{
+					if(buffer->exited)   // Reuse, so there are only as many buffers as live threads
+					{
+						break;
+					}
+				}
+
+				if(!buffer)
+				{
+					buffer = new Buffer;
+					buffer->next = bufferList;
+					bufferList = buffer;
+				}
+
+				buffer->thread = ++threadCount;
+				buffer->head = 0;
+				buffer->exited = false;
+
+				bufferMutex.unlock();
+
+				Thread::setLocalStorage(bufferKey, buffer);
+			}
+
+			return buffer;
+		}
+	}
+
+	void Trace::enable(bool enable)
+	{
+		active = enable;
+	}
+
+	int64_t Trace::timestamp()
+	{
+		return (int64_t)(Timer::counter() * microseconds);
+	}
+
+	void Trace::record(const char *name, int64_t start, int64_t end)
+	{
+		Buffer *buffer = threadBuffer();
+		TraceEvent &event = buffer->event[buffer->head % EVENTS];
+
+		event.name = name;
+		event.start = start;
+		event.end = end;
+
+		buffer->head = buffer->head + 1;   // Publish after the event is complete
+	}
+
+	std::string Trace::json()
+	{
+		std::string json = "{\"traceEvents\": [\n";
+		bool first = true;
+
+		bufferMutex.lock();
+
+		for(Buffer *buffer = bufferList; buffer; buffer = buffer->next)
+		{
+			unsigned int head = buffer->head;
+			unsigned int tail = head > EVENTS ? head - EVENTS : 0;
+
+			for(unsigned int i = tail; i < head; i++)
+			{
+				const TraceEvent &event = buffer->event[i % EVENTS];
+				char line[256];
+
+				// Events may be overwritten while we read, which at worst produces a bogus entry
+				sprintf(line, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %lld, \"dur\": %lld}",
+				        first ? "" : ",\n", event.name, buffer->thread, (long long)event.start, (long long)(event.end - event.start));
+
+				json += line;
+				first = false;
+			}
+		}
+
+		bufferMutex.unlock();
+
+		json += "\n]}\n";
+
+		return json;
+	}
+}
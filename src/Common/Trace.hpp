@@ -0,0 +1,75 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Trace_hpp
+#define sw_Trace_hpp
+
+#include "Types.hpp"
+
+#include <string>
+
+namespace sw
+{
+	// Timeline capture in the Chrome trace event format (chrome://tracing, Perfetto).
+	// Each thread records into its own ring buffer, so only the oldest events are lost.
+	// Buffers of exited threads are kept for snapshots until a new thread reuses them.
+	class Trace
+	{
+	public:
+		enum {EVENTS = 4096};   // Per thread
+
+		static bool enabled();
+		static void enable(bool enable);
+
+		static int64_t timestamp();   // Microseconds
+		static void record(const char *name, int64_t start, int64_t end);
+
+		static std::string json();   // Snapshot of all ring buffers
+
+	private:
+		static volatile bool active;
+	};
+
+	// Records the lifetime of the enclosing scope as a complete event
+	class TraceScope
+	{
+	public:
+		TraceScope(const char *name) : name(Trace::enabled() ? name : 0)
+		{
+			if(this->name)
+			{
+				start = Trace::timestamp();
+			}
+		}
+
+		~TraceScope()
+		{
+			if(name)
+			{
+				Trace::record(name, start, Trace::timestamp());
+			}
+		}
+
+	private:
+		const char *const name;
+		int64_t start;
+	};
+
+	inline bool Trace::enabled()
+	{
+		return active;
+	}
+}
+
+#endif   // sw_Trace_hpp
@@ -6196,9 +6196,9 @@ namespace D3D9
 		renderer->removeQuery(query);
 	}
 
-	void Direct3DDevice9::addQuery(sw::Query *query)
+	bool Direct3DDevice9::addQuery(sw::Query *query)
 	{
-		renderer->addQuery(query);
+		return renderer->addQuery(query);
 	}
 
 	void Direct3DDevice9::stretchRect(Direct3DSurface9 *source, const RECT *sourceRect, Direct3DSurface9 *dest, const RECT *destRect, D3DTEXTUREFILTERTYPE filter)
@@ -184,7 +184,7 @@ namespace D3D9
 		bool isRecording() const;   // In a state recording mode
 		void setOcclusionEnabled(bool enable);
 		void removeQuery(sw::Query *query);
-		void addQuery(sw::Query *query);
+		bool addQuery(sw::Query *query);
 		void stretchRect(Direct3DSurface9 *sourceSurface, const RECT *sourceRect, Direct3DSurface9 *destSurface, const RECT *destRect, D3DTEXTUREFILTERTYPE filter);
 
 	private:
@@ -159,7 +159,12 @@ namespace D3D9
 			if(flags == D3DISSUE_BEGIN)
 			{
 				query->begin();
-				device->addQuery(query);
+
+				if(!device->addQuery(query))
+				{
+					return INVALIDCALL();   // Too many occlusion queries active
+				}
+
 				device->setOcclusionEnabled(true);
 			}
 			else   // flags == D3DISSUE_END
@@ -196,7 +201,7 @@ namespace D3D9
 			return INVALIDCALL();
 		}
 
-		bool signaled = !query || query->reference == 0;
+		bool signaled = !query || query->available();
 
 		if(size && signaled)
 		{
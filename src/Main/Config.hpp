@@ -80,6 +80,7 @@ namespace sw
 	enum
 	{
 		OUTLINE_RESOLUTION = 4096,   // Maximum vertical resolution of the render target
+		GUARD_BAND = 4096,           // Maximum distance in pixels from the origin that is rasterized without clipping
 		MIPMAP_LEVELS = 14,
 		TEXTURE_IMAGE_UNITS = 16,
 		VERTEX_TEXTURE_IMAGE_UNITS = 16,
@@ -96,6 +97,7 @@ namespace sw
 		MAX_CLIP_PLANES = 6,
 		MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS = 64,
 		MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS = 64,
+		MAX_ACTIVE_QUERIES = 16,   // Queries accumulating results at the same time. GL allows one per target, D3D9 fails beginning more.
 		RENDERTARGETS = 8,
 	};
 }
@@ -19,6 +19,8 @@
 #include "Renderer/Surface.hpp"
 #include "Reactor/Reactor.hpp"
 #include "Common/Debug.hpp"
+#include "Common/Counters.hpp"
+#include "Common/Trace.hpp"
 
 #include <stdio.h>
 #include <string.h>
@@ -141,6 +143,8 @@ namespace sw
 
 	void FrameBuffer::copy(void *source, Format format, size_t stride)
 	{
+		TraceScope scope("FrameBuffer::copy");
+
 		if(!source)
 		{
 			return;
@@ -178,6 +182,7 @@ namespace sw
 		unlock();
 
 		profiler.nextFrame();   // Assumes every copy() is a full frame
+		Counters::increment(COUNTER_FRAMES);
 	}
 
 	void FrameBuffer::copyLocked()
@@ -569,7 +574,7 @@ namespace sw
 			}
 		}
 
-		return function(L"FrameBuffer");
+		return function(L"FrameBuffer<%d->%d>", state.sourceFormat, state.destFormat);
 	}
 
 	void FrameBuffer::blend(const BlitState &state, const Pointer<Byte> &d, const Pointer<Byte> &s, const Pointer<Byte> &c)
@@ -15,6 +15,8 @@
 #include "SwiftConfig.hpp"
 
 #include "Configurator.hpp"
+#include "Counters.hpp"
+#include "Trace.hpp"
 #include "Debug.hpp"
 #include "Config.hpp"
 #include "Version.h"
@@ -43,11 +45,11 @@ namespace sw
 		return ss.str();
 	}
 
-	SwiftConfig::SwiftConfig(bool disableServerOverride) : listenSocket(0)
+	SwiftConfig::SwiftConfig(bool disableServerDefault) : listenSocket(0)
 	{
-		readConfiguration(disableServerOverride);
+		readConfiguration(disableServerDefault);
 
-		if(!disableServerOverride)
+		if(!disableServerDefault)
 		{
 			writeConfiguration();
 		}
@@ -71,7 +73,7 @@ namespace sw
 		receiveBuffer = new char[bufferLength];
 
 		Socket::startup();
-		listenSocket = new Socket("localhost", "8080");
+		listenSocket = new Socket("localhost", itoa(config.serverPort).c_str());
 		listenSocket->listen();
 
 		terminate = false;
@@ -177,6 +179,18 @@ namespace sw
 				{
 					return send(clientSocket, OK, page());
 				}
+				else if(match(&request, "/metrics "))
+				{
+					return send(clientSocket, OK, Counters::text(), "text/plain");
+				}
+				else if(match(&request, "/metrics.json "))
+				{
+					return send(clientSocket, OK, Counters::json(), "application/json");
+				}
+				else if(match(&request, "/trace.json "))
+				{
+					return send(clientSocket, OK, Trace::json(), "application/json");
+				}
 			}
 		}
 		else if(match(&request, "POST /"))
@@ -221,6 +235,16 @@ namespace sw
 				{
 					return send(clientSocket, OK, profile());
 				}
+				else if(match(&request, "/trace/start "))
+				{
+					Trace::enable(true);
+					return send(clientSocket, OK);
+				}
+				else if(match(&request, "/trace/stop "))
+				{
+					Trace::enable(false);
+					return send(clientSocket, OK);
+				}
 			}
 		}
 
@@ -438,6 +462,19 @@ namespace sw
 		html += "<option value='3'" + (config.shadowMapping == 3 ? selected : empty) + ">Fetch4 & DST (default)</option>\n";
 		html += "</select></td>\n";
 		html += "<tr><td>Force clearing registers that have no default value:</td><td><input name = 'forceClearRegisters' type='checkbox'" + (config.forceClearRegisters == true ? checked : empty) + " title='Initializes shader register values to 0 even if they have no default.'></td></tr>";
+		html += "<tr><td>Sample compressed textures without decompressing them:</td><td><input name = 'compressedTextureSampling' type='checkbox'" + (config.compressedTextureSampling == true ? checked : empty) + " title='Decodes DXT and ETC1 blocks in the sampler instead of storing textures as RGBA. Applies to textures created afterwards.'></td></tr>";
+		html += "<tr><td>JIT profiling output:</td><td><select name='jitProfiling' title='Names generated routines for Linux profilers, in /tmp/perf-PID.map and/or the jitdump format used by perf inject --jit. Applies to routines generated afterwards.'>\n";
+		html += "<option value='0'" + (config.jitProfiling == 0 ? selected : empty) + ">None (default)</option>\n";
+		html += "<option value='1'" + (config.jitProfiling == 1 ? selected : empty) + ">perf map</option>\n";
+		html += "<option value='2'" + (config.jitProfiling == 2 ? selected : empty) + ">jitdump</option>\n";
+		html += "<option value='3'" + (config.jitProfiling == 3 ? selected : empty) + ">perf map & jitdump</option>\n";
+		html += "</select></td>\n";
+		html += "<tr><td>Tiered routine compilation:</td><td><select name='tierUpThreshold' title='Generates new routines with fast code generation, and regenerates them with full optimization once they have been used for this many draws.'>\n";
+		html += "<option value='0'" + (config.tierUpThreshold == 0 ? selected : empty) + ">Disabled (default)</option>\n";
+		html += "<option value='16'" + (config.tierUpThreshold == 16 ? selected : empty) + ">After 16 draws</option>\n";
+		html += "<option value='64'" + (config.tierUpThreshold == 64 ? selected : empty) + ">After 64 draws</option>\n";
+		html += "<option value='256'" + (config.tierUpThreshold == 256 ? selected : empty) + ">After 256 draws</option>\n";
+		html += "</select></td>\n";
 		html += "</table>\n";
 	#ifndef NDEBUG
 		html += "<h2><em>Debugging</em></h2>\n";
@@ -510,7 +547,7 @@ namespace sw
 		return html;
 	}
 
-	void SwiftConfig::send(Socket *clientSocket, Status code, std::string body)
+	void SwiftConfig::send(Socket *clientSocket, Status code, std::string body, const char *contentType)
 	{
 		std::string status;
 		char header[1024];
@@ -521,10 +558,10 @@ namespace sw
 		case NotFound: status += "HTTP/1.1 404 Not Found\r\n"; break;
 		}
 
-		sprintf(header, "Content-Type: text/html; charset=UTF-8\r\n"
+		sprintf(header, "Content-Type: %s; charset=UTF-8\r\n"
 						"Content-Length: %d\r\n"
 						"Host: localhost\r\n"
-						"\r\n", body.size());
+						"\r\n", contentType, body.size());
 
 		std::string message = status + header + body;
 		clientSocket->send(message.c_str(), (int)message.length());
@@ -547,6 +584,7 @@ namespace sw
 		config.disable10BitMode = false;
 		config.precache = false;
 		config.forceClearRegisters = false;
+		config.compressedTextureSampling = false;
 
 		while(*post != 0)
 		{
@@ -617,6 +655,14 @@ namespace sw
 			{
 				config.shadowMapping = integer;
 			}
+			else if(sscanf(post, "jitProfiling=%d", &integer))
+			{
+				config.jitProfiling = integer;
+			}
+			else if(sscanf(post, "tierUpThreshold=%d", &integer))
+			{
+				config.tierUpThreshold = integer;
+			}
 			else if(strstr(post, "enableSSE=on"))
 			{
 				config.enableSSE = true;
@@ -689,6 +735,10 @@ namespace sw
 			{
 				config.forceClearRegisters = true;
 			}
+			else if(strstr(post, "compressedTextureSampling=on"))
+			{
+				config.compressedTextureSampling = true;
+			}
 		#ifndef NDEBUG
 			else if(sscanf(post, "minPrimitives=%d", &integer))
 			{
@@ -712,7 +762,7 @@ namespace sw
 		}
 	}
 
-	void SwiftConfig::readConfiguration(bool disableServerOverride)
+	void SwiftConfig::readConfiguration(bool disableServerDefault)
 	{
 		Configurator ini("SwiftShader.ini");
 
@@ -741,7 +791,8 @@ namespace sw
 			config.optimization[pass] = (Optimization)ini.getInteger("Optimization", "OptimizationPass" + itoa(pass + 1), pass == 0 ? InstructionCombining : Disabled);
 		}
 
-		config.disableServer = ini.getBoolean("Testing", "DisableServer", false);
+		config.disableServer = ini.getBoolean("Testing", "DisableServer", disableServerDefault);
+		config.serverPort = ini.getInteger("Testing", "ServerPort", 8080);
 		config.forceWindowed = ini.getBoolean("Testing", "ForceWindowed", false);
 		config.complementaryDepthBuffer = ini.getBoolean("Testing", "ComplementaryDepthBuffer", false);
 		config.postBlendSRGB = ini.getBoolean("Testing", "PostBlendSRGB", false);
@@ -752,6 +803,9 @@ namespace sw
 		config.precache = ini.getBoolean("Testing", "Precache", false);
 		config.shadowMapping = ini.getInteger("Testing", "ShadowMapping", 3);
 		config.forceClearRegisters = ini.getBoolean("Testing", "ForceClearRegisters", false);
+		config.compressedTextureSampling = ini.getBoolean("Testing", "CompressedTextureSampling", false);
+		config.jitProfiling = ini.getInteger("Testing", "JITProfiling", 0);
+		config.tierUpThreshold = ini.getInteger("Testing", "TierUpThreshold", 0);
 
 	#ifndef NDEBUG
 		config.minPrimitives = 1;
@@ -763,11 +817,6 @@ namespace sw
 
 		bool noConfig = stat("SwiftShader.ini", &status) != 0;
 		newConfig = !noConfig && abs((int)status.st_mtime - lastModified) > 1;
-
-		if(disableServerOverride)
-		{
-			config.disableServer = true;
-		}
 	}
 
 	void SwiftConfig::writeConfiguration()
@@ -800,6 +849,7 @@ namespace sw
 		}
 
 		ini.addValue("Testing", "DisableServer", itoa(config.disableServer));
+		ini.addValue("Testing", "ServerPort", itoa(config.serverPort));
 		ini.addValue("Testing", "ForceWindowed", itoa(config.forceWindowed));
 		ini.addValue("Testing", "ComplementaryDepthBuffer", itoa(config.complementaryDepthBuffer));
 		ini.addValue("Testing", "PostBlendSRGB", itoa(config.postBlendSRGB));
@@ -810,6 +860,9 @@ namespace sw
 		ini.addValue("Testing", "Precache", itoa(config.precache));
 		ini.addValue("Testing", "ShadowMapping", itoa(config.shadowMapping));
 		ini.addValue("Testing", "ForceClearRegisters", itoa(config.forceClearRegisters));
+		ini.addValue("Testing", "CompressedTextureSampling", itoa(config.compressedTextureSampling));
+		ini.addValue("Testing", "JITProfiling", itoa(config.jitProfiling));
+		ini.addValue("Testing", "TierUpThreshold", itoa(config.tierUpThreshold));
 		ini.addValue("LastModified", "Time", itoa((int)time(0)));
 
 		ini.writeFile("SwiftShader Configuration File\n"
@@ -50,6 +50,7 @@ namespace sw
 			bool enableSSE4_1;
 			Optimization optimization[10];
 			bool disableServer;
+			int serverPort;
 			bool keepSystemCursor;
 			bool forceWindowed;
 			bool complementaryDepthBuffer;
@@ -62,13 +63,16 @@ namespace sw
 			bool precache;
 			int shadowMapping;
 			bool forceClearRegisters;
+			bool compressedTextureSampling;
+			int jitProfiling;
+			int tierUpThreshold;
 		#ifndef NDEBUG
 			unsigned int minPrimitives;
 			unsigned int maxPrimitives;
 		#endif
 		};
 
-		SwiftConfig(bool disableServerOverride);
+		SwiftConfig(bool disableServerDefault);   // Unless the configuration file enables or disables the server
 
 		~SwiftConfig();
 
@@ -91,10 +95,10 @@ namespace sw
 		void respond(Socket *clientSocket, const char *request);
 		std::string page();
 		std::string profile();
-		void send(Socket *clientSocket, Status code, std::string body = "");
+		void send(Socket *clientSocket, Status code, std::string body = "", const char *contentType = "text/html");
 		void parsePost(const char *post);
 
-		void readConfiguration(bool disableServerOverride = false);
+		void readConfiguration(bool disableServerDefault = false);
 		void writeConfiguration();
 
 		Configuration config;
@@ -15,9 +15,11 @@
 #include "Image.hpp"
 
 #include "Renderer/Blitter.hpp"
+#include "Renderer/Renderer.hpp"
 #include "../libEGL/Texture.hpp"
 #include "../common/debug.h"
 #include "Common/Math.hpp"
+#include "Common/SharedMemory.hpp"
 #include "Common/Thread.hpp"
 
 #include <GLES3/gl3.h>
@@ -416,6 +418,411 @@ namespace
 			}
 		}
 	}
+
+	// Converts client data of any format which loads without the blitter, except packed depth and stencil
+	void LoadImage(GLenum format, GLenum type, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, int destPitch, GLsizei destHeight, const void *input, void *buffer)
+	{
+		switch(type)
+		{
+		case GL_BYTE:
+			switch(format)
+			{
+			case GL_R8:
+			case GL_R8I:
+			case GL_R8_SNORM:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_ALPHA8_EXT:
+			case GL_LUMINANCE:
+			case GL_LUMINANCE8_EXT:
+				LoadImageData<Bytes_1>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG8:
+			case GL_RG8I:
+			case GL_RG8_SNORM:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+			case GL_LUMINANCE8_ALPHA8_EXT:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB8:
+			case GL_RGB8I:
+			case GL_RGB8_SNORM:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<ByteRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA8:
+			case GL_RGBA8I:
+			case GL_RGBA8_SNORM:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_BYTE:
+			switch(format)
+			{
+			case GL_R8:
+			case GL_R8UI:
+			case GL_R8_SNORM:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_ALPHA8_EXT:
+			case GL_LUMINANCE:
+			case GL_LUMINANCE8_EXT:
+				LoadImageData<Bytes_1>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG8:
+			case GL_RG8UI:
+			case GL_RG8_SNORM:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+			case GL_LUMINANCE8_ALPHA8_EXT:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB8:
+			case GL_RGB8UI:
+			case GL_RGB8_SNORM:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<UByteRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA8:
+			case GL_RGBA8UI:
+			case GL_RGBA8_SNORM:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_SRGB8:
+				LoadImageData<SRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_SRGB8_ALPHA8:
+				LoadImageData<SRGBA>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_SHORT_5_6_5:
+			switch(format)
+			{
+			case GL_RGB565:
+			case GL_RGB:
+				LoadImageData<RGB565>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+			switch(format)
+			{
+			case GL_RGBA4:
+			case GL_RGBA:
+				LoadImageData<RGBA4444>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+			switch(format)
+			{
+			case GL_RGB5_A1:
+			case GL_RGBA:
+				LoadImageData<RGBA5551>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			switch(format)
+			{
+			case GL_R11F_G11F_B10F:
+			case GL_RGB:
+				LoadImageData<R11G11B10F>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			switch(format)
+			{
+			case GL_RGB9_E5:
+			case GL_RGB:
+				LoadImageData<RGB9E5>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			switch(format)
+			{
+			case GL_RGB10_A2UI:
+				LoadImageData<RGB10A2UI>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB10_A2:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_FLOAT:
+			switch(format)
+			{
+			// float textures are converted to RGBA, not BGRA
+			case GL_ALPHA:
+			case GL_ALPHA32F_EXT:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_LUMINANCE:
+			case GL_LUMINANCE32F_EXT:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_LUMINANCE_ALPHA:
+			case GL_LUMINANCE_ALPHA32F_EXT:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RED:
+			case GL_R32F:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG:
+			case GL_RG32F:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB:
+			case GL_RGB32F:
+				LoadImageData<FloatRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA:
+			case GL_RGBA32F:
+				LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_DEPTH_COMPONENT:
+			case GL_DEPTH_COMPONENT32F:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_HALF_FLOAT:
+		case GL_HALF_FLOAT_OES:
+			switch(format)
+			{
+			case GL_ALPHA:
+			case GL_ALPHA16F_EXT:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_LUMINANCE:
+			case GL_LUMINANCE16F_EXT:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_LUMINANCE_ALPHA:
+			case GL_LUMINANCE_ALPHA16F_EXT:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RED:
+			case GL_R16F:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG:
+			case GL_RG16F:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB:
+			case GL_RGB16F:
+				LoadImageData<HalfFloatRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA:
+			case GL_RGBA16F:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_SHORT:
+			switch(format)
+			{
+			case GL_R16I:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_LUMINANCE:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG16I:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB16I:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<ShortRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA16I:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_SHORT:
+			switch(format)
+			{
+			case GL_R16UI:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_LUMINANCE:
+				LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG16UI:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB16UI:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<UShortRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA16UI:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_DEPTH_COMPONENT:
+			case GL_DEPTH_COMPONENT16:
+				LoadImageData<D16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_INT:
+			switch(format)
+			{
+			case GL_R32I:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_LUMINANCE:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG32I:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB32I:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<IntRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA32I:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		case GL_UNSIGNED_INT:
+			switch(format)
+			{
+			case GL_R32UI:
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_ALPHA:
+			case GL_LUMINANCE:
+				LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RG32UI:
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_LUMINANCE_ALPHA:
+				LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGB32UI:
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				LoadImageData<UIntRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_RGBA32UI:
+			case GL_RGBA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_EXT:
+			case GL_BGRA8_EXT:
+				LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			case GL_DEPTH_COMPONENT16:
+			case GL_DEPTH_COMPONENT24:
+			case GL_DEPTH_COMPONENT32_OES:
+			case GL_DEPTH_COMPONENT:
+				LoadImageData<D32>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, destPitch, destHeight, input, buffer);
+				break;
+			default: UNREACHABLE(format);
+			}
+			break;
+		default: UNREACHABLE(type);
+		}
+	}
+
+	// Executes LoadImage() in bands of rows. The source resource stays locked until the upload is deleted.
+	class ImageUpload : public sw::Upload
+	{
+	public:
+		ImageUpload(sw::Surface *dest, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, int inputPitch, int inputHeight, sw::Resource *source, const void *input)
+			: sw::Upload(dest, sw::Rect(xoffset, yoffset, xoffset + width, yoffset + height), zoffset, zoffset + depth),
+			  format(format), type(type), inputPitch(inputPitch), inputHeight(inputHeight), source(source), input(input)
+		{
+			source->lock(sw::PRIVATE);
+		}
+
+		~ImageUpload() override
+		{
+			source->unlock();
+		}
+
+		void execute(void *buffer, int y0, int y1) override
+		{
+			int destPitch = dest->getInternalPitchB();
+			int destHeight = dest->getInternalSliceB() / destPitch;
+			const unsigned char *band = static_cast<const unsigned char*>(input) + (y0 - rect.y0) * inputPitch;
+
+			LoadImage(format, type, rect.x0, y0, z0, rect.x1 - rect.x0, y1 - y0, z1 - z0, inputPitch, inputHeight, destPitch, destHeight, band, buffer);
+		}
+
+	private:
+		const GLenum format;
+		const GLenum type;
+		const int inputPitch;
+		const int inputHeight;
+		sw::Resource *const source;
+		const void *const input;
+	};
 }
 
 namespace egl
@@ -1185,9 +1592,72 @@ namespace egl
 			parentTexture->release();
 		}
 
+		if(sharedMemory)
+		{
+			// Wait for any draw calls that use the memory to finish
+			resource->lock(sw::DESTRUCT);
+			resource->unlock();
+
+			delete sharedMemory;
+		}
+
 		ASSERT(!shared);
 	}
 
+	int Image::exportSharedMemory()
+	{
+		if(!sharedMemory)
+		{
+			if(getDepth() > 1)   // Multisampled
+			{
+				return -1;
+			}
+
+			sharedMemory = sw::SharedMemory::create(getInternalSliceB() * sw::Surface::getDepth() + 4);   // See Surface::allocateBuffer()
+
+			if(!sharedMemory)
+			{
+				return -1;
+			}
+
+			setInternalBuffer(sharedMemory->data());
+		}
+
+		return sharedMemory->fd();
+	}
+
+	Image *Image::importSharedMemory(int fd, GLsizei width, GLsizei height, int fourcc, int offset, int pitch)
+	{
+		GLenum format = GLPixelFormatFromFourCC(fourcc);
+		GLenum type = GLPixelTypeFromFourCC(fourcc);
+
+		if(format == GL_NONE || width <= 0 || height <= 0 || offset < 0)
+		{
+			return nullptr;
+		}
+
+		int bytes = sw::Surface::bytes(SelectInternalFormat(format, type));
+
+		if(pitch < width * bytes || pitch % bytes != 0 || offset % bytes != 0)
+		{
+			return nullptr;
+		}
+
+		// Render targets are processed in 2x2 quads, so odd heights access one more row, and SIMD code reads a bit further
+		sw::SharedMemory *memory = sw::SharedMemory::import(fd, (size_t)offset + (size_t)pitch * height, pitch + 4);
+
+		if(!memory)
+		{
+			return nullptr;
+		}
+
+		Image *image = new Image(width, height, format, type, pitch / bytes);
+		image->sharedMemory = memory;
+		image->setInternalBuffer((unsigned char*)memory->data() + offset);
+
+		return image;
+	}
+
 	void Image::release()
 	{
 		int refs = dereference();
@@ -1234,381 +1704,21 @@ namespace egl
 
 		if(selectedInternalFormat == internalFormat)
 		{
-			void *buffer = lock(0, 0, sw::LOCK_WRITEONLY);
+			sw::Rect region(xoffset, yoffset, xoffset + width, yoffset + height);
+			void *buffer = lock(0, 0, sw::LOCK_WRITEONLY, &region);
 
 			if(buffer)
 			{
 				switch(type)
 				{
-				case GL_BYTE:
-					switch(format)
-					{
-					case GL_R8:
-					case GL_R8I:
-					case GL_R8_SNORM:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_ALPHA8_EXT:
-					case GL_LUMINANCE:
-					case GL_LUMINANCE8_EXT:
-						LoadImageData<Bytes_1>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG8:
-					case GL_RG8I:
-					case GL_RG8_SNORM:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-					case GL_LUMINANCE8_ALPHA8_EXT:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB8:
-					case GL_RGB8I:
-					case GL_RGB8_SNORM:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<ByteRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA8:
-					case GL_RGBA8I:
-					case GL_RGBA8_SNORM:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_BYTE:
-					switch(format)
-					{
-					case GL_R8:
-					case GL_R8UI:
-					case GL_R8_SNORM:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_ALPHA8_EXT:
-					case GL_LUMINANCE:
-					case GL_LUMINANCE8_EXT:
-						LoadImageData<Bytes_1>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG8:
-					case GL_RG8UI:
-					case GL_RG8_SNORM:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-					case GL_LUMINANCE8_ALPHA8_EXT:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB8:
-					case GL_RGB8UI:
-					case GL_RGB8_SNORM:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<UByteRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA8:
-					case GL_RGBA8UI:
-					case GL_RGBA8_SNORM:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_SRGB8:
-						LoadImageData<SRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_SRGB8_ALPHA8:
-						LoadImageData<SRGBA>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_SHORT_5_6_5:
-					switch(format)
-					{
-					case GL_RGB565:
-					case GL_RGB:
-						LoadImageData<RGB565>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_SHORT_4_4_4_4:
-					switch(format)
-					{
-					case GL_RGBA4:
-					case GL_RGBA:
-						LoadImageData<RGBA4444>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_SHORT_5_5_5_1:
-					switch(format)
-					{
-					case GL_RGB5_A1:
-					case GL_RGBA:
-						LoadImageData<RGBA5551>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_INT_10F_11F_11F_REV:
-					switch(format)
-					{
-					case GL_R11F_G11F_B10F:
-					case GL_RGB:
-						LoadImageData<R11G11B10F>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_INT_5_9_9_9_REV:
-					switch(format)
-					{
-					case GL_RGB9_E5:
-					case GL_RGB:
-						LoadImageData<RGB9E5>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_INT_2_10_10_10_REV:
-					switch(format)
-					{
-					case GL_RGB10_A2UI:
-						LoadImageData<RGB10A2UI>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB10_A2:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_FLOAT:
-					switch(format)
-					{
-					// float textures are converted to RGBA, not BGRA
-					case GL_ALPHA:
-					case GL_ALPHA32F_EXT:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_LUMINANCE:
-					case GL_LUMINANCE32F_EXT:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_LUMINANCE_ALPHA:
-					case GL_LUMINANCE_ALPHA32F_EXT:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RED:
-					case GL_R32F:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG:
-					case GL_RG32F:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB:
-					case GL_RGB32F:
-						LoadImageData<FloatRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA:
-					case GL_RGBA32F:
-						LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_DEPTH_COMPONENT:
-					case GL_DEPTH_COMPONENT32F:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_HALF_FLOAT:
-				case GL_HALF_FLOAT_OES:
-					switch(format)
-					{
-					case GL_ALPHA:
-					case GL_ALPHA16F_EXT:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_LUMINANCE:
-					case GL_LUMINANCE16F_EXT:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_LUMINANCE_ALPHA:
-					case GL_LUMINANCE_ALPHA16F_EXT:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RED:
-					case GL_R16F:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG:
-					case GL_RG16F:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB:
-					case GL_RGB16F:
-						LoadImageData<HalfFloatRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA:
-					case GL_RGBA16F:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_SHORT:
-					switch(format)
-					{
-					case GL_R16I:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_LUMINANCE:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG16I:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB16I:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<ShortRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA16I:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_SHORT:
-					switch(format)
-					{
-					case GL_R16UI:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_LUMINANCE:
-						LoadImageData<Bytes_2>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG16UI:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB16UI:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<UShortRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA16UI:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_DEPTH_COMPONENT:
-					case GL_DEPTH_COMPONENT16:
-						LoadImageData<D16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_INT:
-					switch(format)
-					{
-					case GL_R32I:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_LUMINANCE:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG32I:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB32I:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<IntRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA32I:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
-				case GL_UNSIGNED_INT:
-					switch(format)
-					{
-					case GL_R32UI:
-					case GL_RED:
-					case GL_RED_INTEGER:
-					case GL_ALPHA:
-					case GL_LUMINANCE:
-						LoadImageData<Bytes_4>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RG32UI:
-					case GL_RG:
-					case GL_RG_INTEGER:
-					case GL_LUMINANCE_ALPHA:
-						LoadImageData<Bytes_8>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGB32UI:
-					case GL_RGB:
-					case GL_RGB_INTEGER:
-						LoadImageData<UIntRGB>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_RGBA32UI:
-					case GL_RGBA:
-					case GL_RGBA_INTEGER:
-					case GL_BGRA_EXT:
-					case GL_BGRA8_EXT:
-						LoadImageData<Bytes_16>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					case GL_DEPTH_COMPONENT16:
-					case GL_DEPTH_COMPONENT24:
-					case GL_DEPTH_COMPONENT32_OES:
-					case GL_DEPTH_COMPONENT:
-						LoadImageData<D32>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
-						break;
-					default: UNREACHABLE(format);
-					}
-					break;
 				case GL_UNSIGNED_INT_24_8_OES:
 					loadD24S8ImageData(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, input, buffer);
 					break;
 				case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
 					loadD32FS8ImageData(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, input, buffer);
 					break;
-				default: UNREACHABLE(type);
+				default:
+					LoadImage(format, type, xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
 				}
 			}
 
@@ -1623,6 +1733,36 @@ namespace egl
 		}
 	}
 
+	bool Image::deferImageData(sw::Renderer *renderer, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const UnpackInfo& unpackInfo, sw::Resource *source, const void *input)
+	{
+		// The worker threads write the internal buffer directly, so it has to have the layout loadImageData() produces
+		sw::Format selectedInternalFormat = SelectInternalFormat(format, type);
+		if(selectedInternalFormat == sw::FORMAT_NULL || selectedInternalFormat != internalFormat || sw::Surface::getFormat(true) != internalFormat)
+		{
+			return false;
+		}
+
+		// Stencil is loaded separately
+		if(type == GL_UNSIGNED_INT_24_8_OES || type == GL_FLOAT_32_UNSIGNED_INT_24_8_REV)
+		{
+			return false;
+		}
+
+		if(getInternalSliceB() % getInternalPitchB() != 0)
+		{
+			return false;
+		}
+
+		GLsizei inputWidth = (unpackInfo.rowLength == 0) ? width : unpackInfo.rowLength;
+		GLsizei inputPitch = ComputePitch(inputWidth, format, type, unpackInfo.alignment);
+		GLsizei inputHeight = (unpackInfo.imageHeight == 0) ? height : unpackInfo.imageHeight;
+		input = ((char*)input) + ComputePackingOffset(format, type, inputWidth, inputHeight, unpackInfo.alignment, unpackInfo.skipImages, unpackInfo.skipRows, unpackInfo.skipPixels);
+
+		renderer->upload(new ImageUpload(this, xoffset, yoffset, zoffset, width, height, depth, format, type, inputPitch, inputHeight, source, input));
+
+		return true;
+	}
+
 	void Image::loadD24S8ImageData(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, const void *input, void *buffer)
 	{
 		LoadImageData<D24>(xoffset, yoffset, zoffset, width, height, depth, inputPitch, inputHeight, getPitch(), getHeight(), input, buffer);
@@ -1660,7 +1800,8 @@ namespace egl
 
 		int inputPitch = ComputeCompressedPitch(width, format);
 		int rows = imageSize / inputPitch;
-		void *buffer = lock(xoffset, yoffset, sw::LOCK_WRITEONLY);
+		sw::Rect region(xoffset, yoffset, xoffset + width, yoffset + height);
+		void *buffer = lock(xoffset, yoffset, sw::LOCK_WRITEONLY, &region);
 
 		if(buffer)
 		{
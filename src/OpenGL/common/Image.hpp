@@ -37,6 +37,12 @@
 #define SW_YV12_BT709 0x48315659   // YCrCb 4:2:0 Planar, 16-byte aligned, BT.709 color space, studio swing
 #define SW_YV12_JFIF  0x4A315659   // YCrCb 4:2:0 Planar, 16-byte aligned, BT.601 color space, full swing
 
+namespace sw
+{
+	class SharedMemory;
+	class Renderer;
+}
+
 namespace egl
 {
 
@@ -46,6 +52,46 @@ GLsizei ComputePitch(GLsizei width, GLenum format, GLenum type, GLint alignment)
 GLsizei ComputeCompressedSize(GLsizei width, GLsizei height, GLenum format);
 size_t ComputePackingOffset(GLenum format, GLenum type, GLsizei width, GLsizei height, GLint alignment, GLint skipImages, GLint skipRows, GLint skipPixels);
 
+// DRM fourcc codes of the formats which can be shared with other processes
+#define SW_FOURCC(a, b, c, d) ((int)(a) | ((int)(b) << 8) | ((int)(c) << 16) | ((int)(d) << 24))
+
+inline GLenum GLPixelFormatFromFourCC(int fourcc)
+{
+	switch(fourcc)
+	{
+	case SW_FOURCC('A', 'R', '2', '4'): return GL_BGRA8_EXT;
+	case SW_FOURCC('A', 'B', '2', '4'): return GL_RGBA8;
+	case SW_FOURCC('X', 'B', '2', '4'): return GL_RGB8;
+	case SW_FOURCC('R', 'G', '1', '6'): return GL_RGB565;
+	default:                            return GL_NONE;   // Unsupported, including XR24 which has no GL equivalent
+	}
+}
+
+inline GLenum GLPixelTypeFromFourCC(int fourcc)
+{
+	switch(fourcc)
+	{
+	case SW_FOURCC('A', 'R', '2', '4'): return GL_UNSIGNED_BYTE;
+	case SW_FOURCC('A', 'B', '2', '4'): return GL_UNSIGNED_BYTE;
+	case SW_FOURCC('X', 'B', '2', '4'): return GL_UNSIGNED_BYTE;
+	case SW_FOURCC('R', 'G', '1', '6'): return GL_UNSIGNED_SHORT_5_6_5;
+	default:                            return GL_NONE;
+	}
+}
+
+inline int FourCCFromInternalFormat(sw::Format format)
+{
+	switch(format)
+	{
+	case sw::FORMAT_A8R8G8B8: return SW_FOURCC('A', 'R', '2', '4');
+	case sw::FORMAT_A8B8G8R8: return SW_FOURCC('A', 'B', '2', '4');
+	case sw::FORMAT_X8R8G8B8: return SW_FOURCC('X', 'R', '2', '4');
+	case sw::FORMAT_X8B8G8R8: return SW_FOURCC('X', 'B', '2', '4');
+	case sw::FORMAT_R5G6B5:   return SW_FOURCC('R', 'G', '1', '6');
+	default:                  return 0;
+	}
+}
+
 class Image : public sw::Surface, public gl::Object
 {
 public:
@@ -56,6 +102,7 @@ public:
 		  parentTexture(parentTexture)
 	{
 		shared = false;
+		sharedMemory = nullptr;
 		Object::addRef();
 		parentTexture->addRef();
 	}
@@ -67,6 +114,7 @@ public:
 		  parentTexture(parentTexture)
 	{
 		shared = false;
+		sharedMemory = nullptr;
 		Object::addRef();
 		parentTexture->addRef();
 	}
@@ -78,6 +126,7 @@ public:
 		  parentTexture(nullptr)
 	{
 		shared = true;
+		sharedMemory = nullptr;
 		Object::addRef();
 	}
 
@@ -88,6 +137,7 @@ public:
 		  parentTexture(nullptr)
 	{
 		shared = false;
+		sharedMemory = nullptr;
 		Object::addRef();
 	}
 
@@ -133,9 +183,9 @@ public:
 		shared = true;
 	}
 
-	virtual void *lock(unsigned int left, unsigned int top, sw::Lock lock)
+	virtual void *lock(unsigned int left, unsigned int top, sw::Lock lock, const sw::Rect *region = nullptr)   // Writes stay within the region, if provided
 	{
-		return lockExternal(left, top, 0, lock, sw::PUBLIC);
+		return lockExternal(left, top, 0, lock, sw::PUBLIC, region);
 	}
 
 	unsigned int getPitch() const
@@ -161,6 +211,10 @@ public:
 	};
 
 	void loadImageData(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const UnpackInfo& unpackInfo, const void *input);
+
+	// Loads image data on the renderer's worker threads, from input within a resource which stays
+	// locked until the upload completes. Returns false if loadImageData() has to be used instead.
+	bool deferImageData(sw::Renderer *renderer, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const UnpackInfo& unpackInfo, sw::Resource *source, const void *input);
 	void loadCompressedData(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLsizei imageSize, const void *pixels);
 
 	void release() override;
@@ -174,6 +228,13 @@ public:
 		release();
 	}
 
+	// Moves the pixels into memory other processes can map. Returns the file
+	// descriptor, which is owned by the image, or -1 if shared memory is unavailable.
+	virtual int exportSharedMemory();
+
+	// Wraps another process's memfd or dma-buf as a native EGL image, without copying
+	static Image *importSharedMemory(int fd, GLsizei width, GLsizei height, int fourcc, int offset, int pitch);
+
 protected:
 	const GLsizei width;
 	const GLsizei height;
@@ -183,6 +244,7 @@ protected:
 	const int depth;
 
 	bool shared;   // Used as an EGLImage
+	sw::SharedMemory *sharedMemory;
 
 	egl::Texture *parentTexture;
 
@@ -259,12 +321,12 @@ private:
 		nativeBuffer->common.decRef(&nativeBuffer->common);
 	}
 
-	virtual void *lockInternal(int x, int y, int z, sw::Lock lock, sw::Accessor client)
+	virtual void *lockInternal(int x, int y, int z, sw::Lock lock, sw::Accessor client, const sw::Rect *region = nullptr)
 	{
 		LOGLOCK("image=%p op=%s.swsurface lock=%d", this, __FUNCTION__, lock);
 
 		// Always do this for reference counting.
-		void *data = sw::Surface::lockInternal(x, y, z, lock, client);
+		void *data = sw::Surface::lockInternal(x, y, z, lock, client, region);
 
 		if(nativeBuffer)
 		{
@@ -301,10 +363,10 @@ private:
 		sw::Surface::unlockInternal();
 	}
 
-	virtual void *lock(unsigned int left, unsigned int top, sw::Lock lock)
+	virtual void *lock(unsigned int left, unsigned int top, sw::Lock lock, const sw::Rect *region = nullptr)
 	{
 		LOGLOCK("image=%p op=%s lock=%d", this, __FUNCTION__, lock);
-		(void)sw::Surface::lockExternal(left, top, 0, lock, sw::PUBLIC);
+		(void)sw::Surface::lockExternal(left, top, 0, lock, sw::PUBLIC, region);
 
 		return lockNativeBuffer(GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
 	}
@@ -21,6 +21,9 @@
 #include "ParseHelper.h"
 #include "ValidateLimitations.h"
 
+#include <mutex>
+#include <string.h>
+
 namespace
 {
 class TScopedPoolAllocator {
@@ -41,6 +44,56 @@ private:
 	TPoolAllocator* mAllocator;
 	bool mPushPopAllocator;
 };
+
+// Built-in symbols only depend on the shader type and the resources, so each
+// combination is generated once and then shared read-only by all compilers.
+struct TBuiltInSymbols
+{
+	GLenum shaderType;
+	ShBuiltInResources resources;
+	TPoolAllocator allocator;   // Holds the symbols until FreeCompilerGlobals()
+	TSymbolTable symbolTable;
+};
+
+std::mutex builtInMutex;
+std::vector<TBuiltInSymbols*> builtInSymbols;
+
+void GenerateBuiltInSymbolTable(GLenum shaderType, const ShBuiltInResources &resources, TSymbolTable &symbolTable)
+{
+	symbolTable.push();   // COMMON_BUILTINS
+	symbolTable.push();   // ESSL1_BUILTINS
+	symbolTable.push();   // ESSL3_BUILTINS
+
+	TPublicType integer;
+	integer.type = EbtInt;
+	integer.primarySize = 1;
+	integer.secondarySize = 1;
+	integer.array = false;
+
+	TPublicType floatingPoint;
+	floatingPoint.type = EbtFloat;
+	floatingPoint.primarySize = 1;
+	floatingPoint.secondarySize = 1;
+	floatingPoint.array = false;
+
+	switch(shaderType)
+	{
+	case GL_FRAGMENT_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpMedium);
+		break;
+	case GL_VERTEX_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpHigh);
+		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
+		break;
+	default: assert(false && "Language not supported");
+	}
+
+	InsertBuiltInFunctions(shaderType, resources, symbolTable);
+
+	IdentifyBuiltIns(shaderType, resources, symbolTable);
+
+	symbolTable.finalize();
+}
 }  // namespace
 
 //
@@ -164,37 +217,31 @@ bool TCompiler::compile(const char* const shaderStrings[],
 bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
 	assert(symbolTable.isEmpty());
-	symbolTable.push();   // COMMON_BUILTINS
-	symbolTable.push();   // ESSL1_BUILTINS
-	symbolTable.push();   // ESSL3_BUILTINS
 
-	TPublicType integer;
-	integer.type = EbtInt;
-	integer.primarySize = 1;
-	integer.secondarySize = 1;
-	integer.array = false;
+	std::lock_guard<std::mutex> lock(builtInMutex);
 
-	TPublicType floatingPoint;
-	floatingPoint.type = EbtFloat;
-	floatingPoint.primarySize = 1;
-	floatingPoint.secondarySize = 1;
-	floatingPoint.array = false;
-
-	switch(shaderType)
+	for(size_t i = 0; i < builtInSymbols.size(); i++)
 	{
-	case GL_FRAGMENT_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpMedium);
-		break;
-	case GL_VERTEX_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpHigh);
-		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
-		break;
-	default: assert(false && "Language not supported");
+		TBuiltInSymbols *builtIns = builtInSymbols[i];
+
+		// The resources only hold integers, so there is no padding to compare
+		if(builtIns->shaderType == shaderType && memcmp(&builtIns->resources, &resources, sizeof(ShBuiltInResources)) == 0)
+		{
+			symbolTable.shareBuiltIns(builtIns->symbolTable);
+			return true;
+		}
 	}
 
-	InsertBuiltInFunctions(shaderType, resources, symbolTable);
+	TBuiltInSymbols *builtIns = new TBuiltInSymbols;
+	builtIns->shaderType = shaderType;
+	builtIns->resources = resources;
 
-	IdentifyBuiltIns(shaderType, resources, symbolTable);
+	SetGlobalPoolAllocator(&builtIns->allocator);
+	GenerateBuiltInSymbolTable(shaderType, resources, builtIns->symbolTable);
+	SetGlobalPoolAllocator(&allocator);
+
+	builtInSymbols.push_back(builtIns);
+	symbolTable.shareBuiltIns(builtIns->symbolTable);
 
 	return true;
 }
@@ -264,6 +311,12 @@ bool InitCompilerGlobals()
 
 void FreeCompilerGlobals()
 {
+	for(size_t i = 0; i < builtInSymbols.size(); i++)
+	{
+		delete builtInSymbols[i];
+	}
+	builtInSymbols.clear();
+
 	FreeParseContextIndex();
 	FreePoolIndex();
 }
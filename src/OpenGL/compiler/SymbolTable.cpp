@@ -31,7 +31,7 @@
 #define snprintf _snprintf
 #endif
 
-int TSymbolTableLevel::uniqueId = 0;
+std::atomic<int> TSymbolTableLevel::uniqueId(0);
 
 TType::TType(const TPublicType &p) :
 	type(p.type), precision(p.precision), qualifier(p.qualifier), invariant(false), layoutQualifier(TLayoutQualifier::create()),
@@ -184,6 +184,42 @@ TSymbolTableLevel::~TSymbolTableLevel()
 		delete (*it).second;
 }
 
+static void finalizeType(const TType &type)
+{
+	// Mangled names and structure sizes are cached on first use
+	const_cast<TType&>(type).getMangledName();
+	type.getObjectSize();
+
+	if(type.getStruct())
+	{
+		type.getStruct()->deepestNesting();
+	}
+}
+
+void TSymbolTableLevel::finalize()
+{
+	for(tLevel::iterator it = level.begin(); it != level.end(); ++it)
+	{
+		TSymbol *symbol = (*it).second;
+
+		if(symbol->isFunction())
+		{
+			const TFunction *function = static_cast<const TFunction*>(symbol);
+
+			finalizeType(function->getReturnType());
+
+			for(size_t i = 0; i < function->getParamCount(); i++)
+			{
+				finalizeType(*function->getParam(i).type);
+			}
+		}
+		else if(symbol->isVariable())
+		{
+			finalizeType(static_cast<const TVariable*>(symbol)->getType());
+		}
+	}
+}
+
 TSymbol *TSymbolTable::find(const TString &name, int shaderVersion, bool *builtIn, bool *sameScope) const
 {
 	int level = currentLevel();
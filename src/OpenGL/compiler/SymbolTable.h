@@ -46,6 +46,7 @@
 
 #include "InfoSink.h"
 #include "intermediate.h"
+#include <atomic>
 #include <set>
 
 //
@@ -228,6 +229,10 @@ public:
 			return (*it).second;
 	}
 
+	// Computes all lazily evaluated type information up front,
+	// so the level can be shared read-only between compilers.
+	void finalize();
+
 	static int nextUniqueId()
 	{
 		return ++uniqueId;
@@ -235,7 +240,7 @@ public:
 
 protected:
 	tLevel level;
-	static int uniqueId;     // for unique identification in code generation
+	static std::atomic<int> uniqueId;     // for unique identification in code generation
 };
 
 enum ESymbolLevel
@@ -333,6 +338,24 @@ public:
 	}
 
 	bool isEmpty() { return table.empty(); }
+
+	// Makes the current levels safe to share, see shareBuiltIns()
+	void finalize()
+	{
+		for(size_t i = 0; i < table.size(); i++)
+		{
+			table[i]->finalize();
+		}
+	}
+
+	// Uses the built-in levels of another table, which must outlive this one
+	void shareBuiltIns(const TSymbolTable &builtIns)
+	{
+		assert(isEmpty() && builtIns.currentLevel() == LAST_BUILTIN_LEVEL);
+		table = builtIns.table;
+		precisionStack = builtIns.precisionStack;
+	}
+
 	bool atBuiltInLevel() { return currentLevel() <= LAST_BUILTIN_LEVEL; }
 	bool atGlobalLevel() { return currentLevel() <= GLOBAL_LEVEL; }
 	void push()
@@ -20,6 +20,8 @@
 #include <EGL/egl.h>
 #include <GLES/gl.h>
 
+#include <stdint.h>
+
 namespace egl
 {
 class Surface;
@@ -34,6 +36,8 @@ public:
 	virtual Image *createSharedImage(EGLenum target, GLuint name, GLuint textureLevel) = 0;
 	virtual int getClientVersion() const = 0;
 	virtual void finish() = 0;
+	virtual int64_t insertFence() = 0;   // Marks the work submitted so far
+	virtual bool waitFence(int64_t fence, uint64_t timeout) = 0;   // Nanoseconds, zero only polls. Returns whether the fence was reached.
 
 protected:
 	virtual ~Context() {};
@@ -325,6 +325,7 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 	EGLenum textureFormat = EGL_NO_TEXTURE;
 	EGLenum textureTarget = EGL_NO_TEXTURE;
 	EGLBoolean largestPBuffer = EGL_FALSE;
+	EGLBoolean sharedMemory = EGL_FALSE;
 	const Config *configuration = mConfigSet.get(config);
 
 	if(attribList)
@@ -375,6 +376,9 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 				return error(EGL_BAD_MATCH, EGL_NO_SURFACE);
 			case EGL_VG_ALPHA_FORMAT:
 				return error(EGL_BAD_MATCH, EGL_NO_SURFACE);
+			case EGL_SHARED_MEMORY_SWIFTSHADER:
+				sharedMemory = attribList[1];
+				break;
 			default:
 				return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
 			}
@@ -410,7 +414,7 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 		return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
 	}
 
-	Surface *surface = new PBufferSurface(this, configuration, width, height, textureFormat, textureTarget, largestPBuffer);
+	Surface *surface = new PBufferSurface(this, configuration, width, height, textureFormat, textureTarget, largestPBuffer, sharedMemory);
 
 	if(!surface->initialize())
 	{
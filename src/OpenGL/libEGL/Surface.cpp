@@ -343,12 +343,13 @@ bool WindowSurface::reset(int backBufferWidth, int backBufferHeight)
 	return Surface::initialize();
 }
 
-PBufferSurface::PBufferSurface(Display *display, const Config *config, EGLint width, EGLint height, EGLenum textureFormat, EGLenum textureType, EGLBoolean largestPBuffer)
-	: Surface(display, config)
+PBufferSurface::PBufferSurface(Display *display, const Config *config, EGLint width, EGLint height, EGLenum textureFormat, EGLenum textureType, EGLBoolean largestPBuffer, EGLBoolean sharedMemory)
+	: Surface(display, config), sharedMemory(sharedMemory)
 {
 	this->width = width;
 	this->height = height;
 	this->largestPBuffer = largestPBuffer;
+	sharedMemoryFD = -1;
 }
 
 PBufferSurface::~PBufferSurface()
@@ -356,9 +357,52 @@ PBufferSurface::~PBufferSurface()
 	PBufferSurface::deleteResources();
 }
 
+bool PBufferSurface::initialize()
+{
+	if(!Surface::initialize())
+	{
+		return false;
+	}
+
+	if(sharedMemory)
+	{
+		// Rendering goes straight into the mapping, so readers never need a copy
+		sharedMemoryFD = backBuffer->exportSharedMemory();
+
+		if(sharedMemoryFD < 0)
+		{
+			ERR("Could not create shared memory for pbuffer");
+			deleteResources();
+			return error(EGL_BAD_ALLOC, false);
+		}
+	}
+
+	return true;
+}
+
 void PBufferSurface::swap()
 {
-	// No effect
+	if(backBuffer && hasSharedMemory())
+	{
+		// Waits for the pending draws, and resolves fast clears and multisampling into the mapping
+		backBuffer->lockInternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC);
+		backBuffer->unlockInternal();
+	}
+}
+
+EGLint PBufferSurface::getSharedMemoryFD() const
+{
+	return sharedMemoryFD;
+}
+
+EGLint PBufferSurface::getSharedMemoryStride() const
+{
+	return backBuffer->getInternalPitchB();
+}
+
+EGLint PBufferSurface::getSharedMemoryFourCC() const
+{
+	return FourCCFromInternalFormat(backBuffer->sw::Surface::getInternalFormat());
 }
 
 EGLNativeWindowType PBufferSurface::getWindowHandle() const
@@ -121,16 +121,26 @@ private:
 class PBufferSurface : public Surface
 {
 public:
-	PBufferSurface(Display *display, const egl::Config *config, EGLint width, EGLint height, EGLenum textureFormat, EGLenum textureTarget, EGLBoolean largestPBuffer);
+	PBufferSurface(Display *display, const egl::Config *config, EGLint width, EGLint height, EGLenum textureFormat, EGLenum textureTarget, EGLBoolean largestPBuffer, EGLBoolean sharedMemory = EGL_FALSE);
 	~PBufferSurface() override;
 
+	bool initialize() override;
+
 	bool isPBufferSurface() const override { return true; }
 	void swap() override;
 
 	EGLNativeWindowType getWindowHandle() const override;
 
+	bool hasSharedMemory() const { return sharedMemoryFD >= 0; }
+	EGLint getSharedMemoryFD() const;
+	EGLint getSharedMemoryStride() const;
+	EGLint getSharedMemoryFourCC() const;
+
 private:
 	void deleteResources() override;
+
+	const EGLBoolean sharedMemory;   // Back buffer lives in a memory file the client can map
+	int sharedMemoryFD;
 };
 }
 
@@ -31,6 +31,7 @@ public:
 	{
 		status = EGL_UNSIGNALED_KHR;
 		context->addRef();
+		fence = context->insertFence();
 	}
 
 	~FenceSync()
@@ -39,13 +40,23 @@ public:
 		context = nullptr;
 	}
 
-	void wait() { context->finish(); signal(); }
+	bool wait(EGLTimeKHR timeout)   // Zero only polls
+	{
+		if(context->waitFence(fence, timeout))
+		{
+			signal();
+		}
+
+		return isSignaled();
+	}
+
 	void signal() { status = EGL_SIGNALED_KHR; }
 	bool isSignaled() const { return status == EGL_SIGNALED_KHR; }
 
 private:
 	EGLint status;
 	Context *context;
+	int64_t fence;
 };
 
 }
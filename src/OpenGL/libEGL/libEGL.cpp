@@ -29,6 +29,10 @@
 #include "Main/libX11.hpp"
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
 #include <string.h>
 
 using namespace egl;
@@ -177,7 +181,8 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 			return success("EGL_KHR_platform_gbm "
 			               "EGL_KHR_platform_x11 "
 			               "EGL_EXT_client_extensions "
-			               "EGL_EXT_platform_base");
+			               "EGL_EXT_platform_base "
+			               "EGL_MESA_platform_surfaceless");
 		}
 	#endif
 
@@ -199,8 +204,12 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 		               "EGL_KHR_gl_renderbuffer_image "
 		               "EGL_KHR_fence_sync "
 		               "EGL_KHR_image_base "
+		               "EGL_KHR_surfaceless_context "
 		               "EGL_ANDROID_framebuffer_target "
-		               "EGL_ANDROID_recordable");
+		               "EGL_ANDROID_recordable "
+		               "EGL_EXT_image_dma_buf_import "
+		               "EGL_MESA_image_dma_buf_export "
+		               "EGL_SWIFTSHADER_shared_memory_pbuffer");
 	case EGL_VENDOR:
 		return success("Google Inc.");
 	case EGL_VERSION:
@@ -436,6 +445,25 @@ EGLBoolean QuerySurface(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EG
 	case EGL_WIDTH:
 		*value = eglSurface->getWidth();
 		break;
+	case EGL_SHARED_MEMORY_FD_SWIFTSHADER:
+	case EGL_SHARED_MEMORY_STRIDE_SWIFTSHADER:
+	case EGL_SHARED_MEMORY_FOURCC_SWIFTSHADER:
+		{
+			egl::PBufferSurface *pbuffer = eglSurface->isPBufferSurface() ? static_cast<egl::PBufferSurface*>(eglSurface) : nullptr;
+
+			if(!pbuffer || !pbuffer->hasSharedMemory())
+			{
+				return error(EGL_BAD_MATCH, EGL_FALSE);
+			}
+
+			switch(attribute)
+			{
+			case EGL_SHARED_MEMORY_FD_SWIFTSHADER:     *value = pbuffer->getSharedMemoryFD();     break;
+			case EGL_SHARED_MEMORY_STRIDE_SWIFTSHADER: *value = pbuffer->getSharedMemoryStride(); break;
+			case EGL_SHARED_MEMORY_FOURCC_SWIFTSHADER: *value = pbuffer->getSharedMemoryFourCC(); break;
+			}
+		}
+		break;
 	default:
 		return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
 	}
@@ -933,6 +961,74 @@ EGLBoolean CopyBuffers(EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType t
 	return success(EGL_FALSE);
 }
 
+// Memory file descriptors are mapped as the image's storage. This covers memfds, and
+// dma-bufs of exporters which support mmap, such as udmabuf and the dma-buf heaps.
+static EGLImageKHR CreateDmaBufImage(egl::Context *context, EGLClientBuffer buffer, const EGLint *attrib_list)
+{
+	if(context != EGL_NO_CONTEXT || buffer)
+	{
+		return error(EGL_BAD_PARAMETER, EGL_NO_IMAGE_KHR);
+	}
+
+	EGLint width = -1;
+	EGLint height = -1;
+	EGLint fourcc = 0;
+	EGLint fd = -1;
+	EGLint offset = 0;
+	EGLint pitch = -1;
+
+	if(attrib_list)
+	{
+		for(const EGLint *attribute = attrib_list; attribute[0] != EGL_NONE; attribute += 2)
+		{
+			switch(attribute[0])
+			{
+			case EGL_WIDTH:                     width = attribute[1];  break;
+			case EGL_HEIGHT:                    height = attribute[1]; break;
+			case EGL_LINUX_DRM_FOURCC_EXT:      fourcc = attribute[1]; break;
+			case EGL_DMA_BUF_PLANE0_FD_EXT:     fd = attribute[1];     break;
+			case EGL_DMA_BUF_PLANE0_OFFSET_EXT: offset = attribute[1]; break;
+			case EGL_DMA_BUF_PLANE0_PITCH_EXT:  pitch = attribute[1];  break;
+			case EGL_IMAGE_PRESERVED_KHR:                              break;   // Always preserved
+			case EGL_YUV_COLOR_SPACE_HINT_EXT:
+			case EGL_SAMPLE_RANGE_HINT_EXT:
+			case EGL_YUV_CHROMA_HORIZONTAL_SITING_HINT_EXT:
+			case EGL_YUV_CHROMA_VERTICAL_SITING_HINT_EXT:                  break;   // Only RGB formats are supported
+			default:
+				return error(EGL_BAD_ATTRIBUTE, EGL_NO_IMAGE_KHR);
+			}
+		}
+	}
+
+	if(width <= 0 || height <= 0 || fd < 0 || pitch <= 0 || offset < 0)
+	{
+		return error(EGL_BAD_PARAMETER, EGL_NO_IMAGE_KHR);
+	}
+
+	if(GLPixelFormatFromFourCC(fourcc) == GL_NONE)
+	{
+		return error(EGL_BAD_MATCH, EGL_NO_IMAGE_KHR);
+	}
+
+	egl::Image *image = nullptr;
+
+	if(libGLESv2)
+	{
+		image = libGLESv2->createSharedMemoryImage(fd, width, height, fourcc, offset, pitch);
+	}
+	else if(libGLES_CM)
+	{
+		image = libGLES_CM->createSharedMemoryImage(fd, width, height, fourcc, offset, pitch);
+	}
+
+	if(!image)
+	{
+		return error(EGL_BAD_ACCESS, EGL_NO_IMAGE_KHR);
+	}
+
+	return success((EGLImageKHR)image);
+}
+
 EGLImageKHR CreateImageKHR(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list)
 {
 	TRACE("(EGLDisplay dpy = %p, EGLContext ctx = %p, EGLenum target = 0x%X, buffer = %p, const EGLint attrib_list = %p)", dpy, ctx, target, buffer, attrib_list);
@@ -950,6 +1046,11 @@ EGLImageKHR CreateImageKHR(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLCl
 		return error(EGL_BAD_CONTEXT, EGL_NO_IMAGE_KHR);
 	}
 
+	if(target == EGL_LINUX_DMA_BUF_EXT)
+	{
+		return CreateDmaBufImage(context, buffer, attrib_list);
+	}
+
 	EGLenum imagePreserved = EGL_FALSE;
 	GLuint textureLevel = 0;
 	if(attrib_list)
@@ -1037,6 +1138,79 @@ EGLBoolean DestroyImageKHR(EGLDisplay dpy, EGLImageKHR image)
 	return success(EGL_TRUE);
 }
 
+EGLBoolean ExportDMABUFImageQueryMESA(EGLDisplay dpy, EGLImageKHR image, int *fourcc, int *num_planes, EGLuint64KHR *modifiers)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLImageKHR image = %p, int *fourcc = %p, int *num_planes = %p, EGLuint64KHR *modifiers = %p)", dpy, image, fourcc, num_planes, modifiers);
+
+	egl::Display *display = egl::Display::get(dpy);
+
+	if(!validateDisplay(display))
+	{
+		return error(EGL_BAD_DISPLAY, EGL_FALSE);
+	}
+
+	if(!image)
+	{
+		return error(EGL_BAD_PARAMETER, EGL_FALSE);
+	}
+
+	egl::Image *eglImage = static_cast<egl::Image*>(image);
+	int format = FourCCFromInternalFormat(eglImage->sw::Surface::getInternalFormat());
+
+	if(format == 0)
+	{
+		return error(EGL_BAD_MATCH, EGL_FALSE);
+	}
+
+	if(fourcc) *fourcc = format;
+	if(num_planes) *num_planes = 1;
+	if(modifiers) *modifiers = 0;   // DRM_FORMAT_MOD_LINEAR
+
+	return success(EGL_TRUE);
+}
+
+EGLBoolean ExportDMABUFImageMESA(EGLDisplay dpy, EGLImageKHR image, int *fds, EGLint *strides, EGLint *offsets)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLImageKHR image = %p, int *fds = %p, EGLint *strides = %p, EGLint *offsets = %p)", dpy, image, fds, strides, offsets);
+
+	egl::Display *display = egl::Display::get(dpy);
+
+	if(!validateDisplay(display))
+	{
+		return error(EGL_BAD_DISPLAY, EGL_FALSE);
+	}
+
+	if(!image)
+	{
+		return error(EGL_BAD_PARAMETER, EGL_FALSE);
+	}
+
+	egl::Image *eglImage = static_cast<egl::Image*>(image);
+
+	if(FourCCFromInternalFormat(eglImage->sw::Surface::getInternalFormat()) == 0)
+	{
+		return error(EGL_BAD_MATCH, EGL_FALSE);
+	}
+
+	// Rendering to and sampling from the image use the shared memory from now on
+	int fd = eglImage->exportSharedMemory();
+
+	#if defined(__linux__)
+		fd = (fd >= 0) ? fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1;   // Owned by the caller
+	#endif
+
+	if(fd < 0)
+	{
+		return error(EGL_BAD_ALLOC, EGL_FALSE);
+	}
+
+	if(fds) fds[0] = fd;
+	if(strides) strides[0] = eglImage->getInternalPitchB();
+	if(offsets) offsets[0] = 0;
+
+	return success(EGL_TRUE);
+}
+
 EGLDisplay GetPlatformDisplayEXT(EGLenum platform, void *native_display, const EGLint *attrib_list)
 {
 	TRACE("(EGLenum platform = 0x%X, void *native_display = %p, const EGLint *attrib_list = %p)", platform, native_display, attrib_list);
@@ -1046,6 +1220,7 @@ EGLDisplay GetPlatformDisplayEXT(EGLenum platform, void *native_display, const E
 	#if defined(__linux__) && !defined(__ANDROID__)
 	case EGL_PLATFORM_X11_EXT: break;
 	case EGL_PLATFORM_GBM_KHR: break;
+	case EGL_PLATFORM_SURFACELESS_MESA: break;
 	#endif
 	default:
 		return error(EGL_BAD_PARAMETER, EGL_NO_DISPLAY);
@@ -1064,7 +1239,7 @@ EGLDisplay GetPlatformDisplayEXT(EGLenum platform, void *native_display, const E
 				return error(EGL_BAD_ATTRIBUTE, EGL_NO_DISPLAY);   // Unimplemented
 			}
 		}
-		else if(platform == EGL_PLATFORM_GBM_KHR)
+		else if(platform == EGL_PLATFORM_GBM_KHR || platform == EGL_PLATFORM_SURFACELESS_MESA)
 		{
 			if(native_display != (void*)EGL_DEFAULT_DISPLAY || attrib_list != NULL)
 			{
@@ -1160,12 +1335,12 @@ EGLint ClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeK
 		return error(EGL_BAD_PARAMETER, EGL_FALSE);
 	}
 
+	// Commands are processed as soon as they're issued, so EGL_SYNC_FLUSH_COMMANDS_BIT_KHR needs no action
 	(void)flags;
-	(void)timeout;
 
-	if(!eglSync->isSignaled())
+	if(!eglSync->isSignaled() && !eglSync->wait(timeout))
 	{
-		eglSync->wait();
+		return success(EGL_TIMEOUT_EXPIRED_KHR);
 	}
 
 	return success(EGL_CONDITION_SATISFIED_KHR);
@@ -1194,8 +1369,7 @@ EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, E
 		*value = EGL_SYNC_FENCE_KHR;
 		return success(EGL_TRUE);
 	case EGL_SYNC_STATUS_KHR:
-		eglSync->wait();   // TODO: Don't block. Just poll based on sw::Query.
-		*value = eglSync->isSignaled() ? EGL_SIGNALED_KHR : EGL_UNSIGNALED_KHR;
+		*value = (eglSync->isSignaled() || eglSync->wait(0)) ? EGL_SIGNALED_KHR : EGL_UNSIGNALED_KHR;
 		return success(EGL_TRUE);
 	case EGL_SYNC_CONDITION_KHR:
 		*value = EGL_SYNC_PRIOR_COMMANDS_COMPLETE_KHR;
@@ -1228,6 +1402,8 @@ __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname)
 		EXTENSION(eglDestroySyncKHR),
 		EXTENSION(eglClientWaitSyncKHR),
 		EXTENSION(eglGetSyncAttribKHR),
+		EXTENSION(eglExportDMABUFImageQueryMESA),
+		EXTENSION(eglExportDMABUFImageMESA),
 
 		#undef EXTENSION
 	};
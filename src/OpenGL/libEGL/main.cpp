@@ -362,6 +362,8 @@ EGLSyncKHR CreateSyncKHR(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list
 EGLBoolean DestroySyncKHR(EGLDisplay dpy, EGLSyncKHR sync);
 EGLint ClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
 EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value);
+EGLBoolean ExportDMABUFImageQueryMESA(EGLDisplay dpy, EGLImageKHR image, int *fourcc, int *num_planes, EGLuint64KHR *modifiers);
+EGLBoolean ExportDMABUFImageMESA(EGLDisplay dpy, EGLImageKHR image, int *fds, EGLint *strides, EGLint *offsets);
 __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname);
 }
 
@@ -577,6 +579,16 @@ EGLAPI EGLBoolean EGLAPIENTRY eglGetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR syn
 	return egl::GetSyncAttribKHR(dpy, sync, attribute, value);
 }
 
+EGLAPI EGLBoolean EGLAPIENTRY eglExportDMABUFImageQueryMESA(EGLDisplay dpy, EGLImageKHR image, int *fourcc, int *num_planes, EGLuint64KHR *modifiers)
+{
+	return egl::ExportDMABUFImageQueryMESA(dpy, image, fourcc, num_planes, modifiers);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglExportDMABUFImageMESA(EGLDisplay dpy, EGLImageKHR image, int *fds, EGLint *strides, EGLint *offsets)
+{
+	return egl::ExportDMABUFImageMESA(dpy, image, fds, strides, offsets);
+}
+
 EGLAPI __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress(const char *procname)
 {
 	return egl::GetProcAddress(procname);
@@ -17,7 +17,7 @@
 #include "Query.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
+#include "Common/Resource.hpp"
 
 namespace gl
 {
@@ -61,7 +61,12 @@ void Query::begin()
 	Device *device = getDevice();
 
 	mQuery->begin();
-	device->addQuery(mQuery);
+
+	if(!device->addQuery(mQuery))
+	{
+		return error(GL_OUT_OF_MEMORY);
+	}
+
 	device->setOcclusionEnabled(true);
 }
 
@@ -86,10 +91,8 @@ GLuint Query::getResult()
 {
 	if(mQuery)
 	{
-		while(!testQuery())
-		{
-			sw::Thread::yield();
-		}
+		sw::Timeline::wait(mQuery->serial);
+		testQuery();
 	}
 
 	return (GLuint)mResult;
@@ -114,7 +117,7 @@ GLboolean Query::testQuery()
 {
 	if(mQuery && mStatus != GL_TRUE)
 	{
-		if(!mQuery->building && mQuery->reference == 0)
+		if(mQuery->available())
 		{
 			unsigned int numPixels = mQuery->data;
 			mStatus = GL_TRUE;
@@ -286,20 +286,21 @@ void Context::makeCurrent(egl::Surface *surface)
 	{
 		mState.viewportX = 0;
 		mState.viewportY = 0;
-		mState.viewportWidth = surface->getWidth();
-		mState.viewportHeight = surface->getHeight();
+		mState.viewportWidth = surface ? surface->getWidth() : 0;
+		mState.viewportHeight = surface ? surface->getHeight() : 0;
 
 		mState.scissorX = 0;
 		mState.scissorY = 0;
-		mState.scissorWidth = surface->getWidth();
-		mState.scissorHeight = surface->getHeight();
+		mState.scissorWidth = surface ? surface->getWidth() : 0;
+		mState.scissorHeight = surface ? surface->getHeight() : 0;
 
 		mHasBeenCurrent = true;
 	}
 
-	// Wrap the existing resources into GL objects and assign them to the '0' names
-	egl::Image *defaultRenderTarget = surface->getRenderTarget();
-	egl::Image *depthStencil = surface->getDepthStencil();
+	// Wrap the existing resources into GL objects and assign them to the '0' names.
+	// Without a surface (EGL_KHR_surfaceless_context) the default framebuffer is incomplete.
+	egl::Image *defaultRenderTarget = surface ? surface->getRenderTarget() : nullptr;
+	egl::Image *depthStencil = surface ? surface->getDepthStencil() : nullptr;
 
 	Colorbuffer *colorbufferZero = new Colorbuffer(defaultRenderTarget);
 	DepthStencilbuffer *depthStencilbufferZero = new DepthStencilbuffer(depthStencil);
@@ -2836,6 +2837,17 @@ void Context::flush()
 	// We don't queue anything without processing it as fast as possible
 }
 
+int64_t Context::insertFence()
+{
+	// Draws are handed to the renderer as they're issued, so this needs no flush
+	return device->getSerial();
+}
+
+bool Context::waitFence(int64_t fence, uint64_t timeout)
+{
+	return sw::Timeline::wait(fence, timeout);
+}
+
 void Context::recordInvalidEnum()
 {
 	mInvalidEnum = true;
@@ -299,6 +299,8 @@ public:
 	virtual void makeCurrent(egl::Surface *surface);
 	virtual int getClientVersion() const;
 	virtual void finish();
+	virtual int64_t insertFence();
+	virtual bool waitFence(int64_t fence, uint64_t timeout);
 
 	void markAllStateDirty();
 
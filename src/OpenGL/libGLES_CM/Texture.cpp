@@ -733,11 +733,72 @@ void Texture2D::autoGenerateMipmaps()
 {
 	if(generateMipmap && image[0]->hasDirtyMipmaps())
 	{
-		generateMipmaps();
-		image[0]->cleanMipmaps();
+		if(!updateMipmaps(image[0]->getDirtyMipmapRect()))
+		{
+			generateMipmaps();
+		}
+
+		// Later writes to any level get detected by updateMipmaps()
+		int q = log2(std::max(image[0]->getWidth(), image[0]->getHeight()));
+
+		for(int level = 0; level <= q; level++)
+		{
+			image[level]->cleanMipmaps();
+		}
 	}
 }
 
+// Filters the blocks of each level which cover the modified region of the base level again.
+// Returns false if the whole chain has to be regenerated.
+bool Texture2D::updateMipmaps(sw::Rect region)
+{
+	GLsizei width = image[0]->getWidth();
+	GLsizei height = image[0]->getHeight();
+
+	// Only halving exactly maps each texel onto the same 2x2 block as filtering the whole level does
+	if(!sw::isPow2(width) || !sw::isPow2(height) || !isMipmapComplete())
+	{
+		return false;
+	}
+
+	int q = log2(std::max(width, height));
+
+	for(int level = 1; level <= q; level++)
+	{
+		if(image[level]->hasDirtyMipmaps())   // Written since the chain was generated
+		{
+			return false;
+		}
+	}
+
+	for(int level = 1; level <= q && region.x0 < region.x1 && region.y0 < region.y1; level++)
+	{
+		int sourceWidth = image[level - 1]->getWidth();
+		int sourceHeight = image[level - 1]->getHeight();
+
+		sw::SliceRect sourceRect(region.x0 & ~1, region.y0 & ~1, std::min((int)sw::align(region.x1, 2), sourceWidth), std::min((int)sw::align(region.y1, 2), sourceHeight), 0);
+		sw::SliceRect destRect(sourceRect.x0 / 2, sourceRect.y0 / 2, std::max(sourceRect.x1 / 2, 1), std::max(sourceRect.y1 / 2, 1), 0);
+
+		if(sourceWidth == 1)
+		{
+			destRect.x0 = 0;
+			destRect.x1 = 1;
+		}
+
+		if(sourceHeight == 1)
+		{
+			destRect.y0 = 0;
+			destRect.y1 = 1;
+		}
+
+		getDevice()->stretchRect(image[level - 1], &sourceRect, image[level], &destRect, true);
+
+		region = destRect;
+	}
+
+	return true;
+}
+
 egl::Image *Texture2D::getImage(unsigned int level)
 {
 	return image[level];
@@ -818,6 +879,11 @@ egl::Image *createBackBuffer(int width, int height, const egl::Config *config)
 	return nullptr;
 }
 
+egl::Image *createSharedMemoryImage(int fd, int width, int height, int fourcc, int offset, int pitch)
+{
+	return egl::Image::importSharedMemory(fd, width, height, fourcc, offset, pitch);
+}
+
 egl::Image *createDepthStencil(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool discard)
 {
 	if(height > sw::OUTLINE_RESOLUTION)
@@ -171,6 +171,7 @@ protected:
 	virtual ~Texture2D();
 
 	bool isMipmapComplete() const;
+	bool updateMipmaps(sw::Rect region);
 
 	egl::Image *image[IMPLEMENTATION_MAX_TEXTURE_LEVELS];
 
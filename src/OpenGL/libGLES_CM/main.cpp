@@ -334,6 +334,7 @@ egl::Context *es1CreateContext(const egl::Config *config, const egl::Context *sh
 extern "C" __eglMustCastToProperFunctionPointerType es1GetProcAddress(const char *procname);
 egl::Image *createBackBuffer(int width, int height, const egl::Config *config);
 egl::Image *createDepthStencil(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool discard);
+egl::Image *createSharedMemoryImage(int fd, int width, int height, int fourcc, int offset, int pitch);
 sw::FrameBuffer *createFrameBuffer(void *display, EGLNativeWindowType window, int width, int height);
 
 extern "C"
@@ -1597,6 +1598,7 @@ LibGLES_CMexports::LibGLES_CMexports()
 	this->es1GetProcAddress = ::es1GetProcAddress;
 	this->createBackBuffer = ::createBackBuffer;
 	this->createDepthStencil = ::createDepthStencil;
+	this->createSharedMemoryImage = ::createSharedMemoryImage;
 	this->createFrameBuffer = ::createFrameBuffer;
 }
 
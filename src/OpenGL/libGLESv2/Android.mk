@@ -36,6 +36,8 @@ COMMON_SRC_FILES := \
 	Renderbuffer.cpp \
 	ResourceManager.cpp \
 	Shader.cpp \
+	ShaderCache.cpp \
+	TaskQueue.cpp \
 	Texture.cpp \
 	TransformFeedback.cpp \
 	utilities.cpp \
@@ -34,6 +34,7 @@ Buffer::Buffer(GLuint name) : NamedObject(name)
 	mOffset = 0;
 	mLength = 0;
 	mAccess = 0;
+	mDeviceWrite = false;
 }
 
 Buffer::~Buffer()
@@ -54,6 +55,7 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 
 	mSize = size;
 	mUsage = usage;
+	mIndexRanges.clear();
 
 	if(size > 0)
 	{
@@ -77,6 +79,8 @@ void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 {
 	if(mContents && data)
 	{
+		mIndexRanges.clear();
+
 		char *buffer = (char*)mContents->lock(sw::PUBLIC);
 		memcpy(buffer + offset, data, size);
 		mContents->unlock();
@@ -92,6 +96,12 @@ void* Buffer::mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
 		mOffset = offset;
 		mLength = length;
 		mAccess = access;
+
+		if(access & GL_MAP_WRITE_BIT)
+		{
+			mIndexRanges.clear();
+		}
+
 		return buffer + offset;
 	}
 	return nullptr;
@@ -115,4 +125,69 @@ sw::Resource *Buffer::getResource()
 	return mContents;
 }
 
+bool Buffer::IndexRangeKey::operator<(const IndexRangeKey &key) const
+{
+	if(offset != key.offset) return offset < key.offset;
+	if(count != key.count) return count < key.count;
+	if(type != key.type) return type < key.type;
+	return primitiveRestart < key.primitiveRestart;
+}
+
+bool Buffer::cachesIndexRanges()
+{
+	if(mDeviceWrite)
+	{
+		// Ranges computed before the renderer's writes retired would be stale
+		if(mContents && mContents->inUse())
+		{
+			return false;
+		}
+
+		mIndexRanges.clear();
+		mDeviceWrite = false;
+	}
+
+	return true;
+}
+
+bool Buffer::getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, GLuint *minIndex, GLuint *maxIndex)
+{
+	if(!cachesIndexRanges())
+	{
+		return false;
+	}
+
+	IndexRangeKey key = {type, offset, count, primitiveRestart};
+	auto range = mIndexRanges.find(key);
+
+	if(range == mIndexRanges.end())
+	{
+		return false;
+	}
+
+	*minIndex = range->second.minIndex;
+	*maxIndex = range->second.maxIndex;
+
+	return true;
+}
+
+void Buffer::setIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, GLuint minIndex, GLuint maxIndex)
+{
+	if(!cachesIndexRanges())
+	{
+		return;
+	}
+
+	// Applications which draw from many different offsets would otherwise grow the cache without bound
+	if(mIndexRanges.size() >= MAX_INDEX_RANGES)
+	{
+		mIndexRanges.clear();
+	}
+
+	IndexRangeKey key = {type, offset, count, primitiveRestart};
+	IndexRange range = {minIndex, maxIndex};
+
+	mIndexRanges[key] = range;
+}
+
 }
@@ -25,6 +25,7 @@
 #include <GLES2/gl2.h>
 
 #include <cstddef>
+#include <map>
 #include <vector>
 
 namespace es2
@@ -53,7 +54,33 @@ public:
 
 	sw::Resource *getResource();
 
+	// Caches the range of indices referenced by draw calls, since the contents rarely change between them
+	bool getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, GLuint *minIndex, GLuint *maxIndex);
+	void setIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, GLuint minIndex, GLuint maxIndex);
+	void invalidateIndexRanges() { mIndexRanges.clear(); }   // Must be called when the contents are written by the API
+	void deviceWrite() { mIndexRanges.clear(); mDeviceWrite = true; }   // Must be called when the renderer is going to write the contents
+
 private:
+	enum { MAX_INDEX_RANGES = 64 };
+
+	bool cachesIndexRanges();
+
+	struct IndexRangeKey
+	{
+		bool operator<(const IndexRangeKey &key) const;
+
+		GLenum type;
+		GLintptr offset;
+		GLsizei count;
+		bool primitiveRestart;
+	};
+
+	struct IndexRange
+	{
+		GLuint minIndex;
+		GLuint maxIndex;
+	};
+
 	sw::Resource *mContents;
 	size_t mSize;
 	GLenum mUsage;
@@ -61,6 +88,9 @@ private:
 	GLintptr mOffset;
 	GLsizeiptr mLength;
 	GLbitfield mAccess;
+
+	std::map<IndexRangeKey, IndexRange> mIndexRanges;
+	bool mDeviceWrite;   // Ranges aren't cached until the renderer's writes retired
 };
 
 class BufferBinding
@@ -271,20 +271,21 @@ void Context::makeCurrent(egl::Surface *surface)
 
 		mState.viewportX = 0;
 		mState.viewportY = 0;
-		mState.viewportWidth = surface->getWidth();
-		mState.viewportHeight = surface->getHeight();
+		mState.viewportWidth = surface ? surface->getWidth() : 0;
+		mState.viewportHeight = surface ? surface->getHeight() : 0;
 
 		mState.scissorX = 0;
 		mState.scissorY = 0;
-		mState.scissorWidth = surface->getWidth();
-		mState.scissorHeight = surface->getHeight();
+		mState.scissorWidth = surface ? surface->getWidth() : 0;
+		mState.scissorHeight = surface ? surface->getHeight() : 0;
 
 		mHasBeenCurrent = true;
 	}
 
-	// Wrap the existing resources into GL objects and assign them to the '0' names
-	egl::Image *defaultRenderTarget = surface->getRenderTarget();
-	egl::Image *depthStencil = surface->getDepthStencil();
+	// Wrap the existing resources into GL objects and assign them to the '0' names.
+	// Without a surface (EGL_KHR_surfaceless_context) the default framebuffer is incomplete.
+	egl::Image *defaultRenderTarget = surface ? surface->getRenderTarget() : nullptr;
+	egl::Image *depthStencil = surface ? surface->getDepthStencil() : nullptr;
 
 	Colorbuffer *colorbufferZero = new Colorbuffer(defaultRenderTarget);
 	DepthStencilbuffer *depthStencilbufferZero = new DepthStencilbuffer(depthStencil);
@@ -947,7 +948,7 @@ GLuint Context::createVertexArray()
 
 GLsync Context::createFenceSync(GLenum condition, GLbitfield flags)
 {
-	GLuint handle = mResourceManager->createFenceSync(condition, flags);
+	GLuint handle = mResourceManager->createFenceSync(condition, flags, insertFence(), this);
 
 	return reinterpret_cast<GLsync>(static_cast<uintptr_t>(handle));
 }
@@ -1081,10 +1082,34 @@ Buffer *Context::getBuffer(GLuint handle) const
 
 Shader *Context::getShader(GLuint handle) const
 {
-	return mResourceManager->getShader(handle);
+	Shader *shader = mResourceManager->getShader(handle);
+
+	if(shader)
+	{
+		shader->wait();
+	}
+
+	return shader;
 }
 
 Program *Context::getProgram(GLuint handle) const
+{
+	Program *program = mResourceManager->getProgram(handle);
+
+	if(program)
+	{
+		program->wait();
+	}
+
+	return program;
+}
+
+Shader *Context::getPendingShader(GLuint handle) const
+{
+	return mResourceManager->getShader(handle);
+}
+
+Program *Context::getPendingProgram(GLuint handle) const
 {
 	return mResourceManager->getProgram(handle);
 }
@@ -1528,6 +1553,39 @@ Buffer *Context::getPixelUnpackBuffer() const
 	return mState.pixelUnpackBuffer;
 }
 
+// With a pixel unpack buffer bound, the pixels of a texture upload are an offset into it,
+// and all of the rows have to lie within the buffer
+GLenum Context::validateUnpackBuffer(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) const
+{
+	Buffer *buffer = getPixelUnpackBuffer();
+
+	if(!buffer || width == 0 || height == 0 || depth == 0)
+	{
+		return GL_NONE;
+	}
+
+	if(buffer->isMapped())
+	{
+		return GL_INVALID_OPERATION;
+	}
+
+	const egl::Image::UnpackInfo &unpackInfo = mState.unpackInfo;
+	GLsizei inputWidth = (unpackInfo.rowLength == 0) ? width : unpackInfo.rowLength;
+	GLsizei inputPitch = egl::ComputePitch(inputWidth, format, type, unpackInfo.alignment);
+	GLsizei inputHeight = (unpackInfo.imageHeight == 0) ? height : unpackInfo.imageHeight;
+
+	size_t offset = reinterpret_cast<size_t>(pixels) + egl::ComputePackingOffset(format, type, inputWidth, inputHeight, unpackInfo.alignment, unpackInfo.skipImages, unpackInfo.skipRows, unpackInfo.skipPixels);
+	size_t rows = (size_t)inputHeight * (depth - 1) + (height - 1);
+	size_t bytes = rows * inputPitch + egl::ComputePitch(width, format, type, 1);   // The last row isn't padded
+
+	if(offset + bytes > buffer->size())
+	{
+		return GL_INVALID_OPERATION;
+	}
+
+	return GL_NONE;
+}
+
 Buffer *Context::getGenericUniformBuffer() const
 {
 	return mState.genericUniformBuffer;
@@ -1599,7 +1657,7 @@ TransformFeedback *Context::getTransformFeedback() const
 
 Program *Context::getCurrentProgram() const
 {
-	return mResourceManager->getProgram(mState.currentProgram);
+	return getProgram(mState.currentProgram);
 }
 
 Texture2D *Context::getTexture2D() const
@@ -1852,6 +1910,7 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 	case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:   *params = MAX_VERTEX_TEXTURE_IMAGE_UNITS;   break;
 	case GL_MAX_TEXTURE_IMAGE_UNITS:          *params = MAX_TEXTURE_IMAGE_UNITS;          break;
 	case GL_MAX_FRAGMENT_UNIFORM_VECTORS:     *params = MAX_FRAGMENT_UNIFORM_VECTORS;     break;
+	case GL_MAX_SHADER_COMPILER_THREADS_KHR:  *params = TaskQueue::getMaxThreads();       break;
 	case GL_MAX_RENDERBUFFER_SIZE:            *params = IMPLEMENTATION_MAX_RENDERBUFFER_SIZE; break;
 	case GL_NUM_SHADER_BINARY_FORMATS:        *params = 0;                                    break;
 	case GL_SHADER_BINARY_FORMATS:      /* no shader binary formats are supported */          break;
@@ -2442,6 +2501,7 @@ bool Context::getQueryParameterInfo(GLenum pname, GLenum *type, unsigned int *nu
 	case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
 	case GL_MAX_TEXTURE_IMAGE_UNITS:
 	case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
+	case GL_MAX_SHADER_COMPILER_THREADS_KHR:
 	case GL_MAX_RENDERBUFFER_SIZE:
 	case GL_NUM_SHADER_BINARY_FORMATS:
 	case GL_NUM_COMPRESSED_TEXTURE_FORMATS:
@@ -2984,7 +3044,7 @@ GLenum Context::applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsize
 // Applies the indices and element array bindings
 GLenum Context::applyIndexBuffer(const void *indices, GLuint start, GLuint end, GLsizei count, GLenum mode, GLenum type, TranslatedIndexData *indexInfo)
 {
-	GLenum err = mIndexDataManager->prepareIndexData(type, start, end, count, getCurrentVertexArray()->getElementArrayBuffer(), indices, indexInfo);
+	GLenum err = mIndexDataManager->prepareIndexData(type, start, end, count, mState.primitiveRestartFixedIndexEnabled, getCurrentVertexArray()->getElementArrayBuffer(), indices, indexInfo);
 
 	if(err == GL_NO_ERROR)
 	{
@@ -3252,6 +3312,11 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	GLsizei outputWidth = (mState.packRowLength > 0) ? mState.packRowLength : width;
 	GLsizei outputPitch = egl::ComputePitch(outputWidth, format, type, mState.packAlignment);
 	GLsizei outputHeight = (mState.packImageHeight == 0) ? height : mState.packImageHeight;
+	if(getPixelPackBuffer())
+	{
+		getPixelPackBuffer()->invalidateIndexRanges();
+	}
+
 	pixels = getPixelPackBuffer() ? (unsigned char*)getPixelPackBuffer()->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
 	pixels = ((char*)pixels) + egl::ComputePackingOffset(format, type, outputWidth, outputHeight, mState.packAlignment, mState.packSkipImages, mState.packSkipRows, mState.packSkipPixels);
 
@@ -3563,6 +3628,22 @@ void Context::flush()
 	// We don't queue anything without processing it as fast as possible
 }
 
+int64_t Context::insertFence()
+{
+	// Draws are handed to the renderer as they're issued, so this needs no flush
+	return device->getSerial();
+}
+
+bool Context::waitFence(int64_t fence, uint64_t timeout)
+{
+	return sw::Timeline::wait(fence, timeout);
+}
+
+void Context::serverWaitFence(int64_t fence)
+{
+	device->addDependency(fence);
+}
+
 void Context::recordInvalidEnum()
 {
 	mInvalidEnum = true;
@@ -4297,6 +4378,7 @@ const GLubyte* Context::getExtensions(GLuint index, GLuint* numExt) const
 #endif
 		(const GLubyte*)"GL_EXT_texture_filter_anisotropic",
 		(const GLubyte*)"GL_EXT_texture_format_BGRA8888",
+		(const GLubyte*)"GL_KHR_parallel_shader_compile",
 		(const GLubyte*)"GL_ANGLE_framebuffer_blit",
 		(const GLubyte*)"GL_NV_framebuffer_blit",
 		(const GLubyte*)"GL_ANGLE_framebuffer_multisample",
@@ -613,8 +613,10 @@ public:
 	Buffer *getBuffer(GLuint handle) const;
 	Fence *getFence(GLuint handle) const;
 	FenceSync *getFenceSync(GLsync handle) const;
-	Shader *getShader(GLuint handle) const;
-	Program *getProgram(GLuint handle) const;
+	Shader *getShader(GLuint handle) const;     // Waits for a pending compile
+	Program *getProgram(GLuint handle) const;   // Waits for a pending link
+	Shader *getPendingShader(GLuint handle) const;
+	Program *getPendingProgram(GLuint handle) const;
 	virtual Texture *getTexture(GLuint handle) const;
 	Framebuffer *getFramebuffer(GLuint handle) const;
 	virtual Renderbuffer *getRenderbuffer(GLuint handle) const;
@@ -633,6 +635,7 @@ public:
 	Buffer *getCopyWriteBuffer() const;
 	Buffer *getPixelPackBuffer() const;
 	Buffer *getPixelUnpackBuffer() const;
+	GLenum validateUnpackBuffer(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) const;
 	Buffer *getGenericUniformBuffer() const;
 	bool getBuffer(GLenum target, es2::Buffer **buffer) const;
 	Program *getCurrentProgram() const;
@@ -670,6 +673,9 @@ public:
 	void drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount = 1);
 	void finish();
 	void flush();
+	virtual int64_t insertFence();
+	virtual bool waitFence(int64_t fence, uint64_t timeout);
+	void serverWaitFence(int64_t fence);   // Makes later draws wait for the fence, without blocking
 
 	void recordInvalidEnum();
 	void recordInvalidValue();
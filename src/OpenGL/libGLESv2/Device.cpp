@@ -127,8 +127,10 @@ namespace es2
 		vertexShader = nullptr;
 
 		pixelShaderDirty = true;
+		pixelShaderConstantsFDirtyMin = FRAGMENT_UNIFORM_VECTORS;
 		pixelShaderConstantsFDirty = 0;
 		vertexShaderDirty = true;
+		vertexShaderConstantsFDirtyMin = VERTEX_UNIFORM_VECTORS;
 		vertexShaderConstantsFDirty = 0;
 
 		for(int i = 0; i < FRAGMENT_UNIFORM_VECTORS; i++)
@@ -345,6 +347,7 @@ namespace es2
 			pixelShaderConstantF[startRegister + i][3] = constantData[i * 4 + 3];
 		}
 
+		pixelShaderConstantsFDirtyMin = min(startRegister, pixelShaderConstantsFDirtyMin);
 		pixelShaderConstantsFDirty = max(startRegister + count, pixelShaderConstantsFDirty);
 		pixelShaderDirty = true;   // Reload DEF constants
 	}
@@ -436,6 +439,7 @@ namespace es2
 			vertexShaderConstantF[startRegister + i][3] = constantData[i * 4 + 3];
 		}
 
+		vertexShaderConstantsFDirtyMin = min(startRegister, vertexShaderConstantsFDirtyMin);
 		vertexShaderConstantsFDirty = max(startRegister + count, vertexShaderConstantsFDirty);
 		vertexShaderDirty = true;   // Reload DEF constants
 	}
@@ -502,6 +506,8 @@ namespace es2
 			return false;
 		}
 
+		resolve(source);   // Averages samples on the worker threads, the locks below wait for it
+
 		int sWidth = source->getWidth();
 		int sHeight = source->getHeight();
 		int dWidth = dest->getWidth();
@@ -579,16 +585,7 @@ namespace es2
 		}
 
 		bool scaling = (sRect.x1 - sRect.x0 != dRect.x1 - dRect.x0) || (sRect.y1 - sRect.y0 != dRect.y1 - dRect.y0);
-		bool equalFormats = source->getInternalFormat() == dest->getInternalFormat();
 		bool depthStencil = egl::Image::isDepth(source->getInternalFormat()) || egl::Image::isStencil(source->getInternalFormat());
-		bool alpha0xFF = false;
-
-		if((source->getInternalFormat() == FORMAT_A8R8G8B8 && dest->getInternalFormat() == FORMAT_X8R8G8B8) ||
-		   (source->getInternalFormat() == FORMAT_X8R8G8B8 && dest->getInternalFormat() == FORMAT_A8R8G8B8))
-		{
-			equalFormats = true;
-			alpha0xFF = true;
-		}
 
 		if(depthStencil)   // Copy entirely, internally   // FIXME: Check
 		{
@@ -614,32 +611,6 @@ namespace es2
 				dest->unlockStencil();
 			}
 		}
-		else if(!scaling && equalFormats)
-		{
-			unsigned char *sourceBytes = (unsigned char*)source->lockInternal(sRect.x0, sRect.y0, sourceRect->slice, LOCK_READONLY, PUBLIC);
-			unsigned char *destBytes = (unsigned char*)dest->lockInternal(dRect.x0, dRect.y0, destRect->slice, LOCK_READWRITE, PUBLIC);
-			unsigned int sourcePitch = source->getInternalPitchB();
-			unsigned int destPitch = dest->getInternalPitchB();
-
-			unsigned int width = dRect.x1 - dRect.x0;
-			unsigned int height = dRect.y1 - dRect.y0;
-
-			copyBuffer(sourceBytes, destBytes, width, height, sourcePitch, destPitch, egl::Image::bytes(source->getInternalFormat()), flipX, flipY);
-
-			if(alpha0xFF)
-			{
-				for(unsigned int y = 0; y < height; ++y, destBytes += destPitch)
-				{
-					for(unsigned int x = 0; x < width; ++x)
-					{
-						destBytes[4 * x + 3] = 0xFF;
-					}
-				}
-			}
-
-			source->unlockInternal();
-			dest->unlockInternal();
-		}
 		else
 		{
 			if(flipX)
@@ -650,6 +621,8 @@ namespace es2
 			{
 				swap(dRect.y0, dRect.y1);
 			}
+
+			// Unscaled copies between equal formats take the blitter's memcpy path on the worker threads
 			blit(source, sRect, dest, dRect, scaling && filter);
 		}
 
@@ -738,13 +711,14 @@ namespace es2
 		{
 			if(pixelShader)
 			{
-				if(pixelShaderConstantsFDirty)
+				if(pixelShaderConstantsFDirty > pixelShaderConstantsFDirtyMin)
 				{
-					Renderer::setPixelShaderConstantF(0, pixelShaderConstantF[0], pixelShaderConstantsFDirty);
+					Renderer::setPixelShaderConstantF(pixelShaderConstantsFDirtyMin, pixelShaderConstantF[pixelShaderConstantsFDirtyMin], pixelShaderConstantsFDirty - pixelShaderConstantsFDirtyMin);
 				}
 
 				Renderer::setPixelShader(pixelShader);   // Loads shader constants set with DEF
 				pixelShaderConstantsFDirty = pixelShader->dirtyConstantsF;   // Shader DEF'ed constants are dirty
+				pixelShaderConstantsFDirtyMin = pixelShaderConstantsFDirty ? 0 : FRAGMENT_UNIFORM_VECTORS;
 			}
 			else
 			{
@@ -758,13 +732,14 @@ namespace es2
 		{
 			if(vertexShader)
 			{
-				if(vertexShaderConstantsFDirty)
+				if(vertexShaderConstantsFDirty > vertexShaderConstantsFDirtyMin)
 				{
-					Renderer::setVertexShaderConstantF(0, vertexShaderConstantF[0], vertexShaderConstantsFDirty);
+					Renderer::setVertexShaderConstantF(vertexShaderConstantsFDirtyMin, vertexShaderConstantF[vertexShaderConstantsFDirtyMin], vertexShaderConstantsFDirty - vertexShaderConstantsFDirtyMin);
 				}
 
 				Renderer::setVertexShader(vertexShader);   // Loads shader constants set with DEF
 				vertexShaderConstantsFDirty = vertexShader->dirtyConstantsF;   // Shader DEF'ed constants are dirty
+				vertexShaderConstantsFDirtyMin = vertexShaderConstantsFDirty ? 0 : VERTEX_UNIFORM_VECTORS;
 			}
 			else
 			{
@@ -84,8 +84,10 @@ namespace es2
 		sw::VertexShader *vertexShader;
 
 		bool pixelShaderDirty;
+		unsigned int pixelShaderConstantsFDirtyMin;
 		unsigned int pixelShaderConstantsFDirty;
 		bool vertexShaderDirty;
+		unsigned int vertexShaderConstantsFDirtyMin;
 		unsigned int vertexShaderConstantsFDirty;
 
 		float pixelShaderConstantF[sw::FRAGMENT_UNIFORM_VECTORS][4];
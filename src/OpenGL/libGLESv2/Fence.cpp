@@ -17,7 +17,7 @@
 #include "Fence.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
+#include "Common/Resource.hpp"
 
 namespace es2
 {
@@ -27,6 +27,7 @@ Fence::Fence()
 	mQuery = false;
 	mCondition = GL_NONE;
 	mStatus = GL_FALSE;
+	mFence = 0;
 }
 
 Fence::~Fence()
@@ -41,7 +42,7 @@ GLboolean Fence::isFence()
 	return mQuery;
 }
 
-void Fence::setFence(GLenum condition)
+void Fence::setFence(GLenum condition, int64_t fence)
 {
 	if(condition != GL_ALL_COMPLETED_NV)
 	{
@@ -51,6 +52,7 @@ void Fence::setFence(GLenum condition)
 	mQuery = true;
 	mCondition = condition;
 	mStatus = GL_FALSE;
+	mFence = fence;
 }
 
 GLboolean Fence::testFence()
@@ -60,10 +62,10 @@ GLboolean Fence::testFence()
 		return error(GL_INVALID_OPERATION, GL_TRUE);
 	}
 
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	mStatus = GL_TRUE;
+	if(!mStatus)
+	{
+		mStatus = sw::Timeline::retired(mFence) ? GL_TRUE : GL_FALSE;
+	}
 
 	return mStatus;
 }
@@ -75,10 +77,8 @@ void Fence::finishFence()
 		return error(GL_INVALID_OPERATION);
 	}
 
-	while(!testFence())
-	{
-		sw::Thread::yield();
-	}
+	sw::Timeline::wait(mFence);
+	mStatus = GL_TRUE;
 }
 
 void Fence::getFenceiv(GLenum pname, GLint *params)
@@ -115,7 +115,7 @@ void Fence::getFenceiv(GLenum pname, GLint *params)
 	}
 }
 
-FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags) : NamedObject(name), mCondition(condition), mFlags(flags)
+FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags, int64_t fence, const Context *context) : NamedObject(name), mCondition(condition), mFlags(flags), mFence(fence), mContext(context)
 {
 }
 
@@ -125,11 +125,30 @@ FenceSync::~FenceSync()
 
 GLenum FenceSync::clientWait(GLbitfield flags, GLuint64 timeout)
 {
-	return GL_TRUE;
+	if(isSignaled())
+	{
+		return GL_ALREADY_SIGNALED;
+	}
+
+	// Commands are processed as soon as they're issued, so GL_SYNC_FLUSH_COMMANDS_BIT needs no action
+	return sw::Timeline::wait(mFence, timeout) ? GL_CONDITION_SATISFIED : GL_TIMEOUT_EXPIRED;
 }
 
 void FenceSync::serverWait(GLbitfield flags, GLuint64 timeout)
 {
+	Context *context = getContext();
+
+	// Draws of the same context are already ordered after the fence. Those of other
+	// contexts get held back by the renderer, without blocking this thread.
+	if(context && context != mContext)
+	{
+		context->serverWaitFence(mFence);
+	}
+}
+
+bool FenceSync::isSignaled() const
+{
+	return sw::Timeline::retired(mFence);
 }
 
 }
@@ -23,6 +23,8 @@
 namespace es2
 {
 
+class Context;
+
 class Fence
 {
 public:
@@ -30,7 +32,7 @@ public:
 	virtual ~Fence();
 
 	GLboolean isFence();
-	void setFence(GLenum condition);
+	void setFence(GLenum condition, int64_t fence);
 	GLboolean testFence();
 	void finishFence();
 	void getFenceiv(GLenum pname, GLint *params);
@@ -39,16 +41,18 @@ private:
 	bool mQuery;
 	GLenum mCondition;
 	GLboolean mStatus;
+	int64_t mFence;   // Renderer serial of the last work preceding the fence
 };
 
 class FenceSync : public gl::NamedObject
 {
 public:
-	FenceSync(GLuint name, GLenum condition, GLbitfield flags);
+	FenceSync(GLuint name, GLenum condition, GLbitfield flags, int64_t fence, const Context *context);
 	virtual ~FenceSync();
 
 	GLenum clientWait(GLbitfield flags, GLuint64 timeout);
 	void serverWait(GLbitfield flags, GLuint64 timeout);
+	bool isSignaled() const;
 
 	GLenum getCondition() const { return mCondition; }
 	GLbitfield getFlags() const { return mFlags; }
@@ -56,6 +60,8 @@ public:
 private:
 	GLenum mCondition;
 	GLbitfield mFlags;
+	int64_t mFence;
+	const Context *mContext;   // Creator, whose later draws are already ordered after the fence
 };
 
 }
@@ -310,6 +310,11 @@ GLenum Framebuffer::completeness(int &width, int &height, int &samples)
 	height = -1;
 	samples = -1;
 
+	if(isDefaultFramebuffer() && getColorbuffer(0)->getWidth() == 0)
+	{
+		return GL_FRAMEBUFFER_UNDEFINED_OES;   // Context made current without a surface
+	}
+
 	for(int i = 0; i < MAX_COLOR_ATTACHMENTS; i++)
 	{
 		if(mColorbufferType[i] != GL_NONE)
@@ -19,13 +19,60 @@
 
 #include "Buffer.h"
 #include "common/debug.h"
+#include "Common/CPUID.hpp"
 
 #include <string.h>
 #include <algorithm>
 
+#include <emmintrin.h>
+
 namespace
 {
 	enum { INITIAL_INDEX_BUFFER_SIZE = 4096 * sizeof(GLuint) };
+
+	// SSE2 only has unsigned minimum and maximum for bytes, and signed ones for shorts.
+	// Wider unsigned comparisons flip the sign bits so that signed ones can be used.
+	__m128i Broadcast(GLubyte x) { return _mm_set1_epi8((char)x); }
+	__m128i Broadcast(GLushort x) { return _mm_set1_epi16((short)x); }
+	__m128i Broadcast(GLuint x) { return _mm_set1_epi32((int)x); }
+
+	template<class IndexType> __m128i Min(__m128i x, __m128i y);
+	template<class IndexType> __m128i Max(__m128i x, __m128i y);
+	template<class IndexType> __m128i Add(__m128i x, __m128i y);
+
+	template<> __m128i Min<GLubyte>(__m128i x, __m128i y) { return _mm_min_epu8(x, y); }
+	template<> __m128i Max<GLubyte>(__m128i x, __m128i y) { return _mm_max_epu8(x, y); }
+	template<> __m128i Add<GLubyte>(__m128i x, __m128i y) { return _mm_add_epi8(x, y); }
+
+	template<> __m128i Min<GLushort>(__m128i x, __m128i y)
+	{
+		const __m128i sign = _mm_set1_epi16((short)0x8000);
+		return _mm_xor_si128(_mm_min_epi16(_mm_xor_si128(x, sign), _mm_xor_si128(y, sign)), sign);
+	}
+
+	template<> __m128i Max<GLushort>(__m128i x, __m128i y)
+	{
+		const __m128i sign = _mm_set1_epi16((short)0x8000);
+		return _mm_xor_si128(_mm_max_epi16(_mm_xor_si128(x, sign), _mm_xor_si128(y, sign)), sign);
+	}
+
+	template<> __m128i Add<GLushort>(__m128i x, __m128i y) { return _mm_add_epi16(x, y); }
+
+	template<> __m128i Min<GLuint>(__m128i x, __m128i y)
+	{
+		const __m128i sign = _mm_set1_epi32(0x80000000);
+		__m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(x, sign), _mm_xor_si128(y, sign));
+		return _mm_or_si128(_mm_and_si128(greater, y), _mm_andnot_si128(greater, x));
+	}
+
+	template<> __m128i Max<GLuint>(__m128i x, __m128i y)
+	{
+		const __m128i sign = _mm_set1_epi32(0x80000000);
+		__m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(x, sign), _mm_xor_si128(y, sign));
+		return _mm_or_si128(_mm_and_si128(greater, x), _mm_andnot_si128(greater, y));
+	}
+
+	template<> __m128i Add<GLuint>(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
 }
 
 namespace es2
@@ -63,37 +110,111 @@ void copyIndices(GLenum type, const void *input, GLsizei count, void *output)
 	else UNREACHABLE(type);
 }
 
+// With primitive restart enabled, the restart index (all ones) does not reference a vertex. Incrementing
+// wraps it around to zero, so the maximum of the incremented indices is one past the largest other index.
 template<class IndexType>
-void computeRange(const IndexType *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex)
+void computeRange(const IndexType *indices, GLsizei count, bool primitiveRestart, GLuint *minIndex, GLuint *maxIndex)
 {
-	*minIndex = indices[0];
-	*maxIndex = indices[0];
+	IndexType minimum = indices[0];
+	IndexType maximum = indices[0];
+	IndexType restartMaximum = 0;
 
-	for(GLsizei i = 0; i < count; i++)
+	GLsizei i = 0;
+
+	if(sw::CPUID::supportsSSE2())
+	{
+		const int lanes = 16 / sizeof(IndexType);
+
+		// Align to 16 bytes, since the indices are in a buffer the application owns
+		for(; i < count && ((intptr_t)(indices + i) & 15) != 0; i++)
+		{
+			minimum = std::min(minimum, indices[i]);
+			maximum = std::max(maximum, indices[i]);
+			restartMaximum = std::max(restartMaximum, (IndexType)(indices[i] + 1));
+		}
+
+		if(count - i >= lanes)
+		{
+			__m128i vmin = Broadcast(minimum);
+			__m128i vmax = Broadcast(maximum);
+			__m128i vrestart = Broadcast(restartMaximum);
+			const __m128i one = Broadcast((IndexType)1);
+
+			for(; i + lanes <= count; i += lanes)
+			{
+				__m128i v = _mm_load_si128((const __m128i*)(indices + i));
+
+				vmin = Min<IndexType>(vmin, v);
+				vmax = Max<IndexType>(vmax, v);
+
+				if(primitiveRestart)
+				{
+					vrestart = Max<IndexType>(vrestart, Add<IndexType>(v, one));
+				}
+			}
+
+			IndexType lane[3][lanes];
+			_mm_storeu_si128((__m128i*)lane[0], vmin);
+			_mm_storeu_si128((__m128i*)lane[1], vmax);
+			_mm_storeu_si128((__m128i*)lane[2], vrestart);
+
+			for(int j = 0; j < lanes; j++)
+			{
+				minimum = std::min(minimum, lane[0][j]);
+				maximum = std::max(maximum, lane[1][j]);
+				restartMaximum = std::max(restartMaximum, lane[2][j]);
+			}
+		}
+	}
+
+	for(; i < count; i++)
 	{
-		if(*minIndex > indices[i]) *minIndex = indices[i];
-		if(*maxIndex < indices[i]) *maxIndex = indices[i];
+		minimum = std::min(minimum, indices[i]);
+		maximum = std::max(maximum, indices[i]);
+		restartMaximum = std::max(restartMaximum, (IndexType)(indices[i] + 1));
 	}
+
+	const IndexType restartIndex = (IndexType)~0;
+
+	if(primitiveRestart && maximum == restartIndex)
+	{
+		if(restartMaximum == 0)   // Only restart indices, so no vertices are referenced
+		{
+			*minIndex = 0;
+			*maxIndex = 0;
+			return;
+		}
+
+		maximum = restartMaximum - 1;
+	}
+
+	*minIndex = minimum;
+	*maxIndex = maximum;
 }
 
-void computeRange(GLenum type, const void *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex)
+void computeRange(GLenum type, const void *indices, GLsizei count, bool primitiveRestart, GLuint *minIndex, GLuint *maxIndex)
 {
-	if(type == GL_UNSIGNED_BYTE)
+	if(count == 0)
+	{
+		*minIndex = 0;
+		*maxIndex = 0;
+	}
+	else if(type == GL_UNSIGNED_BYTE)
 	{
-		computeRange(static_cast<const GLubyte*>(indices), count, minIndex, maxIndex);
+		computeRange(static_cast<const GLubyte*>(indices), count, primitiveRestart, minIndex, maxIndex);
 	}
 	else if(type == GL_UNSIGNED_INT)
 	{
-		computeRange(static_cast<const GLuint*>(indices), count, minIndex, maxIndex);
+		computeRange(static_cast<const GLuint*>(indices), count, primitiveRestart, minIndex, maxIndex);
 	}
 	else if(type == GL_UNSIGNED_SHORT)
 	{
-		computeRange(static_cast<const GLushort*>(indices), count, minIndex, maxIndex);
+		computeRange(static_cast<const GLushort*>(indices), count, primitiveRestart, minIndex, maxIndex);
 	}
 	else UNREACHABLE(type);
 }
 
-GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *buffer, const void *indices, TranslatedIndexData *translated)
+GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, bool primitiveRestart, Buffer *buffer, const void *indices, TranslatedIndexData *translated)
 {
 	if(!mStreamingBuffer)
 	{
@@ -118,7 +239,11 @@ GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end,
 
 	if(staticBuffer)
 	{
-		computeRange(type, indices, count, &translated->minIndex, &translated->maxIndex);
+		if(!buffer->getIndexRange(type, offset, count, primitiveRestart, &translated->minIndex, &translated->maxIndex))
+		{
+			computeRange(type, indices, count, primitiveRestart, &translated->minIndex, &translated->maxIndex);
+			buffer->setIndexRange(type, offset, count, primitiveRestart, translated->minIndex, translated->maxIndex);
+		}
 
 		translated->indexBuffer = staticBuffer;
 		translated->indexOffset = offset;
@@ -140,7 +265,7 @@ GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end,
 		copyIndices(type, staticBuffer ? buffer->data() : indices, convertCount, output);
 		streamingBuffer->unmap();
 
-		computeRange(type, indices, count, &translated->minIndex, &translated->maxIndex);
+		computeRange(type, indices, count, primitiveRestart, &translated->minIndex, &translated->maxIndex);
 
 		translated->indexBuffer = streamingBuffer->getResource();
 		translated->indexOffset = streamOffset;
@@ -165,94 +290,37 @@ std::size_t IndexDataManager::typeSize(GLenum type)
 	}
 }
 
-StreamingIndexBuffer::StreamingIndexBuffer(unsigned int initialSize) : mIndexBuffer(NULL), mBufferSize(initialSize)
+StreamingIndexBuffer::StreamingIndexBuffer(unsigned int initialSize) : mRing(initialSize)
 {
-	if(initialSize > 0)
-	{
-		mIndexBuffer = new sw::Resource(initialSize + 16);
-
-		if(!mIndexBuffer)
-		{
-			ERR("Out of memory allocating an index buffer of size %u.", initialSize);
-		}
-	}
-
-	mWritePosition = 0;
 }
 
 StreamingIndexBuffer::~StreamingIndexBuffer()
 {
-	if(mIndexBuffer)
-	{
-		mIndexBuffer->destruct();
-	}
 }
 
 void *StreamingIndexBuffer::map(unsigned int requiredSpace, unsigned int *offset)
 {
-	void *mapPtr = NULL;
-
-	if(mIndexBuffer)
-	{
-		mapPtr = (char*)mIndexBuffer->lock(sw::PUBLIC) + mWritePosition;
-
-		if(!mapPtr)
-		{
-			ERR(" Lock failed");
-			return NULL;
-		}
+	size_t streamOffset = 0;
+	void *mapPtr = mRing.map(requiredSpace, &streamOffset);
 
-		*offset = mWritePosition;
-		mWritePosition += requiredSpace;
-	}
+	*offset = (unsigned int)streamOffset;
 
 	return mapPtr;
 }
 
 void StreamingIndexBuffer::unmap()
 {
-	if(mIndexBuffer)
-	{
-		mIndexBuffer->unlock();
-	}
+	mRing.unmap();
 }
 
 void StreamingIndexBuffer::reserveSpace(unsigned int requiredSpace, GLenum type)
 {
-	if(requiredSpace > mBufferSize)
-	{
-		if(mIndexBuffer)
-		{
-			mIndexBuffer->destruct();
-			mIndexBuffer = 0;
-		}
-
-		mBufferSize = std::max(requiredSpace, 2 * mBufferSize);
-
-		mIndexBuffer = new sw::Resource(mBufferSize + 16);
-
-		if(!mIndexBuffer)
-		{
-			ERR("Out of memory allocating an index buffer of size %u.", mBufferSize);
-		}
-
-		mWritePosition = 0;
-	}
-	else if(mWritePosition + requiredSpace > mBufferSize)   // Recycle
-	{
-		if(mIndexBuffer)
-		{
-			mIndexBuffer->destruct();
-			mIndexBuffer = new sw::Resource(mBufferSize + 16);
-		}
-
-		mWritePosition = 0;
-	}
+	mRing.reserve(requiredSpace);
 }
 
 sw::Resource *StreamingIndexBuffer::getResource() const
 {
-	return mIndexBuffer;
+	return mRing.getResource();
 }
 
 }
@@ -19,6 +19,7 @@
 #define LIBGLESV2_INDEXDATAMANAGER_H_
 
 #include "Context.h"
+#include "Common/ResourceRing.hpp"
 
 #include <GLES2/gl2.h>
 
@@ -47,9 +48,7 @@ public:
 	sw::Resource *getResource() const;
 
 private:
-	sw::Resource *mIndexBuffer;
-	unsigned int mBufferSize;
-	unsigned int mWritePosition;
+	sw::ResourceRing mRing;
 };
 
 class IndexDataManager
@@ -58,7 +57,7 @@ public:
 	IndexDataManager();
 	virtual ~IndexDataManager();
 
-	GLenum prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *arrayElementBuffer, const void *indices, TranslatedIndexData *translated);
+	GLenum prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, bool primitiveRestart, Buffer *arrayElementBuffer, const void *indices, TranslatedIndexData *translated);
 
 	static std::size_t typeSize(GLenum type);
 
@@ -25,6 +25,7 @@
 #include "common/debug.h"
 #include "Shader/PixelShader.hpp"
 #include "Shader/VertexShader.hpp"
+#include "Common/Trace.hpp"
 
 #include <string>
 #include <stdlib.h>
@@ -175,6 +176,7 @@ namespace es2
 
 	Program::~Program()
 	{
+		wait();
 		unlink();
 
 		if(vertexShader)
@@ -482,7 +484,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		int size = targetUniform->size();
 
@@ -572,7 +574,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		if(targetUniform->type != type)
 		{
@@ -669,7 +671,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		int size = targetUniform->size();
 
@@ -726,7 +728,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		int size = targetUniform->size();
 
@@ -788,7 +790,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		int size = targetUniform->size();
 
@@ -845,7 +847,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		markUniformDirty(location);
 
 		int size = targetUniform->size();
 
@@ -1057,86 +1059,74 @@ namespace es2
 
 	void Program::dirtyAllUniforms()
 	{
+		dirtyUniforms.clear();
+
 		size_t numUniforms = uniforms.size();
 		for(size_t index = 0; index < numUniforms; index++)
 		{
-			uniforms[index]->dirty = true;
+			uniforms[index]->dirty = false;
 		}
-	}
 
-	// Applies all the uniforms set for this program object to the device
-	void Program::applyUniforms()
-	{
-		GLint numUniforms = uniformIndex.size();
-		for(GLint location = 0; location < numUniforms; location++)
+		GLint numLocations = uniformIndex.size();
+		for(GLint location = 0; location < numLocations; location++)
 		{
-			if(uniformIndex[location].element != 0)
+			if(uniformIndex[location].element == 0)
 			{
-				continue;
+				markUniformDirty(location);
 			}
+		}
+	}
 
-			Uniform *targetUniform = uniforms[uniformIndex[location].index];
+	// Queues a uniform for upload by the next applyUniforms()
+	void Program::markUniformDirty(GLint location)
+	{
+		unsigned int index = uniformIndex[location].index;
+		Uniform *targetUniform = uniforms[index];
 
-			if(targetUniform->dirty && (targetUniform->blockInfo.index == -1))
-			{
-				GLsizei size = targetUniform->size();
-				GLfloat *f = (GLfloat*)targetUniform->data;
-				GLint *i = (GLint*)targetUniform->data;
-				GLuint *ui = (GLuint*)targetUniform->data;
-				GLboolean *b = (GLboolean*)targetUniform->data;
+		if(!targetUniform->dirty && (targetUniform->blockInfo.index == -1))
+		{
+			targetUniform->dirty = true;
+			dirtyUniforms.push_back(index);
+		}
+	}
 
-				switch(targetUniform->type)
-				{
-				case GL_BOOL:       applyUniform1bv(location, size, b);       break;
-				case GL_BOOL_VEC2:  applyUniform2bv(location, size, b);       break;
-				case GL_BOOL_VEC3:  applyUniform3bv(location, size, b);       break;
-				case GL_BOOL_VEC4:  applyUniform4bv(location, size, b);       break;
-				case GL_FLOAT:      applyUniform1fv(location, size, f);       break;
-				case GL_FLOAT_VEC2: applyUniform2fv(location, size, f);       break;
-				case GL_FLOAT_VEC3: applyUniform3fv(location, size, f);       break;
-				case GL_FLOAT_VEC4: applyUniform4fv(location, size, f);       break;
-				case GL_FLOAT_MAT2:   applyUniformMatrix2fv(location, size, f);   break;
-				case GL_FLOAT_MAT2x3: applyUniformMatrix2x3fv(location, size, f); break;
-				case GL_FLOAT_MAT2x4: applyUniformMatrix2x4fv(location, size, f); break;
-				case GL_FLOAT_MAT3x2: applyUniformMatrix3x2fv(location, size, f); break;
-				case GL_FLOAT_MAT3:   applyUniformMatrix3fv(location, size, f);   break;
-				case GL_FLOAT_MAT3x4: applyUniformMatrix3x4fv(location, size, f); break;
-				case GL_FLOAT_MAT4x2: applyUniformMatrix4x2fv(location, size, f); break;
-				case GL_FLOAT_MAT4x3: applyUniformMatrix4x3fv(location, size, f); break;
-				case GL_FLOAT_MAT4:   applyUniformMatrix4fv(location, size, f);   break;
-				case GL_SAMPLER_2D:
-				case GL_SAMPLER_CUBE:
-				case GL_SAMPLER_EXTERNAL_OES:
-				case GL_SAMPLER_3D_OES:
-				case GL_SAMPLER_2D_ARRAY:
-				case GL_SAMPLER_2D_SHADOW:
-				case GL_SAMPLER_CUBE_SHADOW:
-				case GL_SAMPLER_2D_ARRAY_SHADOW:
-				case GL_INT_SAMPLER_2D:
-				case GL_UNSIGNED_INT_SAMPLER_2D:
-				case GL_INT_SAMPLER_CUBE:
-				case GL_UNSIGNED_INT_SAMPLER_CUBE:
-				case GL_INT_SAMPLER_3D:
-				case GL_UNSIGNED_INT_SAMPLER_3D:
-				case GL_INT_SAMPLER_2D_ARRAY:
-				case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
-				case GL_INT:        applyUniform1iv(location, size, i);       break;
-				case GL_INT_VEC2:   applyUniform2iv(location, size, i);       break;
-				case GL_INT_VEC3:   applyUniform3iv(location, size, i);       break;
-				case GL_INT_VEC4:   applyUniform4iv(location, size, i);       break;
-				case GL_UNSIGNED_INT:      applyUniform1uiv(location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC2: applyUniform2uiv(location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC3: applyUniform3uiv(location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC4: applyUniform4uiv(location, size, ui); break;
-				default:
-					UNREACHABLE(targetUniform->type);
-				}
+	// Determines how each default block uniform's data maps onto constant registers,
+	// so that applying it doesn't have to decode its type again
+	void Program::planUniformUploads()
+	{
+		uniformUploads.clear();
 
-				targetUniform->dirty = false;
-			}
+		for(size_t index = 0; index < uniforms.size(); index++)
+		{
+			const Uniform *uniform = uniforms[index];
+			UniformUpload upload;
+
+			upload.data = uniform->data;
+			upload.psRegisterIndex = uniform->psRegisterIndex;
+			upload.vsRegisterIndex = uniform->vsRegisterIndex;
+			upload.registerCount = uniform->registerCount();
+			upload.sampler = IsSamplerUniform(uniform->type);
+			upload.registerSize = upload.sampler ? 1 : VariableRegisterSize(uniform->type);
+			upload.boolean = (UniformComponentType(uniform->type) == GL_BOOL);
+
+			uniformUploads.push_back(upload);
 		}
 	}
 
+	// Applies the uniforms modified since the last call to the device
+	void Program::applyUniforms()
+	{
+		for(size_t i = 0; i < dirtyUniforms.size(); i++)
+		{
+			unsigned int index = dirtyUniforms[i];
+
+			applyUniform(uniformUploads[index]);
+			uniforms[index]->dirty = false;
+		}
+
+		dirtyUniforms.clear();
+	}
+
 	void Program::applyUniformBuffers(BufferBinding* uniformBuffers)
 	{
 		GLint vertexUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
@@ -1220,6 +1210,7 @@ namespace es2
 				int nbComponentsPerReg = rowCount > 1 ? rowCount : colCount;
 				int componentStride = rowCount * colCount * size;
 				int baseOffset = transformFeedback->vertexOffset() * componentStride * sizeof(float);
+				transformFeedbackBuffers[index].get()->deviceWrite();
 				device->VertexProcessor::setTransformFeedbackBuffer(index,
 					transformFeedbackBuffers[index].get()->getResource(),
 					transformFeedbackBuffers[index].getOffset() + baseOffset,
@@ -1235,6 +1226,7 @@ namespace es2
 			// In INTERLEAVED_ATTRIBS mode, the values of one or more output variables
 			// written by a vertex shader are written, interleaved, into the buffer object
 			// bound to the first transform feedback binding point (index = 0).
+			transformFeedbackBuffers[0].get()->deviceWrite();
 			sw::Resource* resource = transformFeedbackBuffers[0].get()->getResource();
 			int componentStride = totalLinkedVaryingsComponents;
 			int baseOffset = transformFeedbackBuffers[0].getOffset() + (transformFeedback->vertexOffset() * componentStride * sizeof(float));
@@ -1447,11 +1439,62 @@ namespace es2
 		return true;
 	}
 
+	// Schedules the link on a worker thread. It waits for the attached shaders to
+	// finish compiling, and GL calls which use the program wait for the link.
+	void Program::link()
+	{
+		std::shared_ptr<Task> vertexCompile = vertexShader ? vertexShader->compileTask : nullptr;
+		std::shared_ptr<Task> fragmentCompile = fragmentShader ? fragmentShader->compileTask : nullptr;
+		GLint clientVersion = egl::getClientVersion();
+
+		linkTask = TaskQueue::schedule([=]()
+		{
+			if(vertexCompile)
+			{
+				vertexCompile->wait();
+			}
+
+			if(fragmentCompile)
+			{
+				fragmentCompile->wait();
+			}
+
+			linkShaders(clientVersion);
+		});
+
+		// Recompiling or deleting the shaders has to wait until they're no longer read
+		if(vertexShader)
+		{
+			vertexShader->addLink(linkTask);
+		}
+
+		if(fragmentShader)
+		{
+			fragmentShader->addLink(linkTask);
+		}
+	}
+
+	bool Program::isLinkComplete()
+	{
+		return !linkTask || linkTask->isComplete();
+	}
+
+	void Program::wait()
+	{
+		// The task is kept after completing, as other threads of the share group may be waiting on it or polling it
+		if(linkTask)
+		{
+			linkTask->wait();
+		}
+	}
+
 	// Links the code of the vertex and pixel shader by matching up their varyings,
 	// compiling them into binaries, determining the attribute mappings, and collecting
 	// a list of uniforms
-	void Program::link()
+	void Program::linkShaders(GLint clientVersion)
 	{
+		sw::TraceScope scope("Program::link");
+
 		unlink();
 
 		resetUniformBlockBindings();
@@ -1474,7 +1517,7 @@ namespace es2
 			return;
 		}
 
-		if(!linkAttributes())
+		if(!linkAttributes(clientVersion))
 		{
 			return;
 		}
@@ -1500,11 +1543,14 @@ namespace es2
 			return;
 		}
 
+		planUniformUploads();
+		dirtyAllUniforms();
+
 		linked = true;   // Success
 	}
 
 	// Determines the mapping between GL attributes and vertex stream usage indices
-	bool Program::linkAttributes()
+	bool Program::linkAttributes(GLint clientVersion)
 	{
 		unsigned int usedLocations = 0;
 
@@ -1525,7 +1571,7 @@ namespace es2
 
 				// In GLSL 3.00, attribute aliasing produces a link error
 				// In GLSL 1.00, attribute aliasing is allowed
-				if(egl::getClientVersion() >= 3)
+				if(clientVersion >= 3)
 				{
 					for(int i = 0; i < rows; i++)
 					{
@@ -1899,299 +1945,17 @@ namespace es2
 		return true;
 	}
 
-	bool Program::applyUniform(GLint location, float* data)
-	{
-		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-
-		if(targetUniform->psRegisterIndex != -1)
-		{
-			device->setPixelShaderConstantF(targetUniform->psRegisterIndex, data, targetUniform->registerCount());
-		}
-
-		if(targetUniform->vsRegisterIndex != -1)
-		{
-			device->setVertexShaderConstantF(targetUniform->vsRegisterIndex, data, targetUniform->registerCount());
-		}
-
-		return true;
-	}
-
-	bool Program::applyUniform1bv(GLint location, GLsizei count, const GLboolean *v)
-	{
-		int vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = (v[0] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][1] = 0;
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 1;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform2bv(GLint location, GLsizei count, const GLboolean *v)
-	{
-		int vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = (v[0] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][1] = (v[1] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 2;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform3bv(GLint location, GLsizei count, const GLboolean *v)
-	{
-		int vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = (v[0] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][1] = (v[1] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][2] = (v[2] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][3] = 0;
-
-			v += 3;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform4bv(GLint location, GLsizei count, const GLboolean *v)
-	{
-		int vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = (v[0] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][1] = (v[1] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][2] = (v[2] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-			vector[i][3] = (v[3] == GL_FALSE ? 0x00000000 : 0xFFFFFFFF);
-
-			v += 4;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform1fv(GLint location, GLsizei count, const GLfloat *v)
-	{
-		float vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = 0;
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 1;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform2fv(GLint location, GLsizei count, const GLfloat *v)
-	{
-		float vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 2;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform3fv(GLint location, GLsizei count, const GLfloat *v)
-	{
-		float vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = v[2];
-			vector[i][3] = 0;
-
-			v += 3;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform4fv(GLint location, GLsizei count, const GLfloat *v)
-	{
-		return applyUniform(location, (float*)v);
-	}
-
-	bool Program::applyUniformMatrix2fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 1) / 2][2][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = 0; matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[2];	matrix[i][1][1] = value[3];	matrix[i][1][2] = 0; matrix[i][1][3] = 0;
-
-			value += 4;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix2x3fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 1) / 2][2][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = value[2]; matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[3];	matrix[i][1][1] = value[4];	matrix[i][1][2] = value[5]; matrix[i][1][3] = 0;
-
-			value += 6;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix2x4fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 1) / 2][2][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = value[2]; matrix[i][0][3] = value[3];
-			matrix[i][1][0] = value[4];	matrix[i][1][1] = value[5];	matrix[i][1][2] = value[6]; matrix[i][1][3] = value[7];
-
-			value += 8;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix3fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 2) / 3][3][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = value[2];	matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[3];	matrix[i][1][1] = value[4];	matrix[i][1][2] = value[5];	matrix[i][1][3] = 0;
-			matrix[i][2][0] = value[6];	matrix[i][2][1] = value[7];	matrix[i][2][2] = value[8];	matrix[i][2][3] = 0;
-
-			value += 9;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix3x2fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 2) / 3][3][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = 0; matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[2];	matrix[i][1][1] = value[3];	matrix[i][1][2] = 0; matrix[i][1][3] = 0;
-			matrix[i][2][0] = value[4];	matrix[i][2][1] = value[5];	matrix[i][2][2] = 0; matrix[i][2][3] = 0;
-
-			value += 6;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix3x4fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 2) / 3][3][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = value[2]; 	matrix[i][0][3] = value[3];
-			matrix[i][1][0] = value[4];	matrix[i][1][1] = value[5];	matrix[i][1][2] = value[6]; 	matrix[i][1][3] = value[7];
-			matrix[i][2][0] = value[8];	matrix[i][2][1] = value[9];	matrix[i][2][2] = value[10];	matrix[i][2][3] = value[11];
-
-			value += 12;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix4fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		return applyUniform(location, (float*)value);
-	}
-
-	bool Program::applyUniformMatrix4x2fv(GLint location, GLsizei count, const GLfloat *value)
-	{
-		float matrix[(MAX_UNIFORM_VECTORS + 3) / 4][4][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];	matrix[i][0][2] = 0; matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[2];	matrix[i][1][1] = value[3];	matrix[i][1][2] = 0; matrix[i][1][3] = 0;
-			matrix[i][2][0] = value[4];	matrix[i][2][1] = value[5];	matrix[i][2][2] = 0; matrix[i][2][3] = 0;
-			matrix[i][3][0] = value[6];	matrix[i][3][1] = value[7];	matrix[i][3][2] = 0; matrix[i][3][3] = 0;
-
-			value += 8;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniformMatrix4x3fv(GLint location, GLsizei count, const GLfloat *value)
+	void Program::applyUniform(const UniformUpload &upload)
 	{
-		float matrix[(MAX_UNIFORM_VECTORS + 3) / 4][4][4];
-
-		for(int i = 0; i < count; i++)
+		if(upload.sampler)
 		{
-			matrix[i][0][0] = value[0];	matrix[i][0][1] = value[1];  matrix[i][0][2] = value[2];  matrix[i][0][3] = 0;
-			matrix[i][1][0] = value[3];	matrix[i][1][1] = value[4];  matrix[i][1][2] = value[5];  matrix[i][1][3] = 0;
-			matrix[i][2][0] = value[6];	matrix[i][2][1] = value[7];  matrix[i][2][2] = value[8];  matrix[i][2][3] = 0;
-			matrix[i][3][0] = value[9];	matrix[i][3][1] = value[10]; matrix[i][3][2] = value[11]; matrix[i][3][3] = 0;
+			const GLint *v = (const GLint*)upload.data;
 
-			value += 12;
-		}
-
-		return applyUniform(location, (float*)matrix);
-	}
-
-	bool Program::applyUniform1iv(GLint location, GLsizei count, const GLint *v)
-	{
-		GLint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[i];
-			vector[i][1] = 0;
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-		}
-
-		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		if(IsSamplerUniform(targetUniform->type))
-		{
-			if(targetUniform->psRegisterIndex != -1)
+			if(upload.psRegisterIndex != -1)
 			{
-				for(int i = 0; i < count; i++)
+				for(int i = 0; i < upload.registerCount; i++)
 				{
-					unsigned int samplerIndex = targetUniform->psRegisterIndex + i;
+					unsigned int samplerIndex = upload.psRegisterIndex + i;
 
 					if(samplerIndex < MAX_TEXTURE_IMAGE_UNITS)
 					{
@@ -2201,11 +1965,11 @@ namespace es2
 				}
 			}
 
-			if(targetUniform->vsRegisterIndex != -1)
+			if(upload.vsRegisterIndex != -1)
 			{
-				for(int i = 0; i < count; i++)
+				for(int i = 0; i < upload.registerCount; i++)
 				{
-					unsigned int samplerIndex = targetUniform->vsRegisterIndex + i;
+					unsigned int samplerIndex = upload.vsRegisterIndex + i;
 
 					if(samplerIndex < MAX_VERTEX_TEXTURE_IMAGE_UNITS)
 					{
@@ -2214,166 +1978,49 @@ namespace es2
 					}
 				}
 			}
-		}
-		else
-		{
-			return applyUniform(location, (float*)vector);
-		}
 
-		return true;
-	}
-
-	bool Program::applyUniform2iv(GLint location, GLsizei count, const GLint *v)
-	{
-		GLint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 2;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform3iv(GLint location, GLsizei count, const GLint *v)
-	{
-		GLint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = v[2];
-			vector[i][3] = 0;
-
-			v += 3;
-		}
-
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform4iv(GLint location, GLsizei count, const GLint *v)
-	{
-		GLint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = v[2];
-			vector[i][3] = v[3];
-
-			v += 4;
+			return;
 		}
 
-		return applyUniform(location, (float*)vector);
-	}
+		const float *constants = (const float*)upload.data;
+		unsigned int vector[MAX_UNIFORM_VECTORS][4];
 
-	bool Program::applyUniform1uiv(GLint location, GLsizei count, const GLuint *v)
-	{
-		GLuint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
+		if(upload.registerSize < 4 || upload.boolean)   // Pad each register to four components
 		{
-			vector[i][0] = v[i];
-			vector[i][1] = 0;
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-		}
+			const unsigned int *v = (const unsigned int*)upload.data;
+			const GLboolean *b = (const GLboolean*)upload.data;
 
-		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		if(IsSamplerUniform(targetUniform->type))
-		{
-			if(targetUniform->psRegisterIndex != -1)
+			for(int i = 0; i < upload.registerCount; i++)
 			{
-				for(int i = 0; i < count; i++)
+				for(int j = 0; j < 4; j++)
 				{
-					unsigned int samplerIndex = targetUniform->psRegisterIndex + i;
-
-					if(samplerIndex < MAX_TEXTURE_IMAGE_UNITS)
+					if(j >= upload.registerSize)
 					{
-						ASSERT(samplersPS[samplerIndex].active);
-						samplersPS[samplerIndex].logicalTextureUnit = v[i];
+						vector[i][j] = 0;
 					}
-				}
-			}
-
-			if(targetUniform->vsRegisterIndex != -1)
-			{
-				for(int i = 0; i < count; i++)
-				{
-					unsigned int samplerIndex = targetUniform->vsRegisterIndex + i;
-
-					if(samplerIndex < MAX_VERTEX_TEXTURE_IMAGE_UNITS)
+					else if(upload.boolean)
 					{
-						ASSERT(samplersVS[samplerIndex].active);
-						samplersVS[samplerIndex].logicalTextureUnit = v[i];
+						vector[i][j] = (*b++ == GL_FALSE) ? 0x00000000 : 0xFFFFFFFF;
+					}
+					else
+					{
+						vector[i][j] = *v++;
 					}
 				}
 			}
-		}
-		else
-		{
-			return applyUniform(location, (float*)vector);
-		}
-
-		return true;
-	}
 
-	bool Program::applyUniform2uiv(GLint location, GLsizei count, const GLuint *v)
-	{
-		GLuint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
-		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = 0;
-			vector[i][3] = 0;
-
-			v += 2;
+			constants = (const float*)vector;
 		}
 
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform3uiv(GLint location, GLsizei count, const GLuint *v)
-	{
-		GLuint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
+		if(upload.psRegisterIndex != -1)
 		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = v[2];
-			vector[i][3] = 0;
-
-			v += 3;
+			device->setPixelShaderConstantF(upload.psRegisterIndex, constants, upload.registerCount);
 		}
 
-		return applyUniform(location, (float*)vector);
-	}
-
-	bool Program::applyUniform4uiv(GLint location, GLsizei count, const GLuint *v)
-	{
-		GLuint vector[MAX_UNIFORM_VECTORS][4];
-
-		for(int i = 0; i < count; i++)
+		if(upload.vsRegisterIndex != -1)
 		{
-			vector[i][0] = v[0];
-			vector[i][1] = v[1];
-			vector[i][2] = v[2];
-			vector[i][3] = v[3];
-
-			v += 4;
+			device->setVertexShaderConstantF(upload.vsRegisterIndex, constants, upload.registerCount);
 		}
-
-		return applyUniform(location, (float*)vector);
 	}
 
 	void Program::appendToInfoLog(const char *format, ...)
@@ -2457,6 +2104,8 @@ namespace es2
 		}
 
 		uniformIndex.clear();
+		uniformUploads.clear();
+		dirtyUniforms.clear();
 		transformFeedbackLinkedVaryings.clear();
 
 		delete[] infoLog;
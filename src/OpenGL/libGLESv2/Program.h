@@ -70,6 +70,18 @@ namespace es2
 		short vsRegisterIndex;
 	};
 
+	// Link-time plan for copying a default block uniform into constant registers
+	struct UniformUpload
+	{
+		const unsigned char *data;
+		short psRegisterIndex;
+		short vsRegisterIndex;
+		int registerCount;   // Of all the elements
+		int registerSize;    // Packed components per register, padded to four
+		bool boolean;        // GLboolean components become 0 or ~0
+		bool sampler;        // Selects texture units instead of setting constants
+	};
+
 	// Helper struct representing a single shader uniform block
 	struct UniformBlock
 	{
@@ -178,6 +190,8 @@ namespace es2
 
 		void link();
 		bool isLinked() const;
+		bool isLinkComplete();   // Does not wait
+		void wait();
 		size_t getInfoLogLength() const;
 		void getInfoLog(GLsizei bufSize, GLsizei *length, char *infoLog);
 		void getAttachedShaders(GLsizei maxCount, GLsizei *count, GLuint *shaders);
@@ -221,10 +235,11 @@ namespace es2
 		void unlink();
 		void resetUniformBlockBindings();
 
+		void linkShaders(GLint clientVersion);
 		bool linkVaryings();
 		bool linkTransformFeedback();
 
-		bool linkAttributes();
+		bool linkAttributes(GLint clientVersion);
 		int getAttributeBinding(const glsl::Attribute &attribute);
 
 		bool linkUniforms(const Shader *shader);
@@ -232,32 +247,9 @@ namespace es2
 		bool areMatchingUniformBlocks(const glsl::UniformBlock &block1, const glsl::UniformBlock &block2, const Shader *shader1, const Shader *shader2);
 		bool defineUniform(GLenum shader, GLenum type, GLenum precision, const std::string &_name, unsigned int arraySize, int registerIndex, const Uniform::BlockInfo& blockInfo);
 		bool defineUniformBlock(const Shader *shader, const glsl::UniformBlock &block);
-		bool applyUniform(GLint location, float* data);
-		bool applyUniform1bv(GLint location, GLsizei count, const GLboolean *v);
-		bool applyUniform2bv(GLint location, GLsizei count, const GLboolean *v);
-		bool applyUniform3bv(GLint location, GLsizei count, const GLboolean *v);
-		bool applyUniform4bv(GLint location, GLsizei count, const GLboolean *v);
-		bool applyUniform1fv(GLint location, GLsizei count, const GLfloat *v);
-		bool applyUniform2fv(GLint location, GLsizei count, const GLfloat *v);
-		bool applyUniform3fv(GLint location, GLsizei count, const GLfloat *v);
-		bool applyUniform4fv(GLint location, GLsizei count, const GLfloat *v);
-		bool applyUniformMatrix2fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix2x3fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix2x4fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix3fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix3x2fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix3x4fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix4fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix4x2fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniformMatrix4x3fv(GLint location, GLsizei count, const GLfloat *value);
-		bool applyUniform1iv(GLint location, GLsizei count, const GLint *v);
-		bool applyUniform2iv(GLint location, GLsizei count, const GLint *v);
-		bool applyUniform3iv(GLint location, GLsizei count, const GLint *v);
-		bool applyUniform4iv(GLint location, GLsizei count, const GLint *v);
-		bool applyUniform1uiv(GLint location, GLsizei count, const GLuint *v);
-		bool applyUniform2uiv(GLint location, GLsizei count, const GLuint *v);
-		bool applyUniform3uiv(GLint location, GLsizei count, const GLuint *v);
-		bool applyUniform4uiv(GLint location, GLsizei count, const GLuint *v);
+		void markUniformDirty(GLint location);
+		void planUniformUploads();
+		void applyUniform(const UniformUpload &upload);
 
 		bool setUniformfv(GLint location, GLsizei count, const GLfloat *v, int numElements);
 		bool setUniformMatrixfv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value, GLenum type);
@@ -274,6 +266,8 @@ namespace es2
 		FragmentShader *fragmentShader;
 		VertexShader *vertexShader;
 
+		std::shared_ptr<Task> linkTask;   // Most recent link, if any
+
 		sw::PixelShader *pixelBinary;
 		sw::VertexShader *vertexBinary;
 
@@ -301,6 +295,8 @@ namespace es2
 		UniformArray uniforms;
 		typedef std::vector<UniformLocation> UniformIndex;
 		UniformIndex uniformIndex;
+		std::vector<UniformUpload> uniformUploads;   // Indexed like uniforms, built at link time
+		std::vector<unsigned int> dirtyUniforms;     // Indices of modified default block uniforms
 		typedef std::vector<UniformBlock*> UniformBlockArray;
 		UniformBlockArray uniformBlocks;
 		typedef std::vector<LinkedVarying> LinkedVaryingArray;
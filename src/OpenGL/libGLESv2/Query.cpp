@@ -17,7 +17,7 @@
 #include "Query.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
+#include "Common/Resource.hpp"
 
 namespace es2
 {
@@ -65,7 +65,12 @@ void Query::begin()
 	Device *device = getDevice();
 
 	mQuery->begin();
-	device->addQuery(mQuery);
+
+	if(!device->addQuery(mQuery))
+	{
+		return error(GL_OUT_OF_MEMORY);
+	}
+
 	switch(mType)
 	{
 	case GL_ANY_SAMPLES_PASSED_EXT:
@@ -112,10 +117,8 @@ GLuint Query::getResult()
 {
 	if(mQuery)
 	{
-		while(!testQuery())
-		{
-			sw::Thread::yield();
-		}
+		sw::Timeline::wait(mQuery->serial);
+		testQuery();
 	}
 
 	return (GLuint)mResult;
@@ -140,7 +143,7 @@ GLboolean Query::testQuery()
 {
 	if(mQuery != nullptr && mStatus != GL_TRUE)
 	{
-		if(!mQuery->building && mQuery->reference == 0)
+		if(mQuery->available())
 		{
 			unsigned int resultSum = mQuery->data;
 			mStatus = GL_TRUE;
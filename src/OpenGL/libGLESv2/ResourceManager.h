@@ -33,6 +33,7 @@ class Texture;
 class Renderbuffer;
 class Sampler;
 class FenceSync;
+class Context;
 
 enum TextureType
 {
@@ -61,7 +62,7 @@ public:
 	GLuint createTexture();
 	GLuint createRenderbuffer();
 	GLuint createSampler();
-	GLuint createFenceSync(GLenum condition, GLbitfield flags);
+	GLuint createFenceSync(GLenum condition, GLbitfield flags, int64_t fence, const Context *context);
 
 	void deleteBuffer(GLuint buffer);
 	void deleteShader(GLuint shader);
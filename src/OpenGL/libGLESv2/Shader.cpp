@@ -19,8 +19,11 @@
 #include "Shader.h"
 
 #include "main.h"
+#include "ShaderCache.h"
 #include "utilities.h"
+#include "Common/Trace.hpp"
 
+#include <algorithm>
 #include <string>
 
 namespace es2
@@ -155,12 +158,6 @@ void Shader::getSource(GLsizei bufSize, GLsizei *length, char *source)
 
 TranslatorASM *Shader::createCompiler(GLenum shaderType)
 {
-	if(!compilerInitialized)
-	{
-		InitCompilerGlobals();
-		compilerInitialized = true;
-	}
-
 	TranslatorASM *assembler = new TranslatorASM(this, shaderType);
 
 	ShBuiltInResources resources;
@@ -193,14 +190,31 @@ void Shader::clear()
 	varyings.clear();
 	activeUniforms.clear();
 	activeAttributes.clear();
+	activeUniformBlocks.clear();
 }
 
 void Shader::compile()
 {
-	clear();
+	// The previous results may still be in use
+	wait();
+	waitForLinks();
 
-	createShader();
-	TranslatorASM *compiler = createCompiler(getType());
+	if(!compilerInitialized)
+	{
+		InitCompilerGlobals();
+		compilerInitialized = true;
+	}
+
+	GLint clientVersion = es2::getContext()->getClientVersion();
+
+	compileTask = TaskQueue::schedule([this, clientVersion]() { compileShader(clientVersion); });
+}
+
+void Shader::compileShader(GLint clientVersion)
+{
+	sw::TraceScope scope("Shader::compile");
+
+	clear();
 
 	// Ensure we don't pass a nullptr source to the compiler
 	const char *source = "\0";
@@ -209,6 +223,24 @@ void Shader::compile()
 		source = mSource;
 	}
 
+	std::string key = ShaderCache::key(getType(), clientVersion, source);
+	std::shared_ptr<const CompiledShader> cached = ShaderCache::query(key);
+
+	if(cached)
+	{
+		createShader(cached->binary);
+
+		varyings = cached->varyings;
+		activeUniforms = cached->activeUniforms;
+		activeAttributes = cached->activeAttributes;
+		activeUniformBlocks = cached->activeUniformBlocks;
+
+		return;
+	}
+
+	createShader(nullptr);
+	TranslatorASM *compiler = createCompiler(getType());
+
 	bool success = compiler->compile(&source, 1, SH_OBJECT_CODE);
 
 	if(false)
@@ -224,7 +256,6 @@ void Shader::compile()
 	}
 
 	int shaderVersion = compiler->getShaderVersion();
-	int clientVersion = es2::getContext()->getClientVersion();
 
 	if(shaderVersion >= 300 && clientVersion < 3)
 	{
@@ -239,6 +270,17 @@ void Shader::compile()
 		infoLog += compiler->getInfoSink().info.c_str();
 		TRACE("\n%s", infoLog.c_str());
 	}
+	else
+	{
+		std::shared_ptr<CompiledShader> compiled = std::make_shared<CompiledShader>(getType(), getShader());
+
+		compiled->varyings = varyings;
+		compiled->activeUniforms = activeUniforms;
+		compiled->activeAttributes = activeAttributes;
+		compiled->activeUniformBlocks = activeUniformBlocks;
+
+		ShaderCache::add(key, compiled);
+	}
 
 	delete compiler;
 }
@@ -248,6 +290,38 @@ bool Shader::isCompiled()
 	return getShader() != 0;
 }
 
+bool Shader::isCompileComplete()
+{
+	return !compileTask || compileTask->isComplete();
+}
+
+void Shader::wait()
+{
+	// The task is kept after completing, as other threads of the share group may be waiting on it or polling it
+	if(compileTask)
+	{
+		compileTask->wait();
+	}
+}
+
+void Shader::waitForLinks()
+{
+	for(size_t i = 0; i < links.size(); i++)
+	{
+		links[i]->wait();
+	}
+
+	links.clear();
+}
+
+void Shader::addLink(const std::shared_ptr<Task> &link)
+{
+	// Forget about links which have already completed
+	links.erase(std::remove_if(links.begin(), links.end(), [](const std::shared_ptr<Task> &task) { return task->isComplete(); }), links.end());
+
+	links.push_back(link);
+}
+
 void Shader::addRef()
 {
 	mRefCount++;
@@ -280,6 +354,8 @@ void Shader::flagForDeletion()
 
 void Shader::releaseCompiler()
 {
+	TaskQueue::finish();
+	ShaderCache::clear();
 	FreeCompilerGlobals();
 	compilerInitialized = false;
 }
@@ -374,6 +450,9 @@ VertexShader::VertexShader(ResourceManager *manager, GLuint handle) : Shader(man
 
 VertexShader::~VertexShader()
 {
+	wait();
+	waitForLinks();
+
 	delete vertexShader;
 }
 
@@ -408,10 +487,10 @@ sw::VertexShader *VertexShader::getVertexShader() const
 	return vertexShader;
 }
 
-void VertexShader::createShader()
+void VertexShader::createShader(const sw::Shader *binary)
 {
 	delete vertexShader;
-	vertexShader = new sw::VertexShader();
+	vertexShader = new sw::VertexShader(static_cast<const sw::VertexShader*>(binary));
 }
 
 void VertexShader::deleteShader()
@@ -427,6 +506,9 @@ FragmentShader::FragmentShader(ResourceManager *manager, GLuint handle) : Shader
 
 FragmentShader::~FragmentShader()
 {
+	wait();
+	waitForLinks();
+
 	delete pixelShader;
 }
 
@@ -445,10 +527,10 @@ sw::PixelShader *FragmentShader::getPixelShader() const
 	return pixelShader;
 }
 
-void FragmentShader::createShader()
+void FragmentShader::createShader(const sw::Shader *binary)
 {
 	delete pixelShader;
-	pixelShader = new sw::PixelShader();
+	pixelShader = new sw::PixelShader(static_cast<const sw::PixelShader*>(binary));
 }
 
 void FragmentShader::deleteShader()
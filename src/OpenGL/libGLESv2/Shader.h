@@ -21,6 +21,7 @@
 #define LIBGLESV2_SHADER_H_
 
 #include "ResourceManager.h"
+#include "TaskQueue.h"
 
 #include "compiler/TranslatorASM.h"
 
@@ -59,6 +60,8 @@ public:
 
 	void compile();
 	bool isCompiled();
+	bool isCompileComplete();   // Does not wait
+	void wait();
 
 	void addRef();
 	void release();
@@ -72,6 +75,7 @@ protected:
 	static bool compilerInitialized;
 	TranslatorASM *createCompiler(GLenum shaderType);
 	void clear();
+	void waitForLinks();
 
 	static bool compareVarying(const glsl::Varying &x, const glsl::Varying &y);
 
@@ -79,9 +83,15 @@ protected:
 	std::string infoLog;
 
 private:
-	virtual void createShader() = 0;
+	virtual void createShader(const sw::Shader *binary) = 0;   // Copies the binary, if any
 	virtual void deleteShader() = 0;
 
+	void compileShader(GLint clientVersion);
+	void addLink(const std::shared_ptr<Task> &link);
+
+	std::shared_ptr<Task> compileTask;          // Most recent compile, if any
+	std::vector<std::shared_ptr<Task>> links;   // Links which may still read the compile results
+
 	const GLuint mHandle;
 	unsigned int mRefCount;     // Number of program objects this shader is attached to
 	bool mDeleteStatus;         // Flag to indicate that the shader can be deleted when no longer in use
@@ -105,7 +115,7 @@ public:
 	virtual sw::VertexShader *getVertexShader() const;
 
 private:
-	virtual void createShader();
+	virtual void createShader(const sw::Shader *binary);
 	virtual void deleteShader();
 
 	sw::VertexShader *vertexShader;
@@ -124,7 +134,7 @@ public:
 	virtual sw::PixelShader *getPixelShader() const;
 
 private:
-	virtual void createShader();
+	virtual void createShader(const sw::Shader *binary);
 	virtual void deleteShader();
 
 	sw::PixelShader *pixelShader;
@@ -0,0 +1,135 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ShaderCache.cpp: Implements the ShaderCache class, which keeps the results of
+// successful GLSL compiles so that recompiling an identical source is a lookup.
+
+#include "ShaderCache.h"
+
+#include "Shader/VertexShader.hpp"
+#include "Shader/PixelShader.hpp"
+#include "Common/Counters.hpp"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace es2
+{
+
+namespace
+{
+	struct Entry
+	{
+		std::shared_ptr<const CompiledShader> shader;
+		std::list<const std::string*>::iterator use;
+	};
+
+	struct Cache
+	{
+		std::mutex mutex;
+		std::unordered_map<std::string, Entry> entries;
+		std::list<const std::string*> uses;   // Keys of the entries, most recently used first
+	};
+
+	// Never destroyed, as compiles may still be running on worker threads at exit
+	Cache &cache()
+	{
+		static Cache *cache = new Cache;
+		return *cache;
+	}
+}
+
+CompiledShader::CompiledShader(GLenum shaderType, const sw::Shader *binary)
+{
+	if(shaderType == GL_VERTEX_SHADER)
+	{
+		this->binary = new sw::VertexShader(static_cast<const sw::VertexShader*>(binary));
+	}
+	else
+	{
+		this->binary = new sw::PixelShader(static_cast<const sw::PixelShader*>(binary));
+	}
+}
+
+CompiledShader::~CompiledShader()
+{
+	delete binary;
+}
+
+std::string ShaderCache::key(GLenum shaderType, GLint clientVersion, const char *source)
+{
+	// The resource limits are compile-time constants, so they never differ between entries.
+	// The whole source is part of the key, so unlike a digest it can't produce false hits.
+	std::string key(1, shaderType == GL_VERTEX_SHADER ? 'v' : 'f');
+	key += (char)('0' + clientVersion);
+	key += source;
+
+	return key;
+}
+
+std::shared_ptr<const CompiledShader> ShaderCache::query(const std::string &key)
+{
+	Cache &cache = es2::cache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto entry = cache.entries.find(key);
+
+	if(entry == cache.entries.end())
+	{
+		sw::Counters::increment(sw::COUNTER_SHADER_CACHE_MISSES);
+
+		return nullptr;
+	}
+
+	sw::Counters::increment(sw::COUNTER_SHADER_CACHE_HITS);
+	cache.uses.splice(cache.uses.begin(), cache.uses, entry->second.use);
+
+	return entry->second.shader;
+}
+
+void ShaderCache::add(const std::string &key, const std::shared_ptr<const CompiledShader> &shader)
+{
+	Cache &cache = es2::cache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto entry = cache.entries.insert(std::make_pair(key, Entry()));
+
+	if(!entry.second)   // Compiled concurrently by another thread
+	{
+		return;
+	}
+
+	cache.uses.push_front(&entry.first->first);
+	entry.first->second.shader = shader;
+	entry.first->second.use = cache.uses.begin();
+
+	if(cache.entries.size() > MAX_ENTRIES)
+	{
+		auto oldest = cache.entries.find(*cache.uses.back());
+		cache.uses.pop_back();
+		cache.entries.erase(oldest);
+	}
+}
+
+void ShaderCache::clear()
+{
+	Cache &cache = es2::cache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	cache.entries.clear();
+	cache.uses.clear();
+}
+
+}
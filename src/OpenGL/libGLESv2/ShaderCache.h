@@ -0,0 +1,61 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ShaderCache.h: Defines the ShaderCache class, which keeps the results of
+// successful GLSL compiles so that recompiling an identical source is a lookup.
+
+#ifndef LIBGLESV2_SHADERCACHE_H_
+#define LIBGLESV2_SHADERCACHE_H_
+
+#include "compiler/OutputASM.h"
+
+#include <GLES2/gl2.h>
+
+#include <memory>
+#include <string>
+
+namespace es2
+{
+
+struct CompiledShader
+{
+	CompiledShader(GLenum shaderType, const sw::Shader *binary);
+	~CompiledShader();
+
+	sw::Shader *binary;   // sw::VertexShader or sw::PixelShader, only ever copied
+
+	glsl::VaryingList varyings;
+	glsl::ActiveUniforms activeUniforms;
+	glsl::ActiveAttributes activeAttributes;
+	glsl::ActiveUniformBlocks activeUniformBlocks;
+};
+
+// Shared by all contexts. Entries are immutable, so they can be copied from
+// without holding the cache lock.
+class ShaderCache
+{
+public:
+	enum {MAX_ENTRIES = 256};
+
+	static std::string key(GLenum shaderType, GLint clientVersion, const char *source);
+
+	static std::shared_ptr<const CompiledShader> query(const std::string &key);
+	static void add(const std::string &key, const std::shared_ptr<const CompiledShader> &shader);
+
+	static void clear();
+};
+
+}
+
+#endif   // LIBGLESV2_SHADERCACHE_H_
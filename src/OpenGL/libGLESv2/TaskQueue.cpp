@@ -0,0 +1,163 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// TaskQueue.cpp: Implements the Task and TaskQueue classes, which run shader compiles
+// and program links on worker threads (GL_KHR_parallel_shader_compile).
+
+#include "TaskQueue.h"
+
+#include "Common/CPUID.hpp"
+#include "Common/Thread.hpp"
+
+#include <algorithm>
+#include <deque>
+
+namespace es2
+{
+
+namespace
+{
+	struct Queue
+	{
+		std::mutex mutex;
+		std::condition_variable scheduled;   // Tasks were added or the thread limit was raised
+		std::condition_variable finished;    // All tasks have completed
+		std::deque<std::shared_ptr<Task>> tasks;
+
+		GLuint maxThreads = 0xFFFFFFFF;   // GL_MAX_SHADER_COMPILER_THREADS_KHR
+		int threadCount = 0;
+		int pending = 0;   // Queued or running tasks
+	};
+
+	// Never destroyed, as worker threads keep waiting on it until the process exits
+	Queue &queue()
+	{
+		static Queue *queue = new Queue;
+		return *queue;
+	}
+
+	// Tasks that were queued before switching to synchronous operation still need a thread
+	int threadLimit(GLuint maxThreads)
+	{
+		return std::max((int)std::min(maxThreads, (GLuint)sw::CPUID::processAffinity()), 1);
+	}
+
+	void workerThread(void *parameters)
+	{
+		const int index = (int)(size_t)parameters;
+		Queue &queue = es2::queue();
+		std::unique_lock<std::mutex> lock(queue.mutex);
+
+		while(true)
+		{
+			queue.scheduled.wait(lock, [&]() { return !queue.tasks.empty() && index < threadLimit(queue.maxThreads); });
+
+			std::shared_ptr<Task> task = queue.tasks.front();
+			queue.tasks.pop_front();
+
+			lock.unlock();
+			task->run();
+			lock.lock();
+
+			if(--queue.pending == 0)
+			{
+				queue.finished.notify_all();
+			}
+		}
+	}
+}
+
+Task::Task(const std::function<void()> &function) : function(function), complete(false)
+{
+}
+
+void Task::run()
+{
+	function();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	complete = true;
+	completed.notify_all();
+}
+
+bool Task::isComplete()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return complete;
+}
+
+void Task::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	completed.wait(lock, [this]() { return complete; });
+}
+
+std::shared_ptr<Task> TaskQueue::schedule(const std::function<void()> &function)
+{
+	std::shared_ptr<Task> task = std::make_shared<Task>(function);
+	Queue &queue = es2::queue();
+	std::unique_lock<std::mutex> lock(queue.mutex);
+
+	if(queue.maxThreads == 0)
+	{
+		// Earlier tasks may be prerequisites of this one
+		queue.finished.wait(lock, [&]() { return queue.pending == 0; });
+		lock.unlock();
+
+		task->run();
+
+		return task;
+	}
+
+	queue.tasks.push_back(task);
+	queue.pending++;
+
+	// Worker threads are only created once there is more work than threads
+	if(queue.pending > queue.threadCount && queue.threadCount < threadLimit(queue.maxThreads))
+	{
+		new sw::Thread(workerThread, (void*)(size_t)queue.threadCount);
+		queue.threadCount++;
+	}
+
+	queue.scheduled.notify_all();
+
+	return task;
+}
+
+void TaskQueue::finish()
+{
+	Queue &queue = es2::queue();
+	std::unique_lock<std::mutex> lock(queue.mutex);
+
+	queue.finished.wait(lock, [&]() { return queue.pending == 0; });
+}
+
+void TaskQueue::setMaxThreads(GLuint count)
+{
+	Queue &queue = es2::queue();
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	queue.maxThreads = count;
+	queue.scheduled.notify_all();
+}
+
+GLuint TaskQueue::getMaxThreads()
+{
+	Queue &queue = es2::queue();
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	return queue.maxThreads;
+}
+
+}
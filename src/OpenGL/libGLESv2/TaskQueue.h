@@ -0,0 +1,62 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// TaskQueue.h: Defines the Task and TaskQueue classes, which run shader compiles
+// and program links on worker threads (GL_KHR_parallel_shader_compile).
+
+#ifndef LIBGLESV2_TASKQUEUE_H_
+#define LIBGLESV2_TASKQUEUE_H_
+
+#include <GLES2/gl2.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace es2
+{
+
+class Task
+{
+public:
+	explicit Task(const std::function<void()> &function);
+
+	void run();
+	bool isComplete();
+	void wait();
+
+private:
+	std::function<void()> function;
+
+	std::mutex mutex;
+	std::condition_variable completed;
+	bool complete;
+};
+
+// Tasks are started in the order they were scheduled, so a task may wait
+// for any task scheduled before it without risking a deadlock.
+class TaskQueue
+{
+public:
+	static std::shared_ptr<Task> schedule(const std::function<void()> &function);
+	static void finish();   // Waits for all scheduled tasks
+
+	static void setMaxThreads(GLuint count);   // Zero runs tasks on the calling thread
+	static GLuint getMaxThreads();
+};
+
+}
+
+#endif   // LIBGLESV2_TASKQUEUE_H_
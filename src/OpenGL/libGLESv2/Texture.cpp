@@ -21,6 +21,7 @@
 #include "main.h"
 #include "mathutil.h"
 #include "Framebuffer.h"
+#include "Buffer.h"
 #include "Device.hpp"
 #include "libEGL/Display.h"
 #include "libEGL/Surface.h"
@@ -406,12 +407,12 @@ egl::Image *Texture::createSharedImage(GLenum target, unsigned int level)
 	return image;
 }
 
-void Texture::setImage(GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels, egl::Image *image)
+void Texture::setImage(GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels, egl::Image *image)
 {
-	if(pixels && image)
+	if((pixels || unpackBuffer) && image)
 	{
 		GLsizei depth = (getTarget() == GL_TEXTURE_3D_OES || getTarget() == GL_TEXTURE_2D_ARRAY) ? image->getDepth() : 1;
-		image->loadImageData(0, 0, 0, image->getWidth(), image->getHeight(), depth, format, type, unpackInfo, pixels);
+		loadImageData(image, 0, 0, 0, image->getWidth(), image->getHeight(), depth, format, type, unpackInfo, unpackBuffer, pixels);
 	}
 }
 
@@ -424,7 +425,7 @@ void Texture::setCompressedImage(GLsizei imageSize, const void *pixels, egl::Ima
 	}
 }
 
-void Texture::subImage(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels, egl::Image *image)
+void Texture::subImage(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels, egl::Image *image)
 {
 	if(!image)
 	{
@@ -446,12 +447,28 @@ void Texture::subImage(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei widt
 		return error(GL_INVALID_OPERATION);
 	}
 
-	if(pixels)
+	if(pixels || unpackBuffer)
 	{
-		image->loadImageData(xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, pixels);
+		loadImageData(image, xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, unpackBuffer, pixels);
 	}
 }
 
+void Texture::loadImageData(egl::Image *image, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
+{
+	if(unpackBuffer)
+	{
+		pixels = static_cast<const unsigned char*>(unpackBuffer->data()) + reinterpret_cast<size_t>(pixels);
+
+		// Don't wait for the draws which sample the texture, the renderer orders the upload after them
+		if(image->deferImageData(getDevice(), xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, unpackBuffer->getResource(), pixels))
+		{
+			return;
+		}
+	}
+
+	image->loadImageData(xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, pixels);
+}
+
 void Texture::subImageCompressed(GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *pixels, egl::Image *image)
 {
 	if(!image)
@@ -637,7 +654,7 @@ int Texture2D::getLevelCount() const
 	return levels;
 }
 
-void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
 	if(image[level])
 	{
@@ -651,7 +668,7 @@ void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLenum form
 		return error(GL_OUT_OF_MEMORY);
 	}
 
-	Texture::setImage(format, type, unpackInfo, pixels, image[level]);
+	Texture::setImage(format, type, unpackInfo, unpackBuffer, pixels, image[level]);
 }
 
 void Texture2D::bindTexImage(egl::Surface *surface)
@@ -722,9 +739,9 @@ void Texture2D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	Texture::setCompressedImage(imageSize, pixels, image[level]);
 }
 
-void Texture2D::subImage(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void Texture2D::subImage(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
-	Texture::subImage(xoffset, yoffset, 0, width, height, 1, format, type, unpackInfo, pixels, image[level]);
+	Texture::subImage(xoffset, yoffset, 0, width, height, 1, format, type, unpackInfo, unpackBuffer, pixels, image[level]);
 }
 
 void Texture2D::subImageCompressed(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *pixels)
@@ -1155,9 +1172,9 @@ void TextureCubeMap::setCompressedImage(GLenum target, GLint level, GLenum forma
 	Texture::setCompressedImage(imageSize, pixels, image[face][level]);
 }
 
-void TextureCubeMap::subImage(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void TextureCubeMap::subImage(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
-	Texture::subImage(xoffset, yoffset, 0, width, height, 1, format, type, unpackInfo, pixels, image[CubeFaceIndex(target)][level]);
+	Texture::subImage(xoffset, yoffset, 0, width, height, 1, format, type, unpackInfo, unpackBuffer, pixels, image[CubeFaceIndex(target)][level]);
 }
 
 void TextureCubeMap::subImageCompressed(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *pixels)
@@ -1277,7 +1294,7 @@ void TextureCubeMap::releaseTexImage()
 	UNREACHABLE(0);   // Cube maps cannot have an EGL surface bound as an image
 }
 
-void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
 	int face = CubeFaceIndex(target);
 
@@ -1293,7 +1310,7 @@ void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei
 		return error(GL_OUT_OF_MEMORY);
 	}
 
-	Texture::setImage(format, type, unpackInfo, pixels, image[face][level]);
+	Texture::setImage(format, type, unpackInfo, unpackBuffer, pixels, image[face][level]);
 }
 
 void TextureCubeMap::copyImage(GLenum target, GLint level, GLenum format, GLint x, GLint y, GLsizei width, GLsizei height, Framebuffer *source)
@@ -1606,7 +1623,7 @@ int Texture3D::getLevelCount() const
 	return levels;
 }
 
-void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
 	if(image[level])
 	{
@@ -1620,7 +1637,7 @@ void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei dep
 		return error(GL_OUT_OF_MEMORY);
 	}
 
-	Texture::setImage(format, type, unpackInfo, pixels, image[level]);
+	Texture::setImage(format, type, unpackInfo, unpackBuffer, pixels, image[level]);
 }
 
 void Texture3D::bindTexImage(egl::Surface *surface)
@@ -1685,9 +1702,9 @@ void Texture3D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	Texture::setCompressedImage(imageSize, pixels, image[level]);
 }
 
-void Texture3D::subImage(GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, const void *pixels)
+void Texture3D::subImage(GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const egl::Image::UnpackInfo& unpackInfo, Buffer *unpackBuffer, const void *pixels)
 {
-	Texture::subImage(xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, pixels, image[level]);
+	Texture::subImage(xoffset, yoffset, zoffset, width, height, depth, format, type, unpackInfo, unpackBuffer, pixels, image[level]);
 }
 
 void Texture3D::subImageCompressed(GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *pixels)
@@ -2036,6 +2053,11 @@ egl::Image *createBackBuffer(int width, int height, const egl::Config *config)
 	return nullptr;
 }
 
+egl::Image *createSharedMemoryImage(int fd, int width, int height, int fourcc, int offset, int pitch)
+{
+	return egl::Image::importSharedMemory(fd, width, height, fourcc, offset, pitch);
+}
+
 egl::Image *createDepthStencil(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool discard)
 {
 	if(width == 0 || height == 0 || height > sw::OUTLINE_RESOLUTION)
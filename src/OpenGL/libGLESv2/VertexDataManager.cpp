@@ -276,10 +276,8 @@ ConstantVertexBuffer::~ConstantVertexBuffer()
 {
 }
 
-StreamingVertexBuffer::StreamingVertexBuffer(unsigned int size) : VertexBuffer(size)
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int size) : mRing(size)
 {
-	mBufferSize = size;
-	mWritePosition = 0;
 	mRequiredSpace = 0;
 }
 
@@ -294,53 +292,29 @@ void StreamingVertexBuffer::addRequiredSpace(unsigned int requiredSpace)
 
 void *StreamingVertexBuffer::map(const VertexAttribute &attribute, unsigned int requiredSpace, unsigned int *offset)
 {
-	void *mapPtr = nullptr;
+	size_t streamOffset = 0;
+	void *mapPtr = mRing.map(requiredSpace, &streamOffset);
 
-	if(mVertexBuffer)
-	{
-		// We can use a private lock because we never overwrite the content
-		mapPtr = (char*)mVertexBuffer->lock(sw::PRIVATE) + mWritePosition;
-
-		*offset = mWritePosition;
-		mWritePosition += requiredSpace;
-	}
+	*offset = (unsigned int)streamOffset;
 
 	return mapPtr;
 }
 
-void StreamingVertexBuffer::reserveRequiredSpace()
+void StreamingVertexBuffer::unmap()
 {
-	if(mRequiredSpace > mBufferSize)
-	{
-		if(mVertexBuffer)
-		{
-			mVertexBuffer->destruct();
-			mVertexBuffer = 0;
-		}
-
-		mBufferSize = std::max(mRequiredSpace, 3 * mBufferSize / 2);   // 1.5 x mBufferSize is arbitrary and should be checked to see we don't have too many reallocations.
-
-		mVertexBuffer = new sw::Resource(mBufferSize);
-
-		if(!mVertexBuffer)
-		{
-			ERR("Out of memory allocating a vertex buffer of size %u.", mBufferSize);
-		}
-
-		mWritePosition = 0;
-	}
-	else if(mWritePosition + mRequiredSpace > mBufferSize)   // Recycle
-	{
-		if(mVertexBuffer)
-		{
-			mVertexBuffer->destruct();
-			mVertexBuffer = new sw::Resource(mBufferSize);
-		}
+	mRing.unmap();
+}
 
-		mWritePosition = 0;
-	}
+void StreamingVertexBuffer::reserveRequiredSpace()
+{
+	mRing.reserve(mRequiredSpace);
 
 	mRequiredSpace = 0;
 }
 
+sw::Resource *StreamingVertexBuffer::getResource() const
+{
+	return mRing.getResource();
+}
+
 }
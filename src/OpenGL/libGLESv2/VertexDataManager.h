@@ -20,6 +20,7 @@
 
 #include "Context.h"
 #include "Device.hpp"
+#include "Common/ResourceRing.hpp"
 
 #include <GLES2/gl2.h>
 
@@ -59,19 +60,21 @@ public:
 	~ConstantVertexBuffer();
 };
 
-class StreamingVertexBuffer : public VertexBuffer
+class StreamingVertexBuffer
 {
 public:
 	StreamingVertexBuffer(unsigned int size);
 	~StreamingVertexBuffer();
 
 	void *map(const VertexAttribute &attribute, unsigned int requiredSpace, unsigned int *streamOffset);
+	void unmap();
 	void reserveRequiredSpace();
 	void addRequiredSpace(unsigned int requiredSpace);
 
-protected:
-	unsigned int mBufferSize;
-	unsigned int mWritePosition;
+	sw::Resource *getResource() const;
+
+private:
+	sw::ResourceRing mRing;
 	unsigned int mRequiredSpace;
 };
 
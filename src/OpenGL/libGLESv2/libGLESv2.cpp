@@ -3143,11 +3143,11 @@ void GetProgramiv(GLuint program, GLenum pname, GLint* params)
 
 	if(context)
 	{
-		es2::Program *programObject = context->getProgram(program);
+		es2::Program *programObject = context->getPendingProgram(program);
 
 		if(!programObject)
 		{
-			if(context->getShader(program))
+			if(context->getPendingShader(program))
 			{
 				return error(GL_INVALID_OPERATION);
 			}
@@ -3157,10 +3157,19 @@ void GetProgramiv(GLuint program, GLenum pname, GLint* params)
 			}
 		}
 
+		// Only the completion status can be queried without waiting for the link
+		if(pname != GL_COMPLETION_STATUS_KHR)
+		{
+			programObject->wait();
+		}
+
 		GLint clientVersion = egl::getClientVersion();
 
 		switch(pname)
 		{
+		case GL_COMPLETION_STATUS_KHR:
+			*params = programObject->isLinkComplete() ? GL_TRUE : GL_FALSE;
+			return;
 		case GL_DELETE_STATUS:
 			*params = programObject->isFlaggedForDeletion();
 			return;
@@ -3384,11 +3393,11 @@ void GetShaderiv(GLuint shader, GLenum pname, GLint* params)
 
 	if(context)
 	{
-		es2::Shader *shaderObject = context->getShader(shader);
+		es2::Shader *shaderObject = context->getPendingShader(shader);
 
 		if(!shaderObject)
 		{
-			if(context->getProgram(shader))
+			if(context->getPendingProgram(shader))
 			{
 				return error(GL_INVALID_OPERATION);
 			}
@@ -3398,8 +3407,17 @@ void GetShaderiv(GLuint shader, GLenum pname, GLint* params)
 			}
 		}
 
+		// Only the completion status can be queried without waiting for the compile
+		if(pname != GL_COMPLETION_STATUS_KHR)
+		{
+			shaderObject->wait();
+		}
+
 		switch(pname)
 		{
+		case GL_COMPLETION_STATUS_KHR:
+			*params = shaderObject->isCompileComplete() ? GL_TRUE : GL_FALSE;
+			return;
 		case GL_SHADER_TYPE:
 			*params = shaderObject->getType();
 			return;
@@ -4647,6 +4665,13 @@ void ReleaseShaderCompiler(void)
 	es2::Shader::releaseCompiler();
 }
 
+void MaxShaderCompilerThreadsKHR(GLuint count)
+{
+	TRACE("(GLuint count = %d)", count);
+
+	es2::TaskQueue::setMaxThreads(count);
+}
+
 void RenderbufferStorageMultisampleANGLE(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
 {
 	TRACE("(GLenum target = 0x%X, GLsizei samples = %d, GLenum internalformat = 0x%X, GLsizei width = %d, GLsizei height = %d)",
@@ -4795,7 +4820,7 @@ void SetFenceNV(GLuint fence, GLenum condition)
 			return error(GL_INVALID_OPERATION);
 		}
 
-		fenceObject->setFence(condition);
+		fenceObject->setFence(condition, context->insertFence());
 	}
 }
 
@@ -5116,6 +5141,12 @@ void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width,
 			return error(GL_INVALID_ENUM);
 		}
 
+		validationError = context->validateUnpackBuffer(width, height, 1, format, type, pixels);
+		if(validationError != GL_NONE)
+		{
+			return error(validationError);
+		}
+
 		GLenum sizedInternalFormat = GetSizedInternalFormat(format, type);
 
 		if(target == GL_TEXTURE_2D)
@@ -5127,7 +5158,7 @@ void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width,
 				return error(GL_INVALID_OPERATION);
 			}
 
-			texture->setImage(level, width, height, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+			texture->setImage(level, width, height, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 		}
 		else
 		{
@@ -5138,7 +5169,7 @@ void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width,
 				return error(GL_INVALID_OPERATION);
 			}
 
-			texture->setImage(target, level, width, height, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+			texture->setImage(target, level, width, height, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 		}
 	}
 }
@@ -5474,7 +5505,7 @@ void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLs
 		return;
 	}
 
-	if(width == 0 || height == 0 || !pixels)
+	if(width == 0 || height == 0)
 	{
 		return;
 	}
@@ -5483,17 +5514,23 @@ void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLs
 
 	if(context)
 	{
+		GLenum validationError = context->validateUnpackBuffer(width, height, 1, format, type, pixels);
+		if(validationError != GL_NONE)
+		{
+			return error(validationError);
+		}
+
 		GLenum sizedInternalFormat = GetSizedInternalFormat(format, type);
 
 		if(target == GL_TEXTURE_2D)
 		{
 			es2::Texture2D *texture = context->getTexture2D();
 
-			GLenum validationError = ValidateSubImageParams(false, width, height, xoffset, yoffset, target, level, sizedInternalFormat, texture);
+			validationError = ValidateSubImageParams(false, width, height, xoffset, yoffset, target, level, sizedInternalFormat, texture);
 
 			if(validationError == GL_NONE)
 			{
-				texture->subImage(level, xoffset, yoffset, width, height, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+				texture->subImage(level, xoffset, yoffset, width, height, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 			}
 			else
 			{
@@ -5504,11 +5541,11 @@ void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLs
 		{
 			es2::TextureCubeMap *texture = context->getTextureCubeMap();
 
-			GLenum validationError = ValidateSubImageParams(false, width, height, xoffset, yoffset, target, level, sizedInternalFormat, texture);
+			validationError = ValidateSubImageParams(false, width, height, xoffset, yoffset, target, level, sizedInternalFormat, texture);
 
 			if(validationError == GL_NONE)
 			{
-				texture->subImage(target, level, xoffset, yoffset, width, height, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+				texture->subImage(target, level, xoffset, yoffset, width, height, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 			}
 			else
 			{
@@ -6323,7 +6360,13 @@ void TexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei wi
 			return error(GL_INVALID_OPERATION);
 		}
 
-		texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), pixels);
+		GLenum validationError = context->validateUnpackBuffer(width, height, depth, format, type, pixels);
+		if(validationError != GL_NONE)
+		{
+			return error(validationError);
+		}
+
+		texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 	}
 }
 
@@ -6368,7 +6411,12 @@ void TexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset,
 		GLenum validationError = ValidateSubImageParams(false, width, height, depth, xoffset, yoffset, zoffset, target, level, sizedInternalFormat, texture);
 		if(validationError == GL_NONE)
 		{
-			texture->subImage(level, xoffset, yoffset, zoffset, width, height, depth, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+			validationError = context->validateUnpackBuffer(width, height, depth, format, type, pixels);
+		}
+
+		if(validationError == GL_NONE)
+		{
+			texture->subImage(level, xoffset, yoffset, zoffset, width, height, depth, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 		}
 		else
 		{
@@ -6929,6 +6977,7 @@ extern "C" __eglMustCastToProperFunctionPointerType es2GetProcAddress(const char
 		EXTENSION(glGetFramebufferAttachmentParameterivOES),
 		EXTENSION(glGenerateMipmapOES),
 		EXTENSION(glDrawBuffersEXT),
+		EXTENSION(glMaxShaderCompilerThreadsKHR),
 
 		#undef EXTENSION
 	};
@@ -677,7 +677,13 @@ GL_APICALL void GL_APIENTRY glTexImage3D(GLenum target, GLint level, GLint inter
 			return error(GL_INVALID_OPERATION);
 		}
 
-		texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), pixels);
+		GLenum validationError = context->validateUnpackBuffer(width, height, depth, format, type, pixels);
+		if(validationError != GL_NONE)
+		{
+			return error(validationError);
+		}
+
+		texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 	}
 }
 
@@ -723,7 +729,12 @@ GL_APICALL void GL_APIENTRY glTexSubImage3D(GLenum target, GLint level, GLint xo
 		GLenum validationError = ValidateSubImageParams(false, width, height, depth, xoffset, yoffset, zoffset, target, level, sizedInternalFormat, texture);
 		if(validationError == GL_NONE)
 		{
-			texture->subImage(level, xoffset, yoffset, zoffset, width, height, depth, sizedInternalFormat, type, context->getUnpackInfo(), pixels);
+			validationError = context->validateUnpackBuffer(width, height, depth, format, type, pixels);
+		}
+
+		if(validationError == GL_NONE)
+		{
+			texture->subImage(level, xoffset, yoffset, zoffset, width, height, depth, sizedInternalFormat, type, context->getUnpackInfo(), context->getPixelUnpackBuffer(), pixels);
 		}
 		else
 		{
@@ -3114,7 +3125,7 @@ GL_APICALL GLenum GL_APIENTRY glClientWaitSync(GLsync sync, GLbitfield flags, GL
 
 	if((flags & ~(GL_SYNC_FLUSH_COMMANDS_BIT)) != 0)
 	{
-		error(GL_INVALID_VALUE);
+		return error(GL_INVALID_VALUE, GL_WAIT_FAILED);
 	}
 
 	es2::Context *context = es2::getContext();
@@ -3129,11 +3140,11 @@ GL_APICALL GLenum GL_APIENTRY glClientWaitSync(GLsync sync, GLbitfield flags, GL
 		}
 		else
 		{
-			return error(GL_INVALID_VALUE, GL_FALSE);
+			return error(GL_INVALID_VALUE, GL_WAIT_FAILED);
 		}
 	}
 
-	return GL_FALSE;
+	return GL_WAIT_FAILED;
 }
 
 GL_APICALL void GL_APIENTRY glWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
@@ -3234,7 +3245,47 @@ GL_APICALL void GL_APIENTRY glGetSynciv(GLsync sync, GLenum pname, GLsizei bufSi
 		return error(GL_INVALID_VALUE);
 	}
 
-	UNIMPLEMENTED();
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		es2::FenceSync *fenceSyncObject = context->getFenceSync(sync);
+
+		if(!fenceSyncObject)
+		{
+			return error(GL_INVALID_VALUE);
+		}
+
+		GLint value;
+
+		switch(pname)
+		{
+		case GL_OBJECT_TYPE:
+			value = GL_SYNC_FENCE;
+			break;
+		case GL_SYNC_STATUS:
+			value = fenceSyncObject->isSignaled() ? GL_SIGNALED : GL_UNSIGNALED;
+			break;
+		case GL_SYNC_CONDITION:
+			value = fenceSyncObject->getCondition();
+			break;
+		case GL_SYNC_FLAGS:
+			value = fenceSyncObject->getFlags();
+			break;
+		default:
+			return error(GL_INVALID_ENUM);
+		}
+
+		if(bufSize > 0)
+		{
+			*values = value;
+		}
+
+		if(length)
+		{
+			*length = (bufSize > 0) ? 1 : 0;
+		}
+	}
 }
 
 GL_APICALL void GL_APIENTRY glGetInteger64i_v(GLenum target, GLuint index, GLint64 *data)
@@ -3860,7 +3911,7 @@ GL_APICALL void GL_APIENTRY glTexStorage2D(GLenum target, GLsizei levels, GLenum
 
 			for(int level = 0; level < levels; ++level)
 			{
-				texture->setImage(level, width, height, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr);
+				texture->setImage(level, width, height, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr, nullptr);
 				width = std::max(1, (width / 2));
 				height = std::max(1, (height / 2));
 			}
@@ -3879,7 +3930,7 @@ GL_APICALL void GL_APIENTRY glTexStorage2D(GLenum target, GLsizei levels, GLenum
 			{
 				for(int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X; face <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z; ++face)
 				{
-					texture->setImage(face, level, width, height, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr);
+					texture->setImage(face, level, width, height, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr, nullptr);
 				}
 				width = std::max(1, (width / 2));
 				height = std::max(1, (height / 2));
@@ -3930,7 +3981,7 @@ GL_APICALL void GL_APIENTRY glTexStorage3D(GLenum target, GLsizei levels, GLenum
 
 			for(int level = 0; level < levels; ++level)
 			{
-				texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr);
+				texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr, nullptr);
 				width = std::max(1, (width / 2));
 				height = std::max(1, (height / 2));
 				depth = std::max(1, (depth / 2));
@@ -3955,7 +4006,7 @@ GL_APICALL void GL_APIENTRY glTexStorage3D(GLenum target, GLsizei levels, GLenum
 			{
 				for(int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X; face <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z; ++face)
 				{
-					texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr);
+					texture->setImage(level, width, height, depth, GetSizedInternalFormat(internalformat, type), type, context->getUnpackInfo(), nullptr, nullptr);
 				}
 				width = std::max(1, (width / 2));
 				height = std::max(1, (height / 2));
@@ -350,6 +350,7 @@ GL_APICALL void FramebufferTexture2DOES(GLenum target, GLenum attachment, GLenum
 GL_APICALL void GetFramebufferAttachmentParameterivOES(GLenum target, GLenum attachment, GLenum pname, GLint* params);
 GL_APICALL void GenerateMipmapOES(GLenum target);
 GL_APICALL void DrawBuffersEXT(GLsizei n, const GLenum *bufs);
+GL_APICALL void MaxShaderCompilerThreadsKHR(GLuint count);
 }
 
 extern "C"
@@ -1325,12 +1326,18 @@ GL_APICALL void GL_APIENTRY glDrawBuffersEXT(GLsizei n, const GLenum *bufs)
 {
 	return es2::DrawBuffersEXT(n, bufs);
 }
+
+GL_APICALL void GL_APIENTRY glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+	return es2::MaxShaderCompilerThreadsKHR(count);
+}
 }
 
 egl::Context *es2CreateContext(const egl::Config *config, const egl::Context *shareContext, int clientVersion);
 extern "C" __eglMustCastToProperFunctionPointerType es2GetProcAddress(const char *procname);
 egl::Image *createBackBuffer(int width, int height, const egl::Config *config);
 egl::Image *createDepthStencil(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool discard);
+egl::Image *createSharedMemoryImage(int fd, int width, int height, int fourcc, int offset, int pitch);
 sw::FrameBuffer *createFrameBuffer(void *display, EGLNativeWindowType window, int width, int height);
 
 LibGLESv2exports::LibGLESv2exports()
@@ -1528,11 +1535,13 @@ LibGLESv2exports::LibGLESv2exports()
 	this->glGetFramebufferAttachmentParameterivOES = es2::GetFramebufferAttachmentParameterivOES;
 	this->glGenerateMipmapOES = es2::GenerateMipmapOES;
 	this->glDrawBuffersEXT = es2::DrawBuffersEXT;
+	this->glMaxShaderCompilerThreadsKHR = es2::MaxShaderCompilerThreadsKHR;
 
 	this->es2CreateContext = ::es2CreateContext;
 	this->es2GetProcAddress = ::es2GetProcAddress;
 	this->createBackBuffer = ::createBackBuffer;
 	this->createDepthStencil = ::createDepthStencil;
+	this->createSharedMemoryImage = ::createSharedMemoryImage;
 	this->createFrameBuffer = ::createFrameBuffer;
 }
 
@@ -0,0 +1,249 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CodeHeap.hpp"
+
+#include "../Common/Memory.hpp"
+#include "../Common/Counters.hpp"
+#include "../Common/Debug.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace sw
+{
+	namespace
+	{
+		struct Slab
+		{
+			unsigned char *memory;
+			size_t size;
+			size_t used;
+			std::map<size_t, size_t> free;   // Offset to size of the unused ranges, coalesced
+		};
+
+		struct Heap
+		{
+			std::mutex mutex;
+			std::vector<Slab*> slabs;
+		};
+
+		// Never destroyed, as routines may still be released at exit
+		Heap &heap()
+		{
+			static Heap *heap = new Heap;
+			return *heap;
+		}
+
+		size_t roundUp(size_t x, size_t alignment)
+		{
+			return (x + alignment - 1) & ~(alignment - 1);
+		}
+
+		Slab *findSlab(Heap &heap, void *memory)
+		{
+			for(Slab *slab : heap.slabs)
+			{
+				if(memory >= slab->memory && memory < slab->memory + slab->size)
+				{
+					return slab;
+				}
+			}
+
+			return nullptr;
+		}
+
+		void release(Slab *slab, size_t offset, size_t bytes)
+		{
+			std::map<size_t, size_t> &free = slab->free;
+			auto next = free.lower_bound(offset);
+
+			if(next != free.end() && offset + bytes == next->first)
+			{
+				bytes += next->second;
+				next = free.erase(next);
+			}
+
+			if(next != free.begin())
+			{
+				auto previous = std::prev(next);
+
+				if(previous->first + previous->second == offset)
+				{
+					previous->second += bytes;
+					return;
+				}
+			}
+
+			free.insert(next, std::make_pair(offset, bytes));
+		}
+
+		// Only the pages overlapping the ends of the range can also hold other routines
+		void markWritableRange(unsigned char *begin, unsigned char *end)
+		{
+			size_t pageSize = memoryPageSize();
+			uintptr_t first = (uintptr_t)begin & ~(pageSize - 1);
+			uintptr_t last = roundUp((uintptr_t)end, pageSize);
+			uintptr_t innerFirst = roundUp((uintptr_t)begin, pageSize);
+			uintptr_t innerLast = (uintptr_t)end & ~(pageSize - 1);
+
+			if(innerFirst >= innerLast)
+			{
+				markWritable((void*)first, last - first, true);
+				return;
+			}
+
+			markWritable((void*)innerFirst, innerLast - innerFirst);
+
+			if(first < innerFirst)
+			{
+				markWritable((void*)first, pageSize, true);
+			}
+
+			if(innerLast < last)
+			{
+				markWritable((void*)innerLast, pageSize, true);
+			}
+		}
+	}
+
+	void *CodeHeap::allocate(size_t bytes)
+	{
+		Heap &heap = sw::heap();
+		std::lock_guard<std::mutex> lock(heap.mutex);
+
+		bytes = roundUp(bytes, GRANULARITY);
+
+		Slab *slab = nullptr;
+		size_t offset = 0;
+
+		for(Slab *candidate : heap.slabs)
+		{
+			for(auto range = candidate->free.begin(); range != candidate->free.end(); range++)
+			{
+				if(range->second >= bytes)   // First fit
+				{
+					slab = candidate;
+					offset = range->first;
+
+					if(range->second > bytes)
+					{
+						candidate->free.insert(std::make_pair(offset + bytes, range->second - bytes));
+					}
+
+					candidate->free.erase(range);
+					break;
+				}
+			}
+
+			if(slab)
+			{
+				break;
+			}
+		}
+
+		if(!slab)
+		{
+			size_t size = roundUp(bytes > SLAB_SIZE ? bytes : SLAB_SIZE, memoryPageSize());
+			unsigned char *memory = (unsigned char*)allocateExecutable(size);
+
+			if(!memory)
+			{
+				return nullptr;
+			}
+
+			slab = new Slab;
+			slab->memory = memory;
+			slab->size = size;
+			slab->used = 0;
+
+			if(size > bytes)
+			{
+				slab->free[bytes] = size - bytes;
+			}
+
+			heap.slabs.push_back(slab);
+			Counters::add(COUNTER_JIT_HEAP_BYTES, size);
+		}
+
+		slab->used += bytes;
+		Counters::add(COUNTER_JIT_CODE_BYTES, bytes);
+
+		unsigned char *memory = slab->memory + offset;
+		markWritableRange(memory, memory + bytes);
+
+		return memory;
+	}
+
+	size_t CodeHeap::shrink(void *memory, size_t bytes, size_t used)
+	{
+		Heap &heap = sw::heap();
+		std::lock_guard<std::mutex> lock(heap.mutex);
+
+		bytes = roundUp(bytes, GRANULARITY);
+		used = roundUp(used, GRANULARITY);
+
+		if(used >= bytes)
+		{
+			return bytes;
+		}
+
+		Slab *slab = findSlab(heap, memory);
+		ASSERT(slab);
+
+		release(slab, (unsigned char*)memory - slab->memory + used, bytes - used);
+		slab->used -= bytes - used;
+		Counters::add(COUNTER_JIT_CODE_BYTES, -(int64_t)(bytes - used));
+
+		return used;
+	}
+
+	void CodeHeap::markExecutable(void *memory, size_t bytes)
+	{
+		size_t pageSize = memoryPageSize();
+		uintptr_t first = (uintptr_t)memory & ~(pageSize - 1);
+		uintptr_t last = roundUp((uintptr_t)memory + bytes, pageSize);
+
+		sw::markExecutable((void*)first, last - first);
+	}
+
+	void CodeHeap::free(void *memory, size_t bytes)
+	{
+		Heap &heap = sw::heap();
+		std::lock_guard<std::mutex> lock(heap.mutex);
+
+		bytes = roundUp(bytes, GRANULARITY);
+
+		Slab *slab = findSlab(heap, memory);
+		ASSERT(slab);
+
+		release(slab, (unsigned char*)memory - slab->memory, bytes);
+		slab->used -= bytes;
+		Counters::add(COUNTER_JIT_CODE_BYTES, -(int64_t)bytes);
+
+		// Keep one slab around, so that a single cached routine being replaced doesn't map and unmap every time
+		if(slab->used == 0 && heap.slabs.size() > 1)
+		{
+			Counters::add(COUNTER_JIT_HEAP_BYTES, -(int64_t)slab->size);
+
+			deallocateExecutable(slab->memory, slab->size);
+			heap.slabs.erase(std::find(heap.slabs.begin(), heap.slabs.end(), slab));
+			delete slab;
+		}
+	}
+}
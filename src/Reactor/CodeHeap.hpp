@@ -0,0 +1,39 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_CodeHeap_hpp
+#define sw_CodeHeap_hpp
+
+#include <stddef.h>
+
+namespace sw
+{
+	// Packs generated routines contiguously into large slabs, instead of
+	// giving each routine its own pages. Memory is writable from allocate()
+	// until markExecutable(). Pages shared with other routines stay executable
+	// while being written, since those routines may be running.
+	class CodeHeap
+	{
+	public:
+		enum {GRANULARITY = 64};          // Cache line aligned entries
+		enum {SLAB_SIZE = 64 * 1024};
+
+		static void *allocate(size_t bytes);
+		static size_t shrink(void *memory, size_t bytes, size_t used);   // Returns the new size
+		static void markExecutable(void *memory, size_t bytes);
+		static void free(void *memory, size_t bytes);   // Usage is reported by the JIT code and heap counters
+	};
+}
+
+#endif   // sw_CodeHeap_hpp
@@ -31,10 +31,12 @@
 
 #include "Routine.hpp"
 #include "RoutineManager.hpp"
+#include "PerfJIT.hpp"
 #include "x86.hpp"
 #include "CPUID.hpp"
 #include "Thread.hpp"
 #include "Memory.hpp"
+#include "Trace.hpp"
 
 #include <xmmintrin.h>
 #include <fstream>
@@ -65,6 +67,7 @@ namespace sw
 	using namespace llvm;
 
 	RoutineManager *Nucleus::routineManager = 0;
+	Tier Nucleus::tier = TIER_OPTIMIZED;
 	ExecutionEngine *Nucleus::executionEngine = 0;
 	Builder *Nucleus::builder = 0;
 	LLVMContext *Nucleus::context = 0;
@@ -76,6 +79,22 @@ namespace sw
 	{
 	};
 
+	namespace
+	{
+		Thread::LocalStorageKey tierKey = Thread::allocateLocalStorageKey();   // Holds the Tier, TIER_OPTIMIZED when unset
+	}
+
+	TierScope::TierScope(Tier tier)
+	{
+		previous = (Tier)(intptr_t)Thread::getLocalStorage(tierKey);
+		Thread::setLocalStorage(tierKey, (void*)(intptr_t)tier);
+	}
+
+	TierScope::~TierScope()
+	{
+		Thread::setLocalStorage(tierKey, (void*)(intptr_t)previous);
+	}
+
 	Nucleus::Nucleus()
 	{
 		codegenMutex.lock();   // Reactor and LLVM are currently not thread safe
@@ -90,6 +109,7 @@ namespace sw
 
 		module = new Module("", *context);
 		routineManager = new RoutineManager();
+		tier = (Tier)(intptr_t)Thread::getLocalStorage(tierKey);
 
 		#if defined(__x86_64__)
 			const char *architecture = "x86-64";
@@ -108,7 +128,9 @@ namespace sw
 
 		std::string error;
 		TargetMachine *targetMachine = EngineBuilder::selectTarget(module, architecture, "", MAttrs, Reloc::Default, CodeModel::JITDefault, &error);
-		executionEngine = JIT::createJIT(module, 0, routineManager, CodeGenOpt::Aggressive, true, targetMachine);
+		// The fast tier uses FastISel and the local register allocator, which halves code generation time
+		CodeGenOpt::Level level = (tier == TIER_FAST) ? CodeGenOpt::None : CodeGenOpt::Aggressive;
+		executionEngine = JIT::createJIT(module, 0, routineManager, level, true, targetMachine);
 
 		if(!builder)
 		{
@@ -142,6 +164,8 @@ namespace sw
 
 	Routine *Nucleus::acquireRoutine(const wchar_t *name, bool runOptimizations)
 	{
+		TraceScope scope("Nucleus::acquireRoutine");
+
 		if(builder->GetInsertBlock()->empty() || !builder->GetInsertBlock()->back().isTerminator())
 		{
 			Type *type = function->getReturnType();
@@ -176,13 +200,15 @@ namespace sw
 		}
 
 		void *entry = executionEngine->getPointerToFunction(function);
-		Routine *routine = routineManager->acquireRoutine(entry);
+		Routine *routine = routineManager->acquireRoutine(entry, tier);
 
 		if(CodeAnalystLogJITCode)
 		{
 			CodeAnalystLogJITCode(routine->getEntry(), routine->getCodeSize(), name);
 		}
 
+		PerfJIT::logRoutine(routine->getEntry(), routine->getCodeSize(), name);
+
 		return routine;
 	}
 
@@ -15,6 +15,7 @@
 #ifndef sw_Nucleus_hpp
 #define sw_Nucleus_hpp
 
+#include "Routine.hpp"
 #include "Common/Types.hpp"
 #include "Common/MutexLock.hpp"
 
@@ -65,6 +66,17 @@ namespace sw
 
 	extern Optimization optimization[10];
 
+	class TierScope   // Selects the tier of the routines generated by this thread
+	{
+	public:
+		TierScope(Tier tier);
+
+		~TierScope();
+
+	private:
+		Tier previous;
+	};
+
 	class Routine;
 	class RoutineManager;
 	class Builder;
@@ -222,6 +234,7 @@ namespace sw
 		static llvm::LLVMContext *context;
 		static llvm::Module *module;
 		static RoutineManager *routineManager;
+		static Tier tier;
 
 		static BackoffLock codegenMutex;
 	};
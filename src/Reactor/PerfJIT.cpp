@@ -0,0 +1,193 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "PerfJIT.hpp"
+
+#if defined(__linux__)
+	#include <elf.h>
+	#include <fcntl.h>
+	#include <stdint.h>
+	#include <stdio.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+#endif
+
+namespace sw
+{
+	int jitProfiling = JIT_PROFILING_NONE;
+
+#if defined(__linux__)
+	namespace
+	{
+		#if defined(__ANDROID__)
+			const char *directory = "/data/local/tmp";
+		#else
+			const char *directory = "/tmp";
+		#endif
+
+		// See tools/perf/Documentation/jitdump-specification.txt in the Linux sources
+		struct JitDumpHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t totalSize;
+			uint32_t elfMachine;
+			uint32_t padding;
+			uint32_t pid;
+			uint64_t timestamp;
+			uint64_t flags;
+		};
+
+		struct JitCodeLoad
+		{
+			uint32_t id;
+			uint32_t totalSize;
+			uint64_t timestamp;
+			uint32_t pid;
+			uint32_t tid;
+			uint64_t vma;
+			uint64_t codeAddress;
+			uint64_t codeSize;
+			uint64_t codeIndex;
+			// Followed by the null-terminated name and the code
+		};
+
+		// Only accessed while Nucleus holds the code generation lock
+		FILE *perfMap = nullptr;
+		FILE *jitDump = nullptr;
+		uint64_t codeIndex = 0;
+		bool initialized = false;
+
+		uint64_t timestamp()   // Must match perf's clock, which -k 1 selects
+		{
+			timespec time;
+			clock_gettime(CLOCK_MONOTONIC, &time);
+
+			return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+		}
+
+		void openPerfMap()
+		{
+			char path[256];
+			snprintf(path, sizeof(path), "%s/perf-%d.map", directory, getpid());
+
+			perfMap = fopen(path, "w");
+		}
+
+		void openJitDump()
+		{
+			char path[256];
+			snprintf(path, sizeof(path), "%s/jit-%d.dump", directory, getpid());
+
+			int file = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+
+			if(file < 0)
+			{
+				return;
+			}
+
+			// perf record only finds the dump through an executable mapping of it, which is kept until exit
+			size_t pageSize = sysconf(_SC_PAGESIZE);
+			void *marker = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, file, 0);
+
+			if(marker == MAP_FAILED)
+			{
+				close(file);
+				return;
+			}
+
+			jitDump = fdopen(file, "wb");
+
+			if(!jitDump)
+			{
+				close(file);
+				return;
+			}
+
+			JitDumpHeader header = {};
+			header.magic = 0x4A695444;   // "JiTD"
+			header.version = 1;
+			header.totalSize = sizeof(JitDumpHeader);
+			#if defined(__x86_64__)
+				header.elfMachine = EM_X86_64;
+			#else
+				header.elfMachine = EM_386;
+			#endif
+			header.pid = getpid();
+			header.timestamp = timestamp();
+
+			fwrite(&header, sizeof(header), 1, jitDump);
+			fflush(jitDump);
+		}
+	}
+
+	void PerfJIT::logRoutine(const void *code, size_t size, const wchar_t *name)
+	{
+		if(jitProfiling == JIT_PROFILING_NONE)
+		{
+			return;
+		}
+
+		if(!initialized)
+		{
+			if(jitProfiling & JIT_PROFILING_PERF_MAP) openPerfMap();
+			if(jitProfiling & JIT_PROFILING_JITDUMP) openJitDump();
+
+			initialized = true;
+		}
+
+		char ascii[1024 + 1];
+		size_t length = 0;
+
+		while(name[length] && length < sizeof(ascii) - 1)
+		{
+			ascii[length] = (name[length] >= 0x20 && name[length] < 0x7F) ? (char)name[length] : '?';
+			length++;
+		}
+
+		ascii[length] = '\0';
+
+		if(perfMap)
+		{
+			fprintf(perfMap, "%llx %llx %s\n", (unsigned long long)(uintptr_t)code, (unsigned long long)size, ascii);
+			fflush(perfMap);
+		}
+
+		if(jitDump)
+		{
+			JitCodeLoad record;
+			record.id = 0;   // JIT_CODE_LOAD
+			record.totalSize = (uint32_t)(sizeof(JitCodeLoad) + length + 1 + size);
+			record.timestamp = timestamp();
+			record.pid = getpid();
+			record.tid = (uint32_t)syscall(SYS_gettid);
+			record.vma = (uintptr_t)code;
+			record.codeAddress = (uintptr_t)code;
+			record.codeSize = size;
+			record.codeIndex = codeIndex++;
+
+			fwrite(&record, sizeof(record), 1, jitDump);
+			fwrite(ascii, length + 1, 1, jitDump);
+			fwrite(code, size, 1, jitDump);
+			fflush(jitDump);
+		}
+	}
+#else
+	void PerfJIT::logRoutine(const void *code, size_t size, const wchar_t *name)
+	{
+	}
+#endif
+}
@@ -0,0 +1,39 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_PerfJIT_hpp
+#define sw_PerfJIT_hpp
+
+#include <stddef.h>
+
+namespace sw
+{
+	enum JITProfiling
+	{
+		JIT_PROFILING_NONE = 0,
+		JIT_PROFILING_PERF_MAP = 1,   // /tmp/perf-<pid>.map, read by perf report
+		JIT_PROFILING_JITDUMP = 2,    // /tmp/jit-<pid>.dump, merged by perf inject --jit. Record with perf record -k 1.
+	};
+
+	extern int jitProfiling;   // Combination of JITProfiling flags
+
+	// Tells Linux profilers which routine occupies each range of generated code
+	class PerfJIT
+	{
+	public:
+		static void logRoutine(const void *code, size_t size, const wchar_t *name);
+	};
+}
+
+#endif   // sw_PerfJIT_hpp
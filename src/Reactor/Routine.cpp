@@ -14,6 +14,7 @@
 
 #include "Routine.hpp"
 
+#include "CodeHeap.hpp"
 #include "../Common/Memory.hpp"
 #include "../Common/Thread.hpp"
 #include "../Common/Types.hpp"
@@ -22,13 +23,15 @@ namespace sw
 {
 	Routine::Routine(int bufferSize) : bufferSize(bufferSize), dynamic(true)
 	{
-		void *memory = allocateExecutable(bufferSize);
+		void *memory = CodeHeap::allocate(bufferSize);
 
 		buffer = memory;
 		entry = memory;
 		functionSize = bufferSize;   // Updated by RoutineManager::endFunctionBody
 
 		bindCount = 0;
+		tier = TIER_OPTIMIZED;
+		uses = 0;
 	}
 
 	Routine::Routine(void *memory, int bufferSize, int offset) : bufferSize(bufferSize), functionSize(bufferSize), dynamic(false)
@@ -37,13 +40,15 @@ namespace sw
 		entry = memory;
 
 		bindCount = 0;
+		tier = TIER_OPTIMIZED;
+		uses = 0;
 	}
 
 	Routine::~Routine()
 	{
 		if(dynamic)
 		{
-			deallocateExecutable(buffer, bufferSize);
+			CodeHeap::free(buffer, bufferSize);
 		}
 	}
 
@@ -82,6 +87,16 @@ namespace sw
 		return dynamic;
 	}
 
+	Tier Routine::getTier()
+	{
+		return tier;
+	}
+
+	int Routine::incrementUses()
+	{
+		return ++uses;
+	}
+
 	void Routine::bind()
 	{
 		atomicIncrement(&bindCount);
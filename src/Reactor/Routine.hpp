@@ -19,6 +19,12 @@ namespace sw
 {
 	class RoutineManager;
 
+	enum Tier   // Code generation effort
+	{
+		TIER_OPTIMIZED,   // Default
+		TIER_FAST,        // Fast instruction selection and register allocation, for routines which may not be used much
+	};
+
 	class Routine
 	{
 		friend class RoutineManager;
@@ -37,6 +43,8 @@ namespace sw
 		int getFunctionSize();   // Includes constants before the entry point
 		int getCodeSize();       // Executable code only
 		bool isDynamic();
+		Tier getTier();
+		int incrementUses();   // Returns the new count, for deciding when to recompile at a higher tier
 
 		void bind();
 		void unbind();
@@ -49,6 +57,8 @@ namespace sw
 
 		volatile int bindCount;
 		const bool dynamic;   // Generated or precompiled
+		Tier tier;
+		int uses;
 	};
 }
 
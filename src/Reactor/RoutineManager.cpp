@@ -15,6 +15,7 @@
 #include "RoutineManager.hpp"
 
 #include "Routine.hpp"
+#include "CodeHeap.hpp"
 #include "llvm/Function.h"
 #include "../Common/Memory.hpp"
 #include "../Common/Thread.hpp"
@@ -64,7 +65,7 @@ namespace sw
 			sw::atomicIncrement(&averageInstructionSize);
 		}
 
-		// Round up to the next page size
+		// Round up to the next page size, like the estimate was tuned for. The unused part is returned to the heap afterwards.
 		size_t pageSize = memoryPageSize();
 		actualSize = (actualSize + pageSize - 1) & ~(pageSize - 1);
 
@@ -77,6 +78,7 @@ namespace sw
 	void RoutineManager::endFunctionBody(const llvm::Function *function, uint8_t *functionStart, uint8_t *functionEnd)
 	{
 		routine->setFunctionSize(functionEnd - functionStart);
+		routine->bufferSize = CodeHeap::shrink(routine->buffer, routine->bufferSize, functionEnd - functionStart);
 	}
 
 	uint8_t *RoutineManager::startExceptionTable(const llvm::Function* F, uintptr_t &ActualSize)
@@ -128,7 +130,7 @@ namespace sw
 
 	void RoutineManager::setMemoryExecutable()
 	{
-		markExecutable(routine->buffer, routine->bufferSize);
+		CodeHeap::markExecutable(routine->buffer, routine->bufferSize);
 	}
 
 	void RoutineManager::setPoisonMemory(bool poison)
@@ -136,9 +138,10 @@ namespace sw
 		UNIMPLEMENTED();
 	}
 
-	Routine *RoutineManager::acquireRoutine(void *entry)
+	Routine *RoutineManager::acquireRoutine(void *entry, Tier tier)
 	{
 		routine->entry = entry;
+		routine->tier = tier;
 
 		Routine *result = routine;
 		routine = 0;
@@ -15,6 +15,8 @@
 #ifndef sw_RoutineManager_hpp
 #define sw_RoutineManager_hpp
 
+#include "Routine.hpp"
+
 #include "llvm/GlobalValue.h"
 #include "llvm/ExecutionEngine/JITMemoryManager.h"
 
@@ -45,7 +47,7 @@ namespace sw
 		virtual void setMemoryExecutable();
 		virtual void setPoisonMemory(bool poison);
 
-		Routine *acquireRoutine(void *entry);
+		Routine *acquireRoutine(void *entry, Tier tier);
 
 	private:
 		Routine *routine;
@@ -15,6 +15,7 @@
 #include "Blitter.hpp"
 
 #include "Common/Debug.hpp"
+#include "Common/Trace.hpp"
 #include "Reactor/Reactor.hpp"
 
 namespace sw
@@ -48,13 +49,21 @@ namespace sw
 
 	void Blitter::blit(Surface *source, const SliceRect &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options& options)
 	{
+		TraceScope scope("Blitter::blit");
+
 		if(dest->getInternalFormat() == FORMAT_NULL)
 		{
 			return;
 		}
 
-		if(blitReactor(source, sourceRect, dest, destRect, options))
+		Command command;
+
+		if(prepare(command, source, sourceRect, dest, destRect, options))
 		{
+			lock(command, PUBLIC);
+			execute(command, command.data.y0d, command.data.y1d);
+			unlock(command);
+
 			return;
 		}
 
@@ -76,7 +85,7 @@ namespace sw
 		}
 
 		source->lockInternal(sRect.x0, sRect.y0, sRect.slice, sw::LOCK_READONLY, sw::PUBLIC);
-		dest->lockInternal(dRect.x0, dRect.y0, dRect.slice, sw::LOCK_WRITEONLY, sw::PUBLIC);
+		dest->lockInternal(dRect.x0, dRect.y0, dRect.slice, sw::LOCK_WRITEONLY, sw::PUBLIC, &dRect);
 
 		float w = static_cast<float>(sRect.x1 - sRect.x0) / static_cast<float>(dRect.x1 - dRect.x0);
 		float h = static_cast<float>(sRect.y1 - sRect.y0) / static_cast<float>(dRect.y1 - dRect.y0);
@@ -1208,13 +1217,46 @@ namespace sw
 			}
 		}
 
-		return function(L"BlitRoutine");
+		return function(L"BlitRoutine<%d->%d,%0.2X>", state.sourceFormat, state.destFormat, state.options);
+	}
+
+	bool Blitter::prepareClear(Command &command, void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask)
+	{
+		if(dest->isExternalDirty())
+		{
+			return false;
+		}
+
+		sw::Surface color(1, 1, 1, format, pixel, sw::Surface::bytes(format), sw::Surface::bytes(format));
+		Blitter::Options clearOptions = static_cast<sw::Blitter::Options>((rgbaMask & 0xF) | CLEAR_OPERATION);
+		SliceRect sRect(dRect);
+		sRect.slice = 0;
+
+		return prepare(command, &color, sRect, dest, dRect, clearOptions);
+	}
+
+	bool Blitter::prepareBlit(Command &command, Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter)
+	{
+		// Deferred blits run in bands of rows, which would race when reading rows written by another band
+		if(source == dest || source->isExternalDirty() || dest->isExternalDirty())
+		{
+			return false;
+		}
+
+		Blitter::Options options = filter ? static_cast<Blitter::Options>(WRITE_RGBA | FILTER_LINEAR) : WRITE_RGBA;
+
+		return prepare(command, source, sRect, dest, dRect, options);
 	}
 
-	bool Blitter::blitReactor(Surface *source, const SliceRect &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options& options)
+	bool Blitter::prepare(Command &command, Surface *source, const SliceRect &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options& options)
 	{
 		ASSERT(!(options & CLEAR_OPERATION) || ((source->getWidth() == 1) && (source->getHeight() == 1) && (source->getDepth() == 1)));
 
+		if(dest->getInternalFormat() == FORMAT_NULL)
+		{
+			return false;
+		}
+
 		Rect dRect = destRect;
 		Rect sRect = sourceRect;
 		if(destRect.x0 > destRect.x1)
@@ -1237,33 +1279,48 @@ namespace sw
 		state.destFormat = dest->getFormat(useDestInternal);
 		state.options = options;
 
-		criticalSection.lock();
-		Routine *blitRoutine = blitCache->query(state);
+		bool clear = (options & CLEAR_OPERATION) != 0;
+		bool isRGBA = ((options & WRITE_RGBA) == WRITE_RGBA);
+		bool unscaled = (sRect.x1 - sRect.x0 == dRect.x1 - dRect.x0) && (abs(sRect.y1 - sRect.y0) == dRect.y1 - dRect.y0);   // Vertical flips are fine
+		bool copy = !clear && isRGBA && unscaled && state.sourceFormat == state.destFormat && !Surface::isCompressed(state.destFormat);
+
+		command.path = clear && isRGBA ? Command::PATH_FILL : (copy ? Command::PATH_COPY : Command::PATH_ROUTINE);
+		command.routine = nullptr;
+		command.bytes = Surface::bytes(state.destFormat);
+
+		if(command.bytes == 0 || command.bytes > (int)sizeof(command.color))
+		{
+			return false;
+		}
 
-		if(!blitRoutine)
+		if(command.path != Command::PATH_COPY)
 		{
-			blitRoutine = generate(state);
+			criticalSection.lock();
+			Routine *blitRoutine = blitCache->query(state);
 
 			if(!blitRoutine)
 			{
-				criticalSection.unlock();
-				return false;
-			}
+				blitRoutine = generate(state);
 
-			blitCache->add(state, blitRoutine);
-		}
+				if(!blitRoutine)
+				{
+					criticalSection.unlock();
+					return false;
+				}
 
-		criticalSection.unlock();
+				blitCache->add(state, blitRoutine);
+			}
 
-		void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))blitRoutine->getEntry();
+			blitRoutine->bind();   // Keep it alive if evicted before the command executes
+			criticalSection.unlock();
 
-		BlitData data;
+			command.routine = blitRoutine;
+		}
 
-		bool isRGBA = ((options & WRITE_RGBA) == WRITE_RGBA);
-		bool isEntireDest = dest->isEntire(destRect);
+		BlitData &data = command.data;
 
-		data.source = source->lock(0, 0, sourceRect.slice, sw::LOCK_READONLY, sw::PUBLIC, useSourceInternal);
-		data.dest = dest->lock(0, 0, destRect.slice, isRGBA ? (isEntireDest ? sw::LOCK_DISCARD : sw::LOCK_WRITEONLY) : sw::LOCK_READWRITE, sw::PUBLIC, useDestInternal);
+		data.source = nullptr;
+		data.dest = nullptr;
 		data.sPitchB = source->getPitchB(useSourceInternal);
 		data.dPitchB = dest->getPitchB(useDestInternal);
 
@@ -1280,11 +1337,147 @@ namespace sw
 		data.sWidth = source->getWidth();
 		data.sHeight = source->getHeight();
 
-		blitFunction(&data);
+		if(clear)
+		{
+			// The caller's clear color may not outlive the command
+			memset(command.color, 0, sizeof(command.color));
+			memcpy(command.color, source->lock(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC, useSourceInternal), Surface::bytes(state.sourceFormat));
+			source->unlock(useSourceInternal);
+
+			if(command.path == Command::PATH_FILL)
+			{
+				// Convert a single pixel, and replicate it when executing
+				unsigned char pixel[sizeof(command.color)] = {};
+				BlitData convert = data;
+
+				convert.source = command.color;
+				convert.dest = pixel;
+				convert.x0d = 0;
+				convert.x1d = 1;
+				convert.y0d = 0;
+				convert.y1d = 1;
+
+				void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))command.routine->getEntry();
+				blitFunction(&convert);
 
-		source->unlock(useSourceInternal);
-		dest->unlock(useDestInternal);
+				memcpy(command.color, pixel, sizeof(command.color));
+			}
+
+			source = nullptr;
+		}
+
+		bool isEntireDest = dest->isEntire(destRect);
+
+		command.source = source;
+		command.dest = dest;
+		command.sourceSlice = sourceRect.slice;
+		command.destSlice = destRect.slice;
+		command.useSourceInternal = useSourceInternal;
+		command.useDestInternal = useDestInternal;
+		command.destLock = isRGBA ? (isEntireDest ? sw::LOCK_DISCARD : sw::LOCK_WRITEONLY) : sw::LOCK_READWRITE;
 
 		return true;
 	}
+
+	void Blitter::lock(Command &command, Accessor client)
+	{
+		if(command.source)
+		{
+			command.data.source = command.source->lock(0, 0, command.sourceSlice, sw::LOCK_READONLY, client, command.useSourceInternal);
+		}
+		else
+		{
+			command.data.source = command.color;
+		}
+
+		Rect region(command.data.x0d, command.data.y0d, command.data.x1d, command.data.y1d);
+		command.data.dest = command.dest->lock(0, 0, command.destSlice, command.destLock, client, command.useDestInternal, &region);
+	}
+
+	void Blitter::execute(const Command &command, int y0, int y1)
+	{
+		const BlitData &data = command.data;
+
+		y0 = max(y0, data.y0d);
+		y1 = min(y1, data.y1d);
+
+		if(y0 >= y1 || data.x0d >= data.x1d)
+		{
+			return;
+		}
+
+		int widthB = (data.x1d - data.x0d) * command.bytes;
+		unsigned char *dest = (unsigned char*)data.dest + y0 * data.dPitchB + data.x0d * command.bytes;
+
+		switch(command.path)
+		{
+		case Command::PATH_ROUTINE:
+			{
+				BlitData band = data;
+
+				band.y0d = y0;
+				band.y1d = y1;
+				band.y0 = data.y0 + (y0 - data.y0d) * data.h;
+
+				void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))command.routine->getEntry();
+				blitFunction(&band);
+			}
+			break;
+		case Command::PATH_COPY:
+			{
+				const unsigned char *source = (const unsigned char*)data.source + (int)data.x0 * command.bytes;
+
+				for(int y = y0; y < y1; y++)
+				{
+					int sy = (int)(data.y0 + (y - data.y0d) * data.h);
+
+					memcpy(dest, source + sy * data.sPitchB, widthB);
+					dest += data.dPitchB;
+				}
+			}
+			break;
+		case Command::PATH_FILL:
+			{
+				// Build the first row by doubling, which lets memcpy use its widest stores
+				memcpy(dest, command.color, command.bytes);
+
+				for(int filled = command.bytes; filled < widthB; filled *= 2)
+				{
+					memcpy(dest + filled, dest, min(filled, widthB - filled));
+				}
+
+				for(int y = y0 + 1; y < y1; y++)
+				{
+					memcpy(dest + data.dPitchB, dest, widthB);
+					dest += data.dPitchB;
+				}
+			}
+			break;
+		default:
+			ASSERT(false);
+		}
+	}
+
+	void Blitter::unlock(Command &command)
+	{
+		if(command.source)
+		{
+			command.source->unlock(command.useSourceInternal);
+		}
+
+		command.dest->unlock(command.useDestInternal);
+
+		if(command.routine)
+		{
+			command.routine->unbind();
+		}
+	}
+
+	void Blitter::discard(Command &command)
+	{
+		if(command.routine)
+		{
+			command.routine->unbind();
+		}
+	}
 }
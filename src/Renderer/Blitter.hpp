@@ -49,6 +49,7 @@ namespace sw
 			Blitter::Options options;
 		};
 
+	public:
 		struct BlitData
 		{
 			void *source;
@@ -70,7 +71,33 @@ namespace sw
 			int sHeight;
 		};
 
-	public:
+		// A blit or clear which has been set up for execution in bands of destination
+		// rows. Once both surfaces are locked, the bands can run on any thread.
+		struct Command
+		{
+			enum Path
+			{
+				PATH_ROUTINE,   // Generated blit routine
+				PATH_COPY,      // Same format, unscaled and not mirrored horizontally
+				PATH_FILL       // Clear of all channels with the color converted up front
+			};
+
+			Path path;
+			Routine *routine;   // Bound until unlock(), if any
+			BlitData data;      // Buffers are filled in by lock()
+			int bytes;          // Destination pixel size
+
+			unsigned char color[16];   // Clear color, already in the destination format for PATH_FILL
+
+			Surface *source;   // Null for clears
+			Surface *dest;
+			int sourceSlice;
+			int destSlice;
+			bool useSourceInternal;
+			bool useDestInternal;
+			Lock destLock;
+		};
+
 		Blitter();
 
 		virtual ~Blitter();
@@ -79,6 +106,15 @@ namespace sw
 		void blit(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter);
 		void blit3D(Surface *source, Surface *dest);
 
+		// Return false if the operation can't be deferred, in which case clear() or blit() has to be used
+		bool prepareClear(Command &command, void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask);
+		bool prepareBlit(Command &command, Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter);
+
+		static void lock(Command &command, Accessor client);
+		static void execute(const Command &command, int y0, int y1);   // Clipped to the destination rectangle
+		static void unlock(Command &command);
+		static void discard(Command &command);   // Releases a command that was prepared but won't be locked
+
 	private:
 		bool read(Float4 &color, Pointer<Byte> element, Format format);
 		bool write(Float4 &color, Pointer<Byte> element, Format format, const Blitter::Options& options);
@@ -87,7 +123,7 @@ namespace sw
 		static bool GetScale(float4& scale, Format format);
 		static bool ApplyScaleAndClamp(Float4& value, const BlitState& state);
 		void blit(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, const Blitter::Options& options);
-		bool blitReactor(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, const Blitter::Options& options);
+		bool prepare(Command &command, Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, const Blitter::Options& options);
 		Routine *generate(BlitState &state);
 
 		RoutineCache<BlitState> *blitCache;
@@ -43,6 +43,8 @@ namespace sw
 	bool exactColorRounding = false;
 	TransparencyAntialiasing transparencyAntialiasing = TRANSPARENCY_NONE;
 	bool forceClearRegisters = false;
+	bool compressedTextureSampling = false;   // DXT and ETC1 textures are decoded by the sampler
+	int tierUpThreshold = 0;   // Routines start at the fast tier and are regenerated optimized after this many draws. Zero disables.
 
 	Context::Context()
 	{
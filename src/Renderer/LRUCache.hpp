@@ -124,6 +124,20 @@ namespace sw
 	template<class Key, class Data>
 	Data *LRUCache<Key, Data>::add(const Key &key, Data *data)
 	{
+		for(int i = top; i > top - fill; i--)   // Replacing an entry, like a routine regenerated at a higher tier
+		{
+			int j = i & mask;
+
+			if(key == *ref[j])
+			{
+				data->bind();
+				this->data[j]->unbind();
+				this->data[j] = data;
+
+				return data;
+			}
+		}
+
 		top = (top + 1) & mask;
 		fill = fill + 1 < size ? fill + 1 : size;
 
@@ -21,7 +21,10 @@
 #include "Primitive.hpp"
 #include "Constants.hpp"
 #include "Debug.hpp"
+#include "Counters.hpp"
+#include "Timer.hpp"
 
+#include <memory>
 #include <string.h>
 
 namespace sw
@@ -29,6 +32,7 @@ namespace sw
 	extern bool complementaryDepthBuffer;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool perspectiveCorrection;
+	extern int tierUpThreshold;
 
 	bool precachePixel = false;
 
@@ -150,12 +154,11 @@ namespace sw
 		uniformBufferInfo[index].offset = offset;
 	}
 
-	void PixelProcessor::lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[])
+	void PixelProcessor::useUniformBuffers(byte** u, int64_t serial)
 	{
 		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; ++i)
 		{
-			u[i] = uniformBufferInfo[i].buffer ? static_cast<byte*>(uniformBufferInfo[i].buffer->lock(PUBLIC, PRIVATE)) + uniformBufferInfo[i].offset : nullptr;
-			uniformBuffers[i] = uniformBufferInfo[i].buffer;
+			u[i] = uniformBufferInfo[i].buffer ? static_cast<byte*>(uniformBufferInfo[i].buffer->use(serial)) + uniformBufferInfo[i].offset : nullptr;
 		}
 	}
 
@@ -1114,28 +1117,55 @@ namespace sw
 
 	Routine *PixelProcessor::routine(const State &state)
 	{
+		routineCache->update();
+
 		Routine *routine = routineCache->query(state);
 
 		if(!routine)
 		{
-			const bool integerPipeline = (context->pixelShaderVersion() <= 0x0104);
-			QuadRasterizer *generator = nullptr;
+			TierScope tier(tierUpThreshold > 0 ? TIER_FAST : TIER_OPTIMIZED);
 
-			if(integerPipeline)
-			{
-				generator = new PixelPipeline(state, context->pixelShader);
-			}
-			else
+			routine = generate(state, context->pixelShader, context->pixelShaderVersion() <= 0x0104);
+			routineCache->add(state, routine);
+
+			Counters::increment(COUNTER_ROUTINE_MISSES);
+		}
+		else
+		{
+			if(routine->getTier() == TIER_FAST && routine->incrementUses() == tierUpThreshold)
 			{
-				generator = new PixelProgram(state, context->pixelShader);
+				// Copy the shader, as it may be deleted before the background compile gets to it
+				std::shared_ptr<PixelShader> shader(context->pixelShader ? new PixelShader(context->pixelShader) : nullptr);
+				const bool integerPipeline = (context->pixelShaderVersion() <= 0x0104);
+
+				routineCache->tierUp(state, [=]() { return generate(state, shader.get(), integerPipeline); });
 			}
 
-			generator->generate();
-			routine = (*generator)(L"PixelRoutine_%0.8X", state.shaderID);
-			delete generator;
+			Counters::increment(COUNTER_ROUTINE_HITS);
+		}
 
-			routineCache->add(state, routine);
+		return routine;
+	}
+
+	Routine *PixelProcessor::generate(const State &state, const PixelShader *shader, bool integerPipeline)
+	{
+		int64_t startTime = Timer::counter();
+		QuadRasterizer *generator = nullptr;
+
+		if(integerPipeline)
+		{
+			generator = new PixelPipeline(state, shader);
 		}
+		else
+		{
+			generator = new PixelProgram(state, shader);
+		}
+
+		generator->generate();
+		Routine *routine = (*generator)(L"PixelRoutine<%0.8X,%0.8X>", state.shaderID, state.hash);
+		delete generator;
+
+		Counters::add(COUNTER_JIT_MICROSECONDS, (Timer::counter() - startTime) * 1000000 / Timer::frequency());
 
 		return routine;
 	}
@@ -194,7 +194,7 @@ namespace sw
 		virtual void setBooleanConstant(unsigned int index, int boolean);
 
 		virtual void setUniformBuffer(int index, sw::Resource* buffer, int offset);
-		virtual void lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[]);
+		virtual void useUniformBuffers(byte** u, int64_t serial);
 
 		virtual void setRenderTarget(int index, Surface *renderTarget);
 		virtual void setDepthBuffer(Surface *depthBuffer);
@@ -298,6 +298,7 @@ namespace sw
 	protected:
 		const State update() const;
 		Routine *routine(const State &state);
+		static Routine *generate(const State &state, const PixelShader *shader, bool integerPipeline);   // Also called on the tier-up thread
 		void setRoutineCacheSize(int routineCacheSize);
 
 		// Shader constants
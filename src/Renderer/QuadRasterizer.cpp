@@ -49,6 +49,7 @@ namespace sw
 
 		constants = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,constants));
 		occlusion = 0;
+		pixels = 0;
 
 		Do
 		{
@@ -77,6 +78,8 @@ namespace sw
 			*Pointer<UInt>(data + OFFSET(DrawData,occlusion) + 4 * cluster) = clusterOcclusion;
 		}
 
+		*Pointer<UInt>(data + OFFSET(DrawData,pixels) + 4 * cluster) = pixels;
+
 		#if PERF_PROFILE
 			cycles[PERF_PIXEL] = Ticks() - pixelTime;
 
@@ -286,6 +289,15 @@ namespace sw
 						cMask[q] = SignMask(Pack(mask, mask)) & 0x0000000F;
 					}
 
+					Int coverage = cMask[0];
+
+					for(unsigned int q = 1; q < state.multiSample; q++)
+					{
+						coverage |= cMask[q];
+					}
+
+					pixels += *Pointer<UInt>(constants + OFFSET(Constants,occlusionCount) + 4 * coverage);   // Pixels of the quad covered by any sample
+
 					quad(cBuffer, zBuffer, sBuffer, cMask, x, y);
 				}
 			}
@@ -40,6 +40,7 @@ namespace sw
 		Float4 Df;
 
 		UInt occlusion;
+		UInt pixels;
 
 #if PERF_PROFILE
 		Long cycles[PERF_TIMERS];
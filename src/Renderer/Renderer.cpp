@@ -27,13 +27,18 @@
 #include "CPUID.hpp"
 #include "Memory.hpp"
 #include "Resource.hpp"
+#include "Counters.hpp"
+#include "Trace.hpp"
 #include "Constants.hpp"
 #include "Debug.hpp"
 #include "Reactor/Reactor.hpp"
+#include "Reactor/PerfJIT.hpp"
+
+#include <emmintrin.h>
 
 #undef max
 
-bool disableServer = true;
+bool disableServer = true;   // Unless SwiftShader.ini sets DisableServer=0
 
 #ifndef NDEBUG
 unsigned int minPrimitives = 1;
@@ -55,6 +60,8 @@ namespace sw
 	extern bool exactColorRounding;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool forceClearRegisters;
+	extern bool compressedTextureSampling;
+	extern int tierUpThreshold;
 
 	extern bool precacheVertex;
 	extern bool precacheSetup;
@@ -79,12 +86,19 @@ namespace sw
 
 	DrawCall::DrawCall()
 	{
-		queries = 0;
+		queryCount = 0;
+		resolve = false;
+		blit = false;
+		upload = nullptr;
+		barrier = 0;
+		dependency = 0;
 
+		vsDirtyConstFMin = 0;
 		vsDirtyConstF = VERTEX_UNIFORM_VECTORS + 1;
 		vsDirtyConstI = 16;
 		vsDirtyConstB = 16;
 
+		psDirtyConstFMin = 0;
 		psDirtyConstF = FRAGMENT_UNIFORM_VECTORS;
 		psDirtyConstI = 16;
 		psDirtyConstB = 16;
@@ -97,8 +111,6 @@ namespace sw
 
 	DrawCall::~DrawCall()
 	{
-		delete queries;
-
 		deallocate(data);
 	}
 
@@ -120,6 +132,10 @@ namespace sw
 		updateProjectionMatrix = true;
 		updateClipPlanes = true;
 
+		vertexRoutine = 0;
+		setupRoutine = 0;
+		pixelRoutine = 0;
+
 		#if PERF_HUD
 			resetTimers();
 		#endif
@@ -169,12 +185,17 @@ namespace sw
 		swiftConfig = new SwiftConfig(disableServer);
 		updateConfiguration(true);
 
-		sync = new Resource(0);
+		queryCount = 0;
+		lastSerial = 0;
+		dependency = 0;
+		dependencyTask = false;
+		lastBarrier = 0;
+		pendingUploads = 0;
 	}
 
 	Renderer::~Renderer()
 	{
-		sync->destruct();
+		Timeline::wait(lastSerial);
 
 		delete clipper;
 		clipper = 0;
@@ -192,12 +213,38 @@ namespace sw
 
 	void Renderer::clear(void *pixel, Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask)
 	{
-		blitter.clear(pixel, format, dest, dRect, rgbaMask);
+		Blitter::Command command;
+
+		if(blitter.prepareClear(command, pixel, format, dest, dRect, rgbaMask))
+		{
+			if(command.path == Blitter::Command::PATH_FILL && dest->isEntire(dRect) && dest->fastClear(command.color, command.bytes))
+			{
+				Blitter::discard(command);
+			}
+			else
+			{
+				dispatchBlit(command);
+			}
+		}
+		else
+		{
+			blitter.clear(pixel, format, dest, dRect, rgbaMask);
+		}
 	}
 
 	void Renderer::blit(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter)
 	{
-		blitter.blit(source, sRect, dest, dRect, filter);
+		Blitter::Command command;
+
+		if(blitter.prepareBlit(command, source, sRect, dest, dRect, filter))
+		{
+			resolve(source);
+			dispatchBlit(command);
+		}
+		else
+		{
+			blitter.blit(source, sRect, dest, dRect, filter);
+		}
 	}
 
 	void Renderer::blit3D(Surface *source, Surface *dest)
@@ -214,6 +261,11 @@ namespace sw
 			}
 		#endif
 
+		TraceScope scope("Renderer::draw");
+
+		Counters::increment(COUNTER_DRAWS);
+		Counters::add(COUNTER_PRIMITIVES, count);
+
 		context->drawType = drawType;
 
 		updateConfiguration();
@@ -222,6 +274,15 @@ namespace sw
 		int ss = context->getSuperSampleCount();
 		int ms = context->getMultiSampleCount();
 
+		if(update)
+		{
+			vertexState = VertexProcessor::update(drawType);
+			setupState = SetupProcessor::update();
+
+			vertexRoutine = VertexProcessor::routine(vertexState);
+			setupRoutine = SetupProcessor::routine(setupState);
+		}
+
 		for(int q = 0; q < ss; q++)
 		{
 			unsigned int oldMultiSampleMask = context->multiSampleMask;
@@ -232,20 +293,10 @@ namespace sw
 				continue;
 			}
 
-			sync->lock(sw::PRIVATE);
-
-			Routine *vertexRoutine;
-			Routine *setupRoutine;
-			Routine *pixelRoutine;
-
+			// Only the pixel stage depends on which group of samples is being rendered
 			if(update || oldMultiSampleMask != context->multiSampleMask)
 			{
-				vertexState = VertexProcessor::update(drawType);
-				setupState = SetupProcessor::update();
 				pixelState = PixelProcessor::update();
-
-				vertexRoutine = VertexProcessor::routine(vertexState);
-				setupRoutine = SetupProcessor::routine(setupState);
 				pixelRoutine = PixelProcessor::routine(pixelState);
 			}
 
@@ -280,47 +331,32 @@ namespace sw
 				setupPrimitives = &Renderer::setupPoints;
 			}
 
-			DrawCall *draw = 0;
-
-			do
-			{
-				for(int i = 0; i < DRAW_COUNT; i++)
-				{
-					if(drawCall[i]->references == -1)
-					{
-						draw = drawCall[i];
-						drawList[nextDraw % DRAW_COUNT] = draw;
-
-						break;
-					}
-				}
+			DrawCall *draw = acquireDrawCall();
+			DrawData *data = draw->data;
 
-				if(!draw)
-				{
-					resumeApp->wait();
-				}
-			}
-			while(!draw);
+			draw->serial = Timeline::submit();
+			lastSerial = draw->serial;
 
-			DrawData *data = draw->data;
+			draw->queryCount = 0;
+			bool includePrimitivesWrittenQueries = vertexState.transformFeedbackQueryEnabled && vertexState.transformFeedbackEnabled;
 
-			if(queries.size() != 0)
+			for(int i = 0; i < queryCount; i++)
 			{
-				draw->queries = new std::list<Query*>();
-				bool includePrimitivesWrittenQueries = vertexState.transformFeedbackQueryEnabled && vertexState.transformFeedbackEnabled;
-				for(std::list<Query*>::iterator query = queries.begin(); query != queries.end(); query++)
+				Query *query = queries[i];
+
+				if(includePrimitivesWrittenQueries || (query->type != Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN))
 				{
-					Query* q = *query;
-					if(includePrimitivesWrittenQueries || (q->type != Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN))
-					{
-						atomicIncrement(&(q->reference));
-						draw->queries->push_back(q);
-					}
+					query->serial = draw->serial;
+					draw->queries[draw->queryCount++] = query;
 				}
 			}
 
 			draw->drawType = drawType;
 			draw->batchSize = batch;
+			draw->resolve = false;
+			draw->blit = false;
+			draw->upload = nullptr;
+			draw->barrier = uploadBarrier();
 
 			vertexRoutine->bind();
 			setupRoutine->bind();
@@ -337,34 +373,26 @@ namespace sw
 
 			for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 			{
-				draw->vertexStream[i] = context->input[i].resource;
 				data->input[i] = context->input[i].buffer;
 				data->stride[i] = context->input[i].stride;
 
-				if(draw->vertexStream[i])
+				if(context->input[i].resource)
 				{
-					draw->vertexStream[i]->lock(PUBLIC, PRIVATE);
+					context->input[i].resource->use(draw->serial);
 				}
 			}
 
 			if(context->indexBuffer)
 			{
-				data->indices = (unsigned char*)context->indexBuffer->lock(PUBLIC, PRIVATE) + indexOffset;
-			}
-
-			draw->indexBuffer = context->indexBuffer;
-
-			for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
-			{
-				draw->texture[sampler] = 0;
+				data->indices = (unsigned char*)context->indexBuffer->use(draw->serial) + indexOffset;
 			}
 
 			for(int sampler = 0; sampler < TEXTURE_IMAGE_UNITS; sampler++)
 			{
 				if(pixelState.sampler[sampler].textureType != TEXTURE_NULL)
 				{
-					draw->texture[sampler] = context->texture[sampler];
-					draw->texture[sampler]->lock(PUBLIC, isReadWriteTexture(sampler) ? MANAGED : PRIVATE);   // If the texure is both read and written, use the same read/write lock as render targets
+					context->texture[sampler]->use(draw->serial);
+					Counters::add(COUNTER_TEXTURE_BYTES, context->sampler[sampler].getTextureBytes());
 
 					data->mipmap[sampler] = context->sampler[sampler].getTextureData();
 				}
@@ -374,8 +402,16 @@ namespace sw
 			{
 				if(draw->psDirtyConstF)
 				{
-					memcpy(&data->ps.cW, PixelProcessor::cW, sizeof(word4) * 4 * (draw->psDirtyConstF < 8 ? draw->psDirtyConstF : 8));
-					memcpy(&data->ps.c, PixelProcessor::c, sizeof(float4) * draw->psDirtyConstF);
+					int first = draw->psDirtyConstFMin;
+					int last = draw->psDirtyConstF;
+
+					if(first < 8)
+					{
+						memcpy(&data->ps.cW[first], &PixelProcessor::cW[first], sizeof(word4) * 4 * ((last < 8 ? last : 8) - first));
+					}
+
+					memcpy(&data->ps.c[first], &PixelProcessor::c[first], sizeof(float4) * (last - first));
+					draw->psDirtyConstFMin = FRAGMENT_UNIFORM_VECTORS;
 					draw->psDirtyConstF = 0;
 				}
 
@@ -391,14 +427,7 @@ namespace sw
 					draw->psDirtyConstB = 0;
 				}
 
-				PixelProcessor::lockUniformBuffers(data->ps.u, draw->pUniformBuffers);
-			}
-			else
-			{
-				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
-				{
-					draw->pUniformBuffers[i] = nullptr;
-				}
+				PixelProcessor::useUniformBuffers(data->ps.u, draw->serial);
 			}
 
 			if(context->pixelShaderVersion() <= 0x0104)
@@ -421,8 +450,8 @@ namespace sw
 					{
 						if(vertexState.samplerState[sampler].textureType != TEXTURE_NULL)
 						{
-							draw->texture[TEXTURE_IMAGE_UNITS + sampler] = context->texture[TEXTURE_IMAGE_UNITS + sampler];
-							draw->texture[TEXTURE_IMAGE_UNITS + sampler]->lock(PUBLIC, PRIVATE);
+							context->texture[TEXTURE_IMAGE_UNITS + sampler]->use(draw->serial);
+							Counters::add(COUNTER_TEXTURE_BYTES, context->sampler[TEXTURE_IMAGE_UNITS + sampler].getTextureBytes());
 
 							data->mipmap[TEXTURE_IMAGE_UNITS + sampler] = context->sampler[TEXTURE_IMAGE_UNITS + sampler].getTextureData();
 						}
@@ -431,7 +460,11 @@ namespace sw
 
 				if(draw->vsDirtyConstF)
 				{
-					memcpy(&data->vs.c, VertexProcessor::c, sizeof(float4) * draw->vsDirtyConstF);
+					int first = draw->vsDirtyConstFMin;
+					int last = draw->vsDirtyConstF;
+
+					memcpy(&data->vs.c[first], &VertexProcessor::c[first], sizeof(float4) * (last - first));
+					draw->vsDirtyConstFMin = VERTEX_UNIFORM_VECTORS + 1;
 					draw->vsDirtyConstF = 0;
 				}
 
@@ -452,26 +485,17 @@ namespace sw
 					data->instanceID = context->instanceID;
 				}
 
-				VertexProcessor::lockUniformBuffers(data->vs.u, draw->vUniformBuffers);
-				VertexProcessor::lockTransformFeedbackBuffers(data->vs.t, data->vs.reg, data->vs.row, data->vs.col, data->vs.str, draw->transformFeedbackBuffers);
+				VertexProcessor::useUniformBuffers(data->vs.u, draw->serial);
+				VertexProcessor::useTransformFeedbackBuffers(data->vs.t, data->vs.reg, data->vs.row, data->vs.col, data->vs.str, draw->serial);
 			}
 			else
 			{
 				data->ff = ff;
 
+				draw->vsDirtyConstFMin = 0;
 				draw->vsDirtyConstF = VERTEX_UNIFORM_VECTORS + 1;
 				draw->vsDirtyConstI = 16;
 				draw->vsDirtyConstB = 16;
-
-				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
-				{
-					draw->vUniformBuffers[i] = nullptr;
-				}
-
-				for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
-				{
-					draw->transformFeedbackBuffers[i] = nullptr;
-				}
 			}
 
 			if(pixelState.stencilActive)
@@ -582,6 +606,24 @@ namespace sw
 				data->halfPixelX = replicate(0.5f / W);
 				data->halfPixelY = replicate(0.5f / H);
 				data->viewportHeight = abs(viewport.height);
+
+				// Solid triangles within the guard band only get clipped against the depth range and user planes.
+				// The edge setup handles coordinates up to GUARD_BAND pixels from the origin without overflowing.
+				float guardX0 = -1.0f, guardX1 = 1.0f;
+				float guardY0 = -1.0f, guardY1 = 1.0f;
+
+				if(W != 0 && H != 0)
+				{
+					guardX0 = min(guardX0, min((-GUARD_BAND - X0 + 0.5f) / W, (GUARD_BAND - X0 + 0.5f) / W));
+					guardX1 = max(guardX1, max((-GUARD_BAND - X0 + 0.5f) / W, (GUARD_BAND - X0 + 0.5f) / W));
+					guardY0 = min(guardY0, min((-GUARD_BAND - Y0 + 0.5f) / H, (GUARD_BAND - Y0 + 0.5f) / H));
+					guardY1 = max(guardY1, max((-GUARD_BAND - Y0 + 0.5f) / H, (GUARD_BAND - Y0 + 0.5f) / H));
+				}
+
+				data->guardBandX0 = replicate(guardX0);
+				data->guardBandX1 = replicate(guardX1);
+				data->guardBandY0 = replicate(guardY0);
+				data->guardBandY1 = replicate(guardY1);
 				data->slopeDepthBias = slopeDepthBias;
 				data->depthRange = Z;
 				data->depthNear = N;
@@ -598,15 +640,42 @@ namespace sw
 				}
 			}
 
+			// Scissor
+			{
+				data->scissorX0 = scissor.x0;
+				data->scissorX1 = scissor.x1;
+				data->scissorY0 = scissor.y0;
+				data->scissorY1 = scissor.y1;
+
+				// Solid triangles within the guard band aren't clipped to the viewport, so the rasterizer has to clip them to the scissor rectangle,
+				// which is narrowed to the viewport here. Wide points and lines may still extend beyond the viewport.
+				if(setupPrimitives == &Renderer::setupSolidTriangles)
+				{
+					float viewportY0 = min(viewport.y0, viewport.y0 + viewport.height);
+					float viewportY1 = max(viewport.y0, viewport.y0 + viewport.height);
+
+					data->scissorX0 = max(scissor.x0, (int)ceil(viewport.x0 - 0.5f));
+					data->scissorX1 = min(scissor.x1, (int)ceil(viewport.x0 + viewport.width - 0.5f));
+					data->scissorY0 = max(scissor.y0, (int)ceil(viewportY0 - 0.5f));
+					data->scissorY1 = min(scissor.y1, (int)ceil(viewportY1 - 0.5f));
+				}
+			}
+
 			// Target
 			{
+				// Only pixels within the scissor rectangle get written, unless a deferred clear comes along
+				Rect region(data->scissorX0, data->scissorY0, data->scissorX1, data->scissorY1);
+
 				for(int index = 0; index < RENDERTARGETS; index++)
 				{
 					draw->renderTarget[index] = context->renderTarget[index];
+					draw->renderTargetClear[index].pending = false;
 
 					if(draw->renderTarget[index])
 					{
-						data->colorBuffer[index] = (unsigned int*)context->renderTarget[index]->lockInternal(0, 0, q * ms, LOCK_READWRITE, MANAGED);
+						draw->renderTargetClear[index] = context->renderTarget[index]->takeClear();
+						const Rect *written = draw->renderTargetClear[index].pending ? nullptr : &region;
+						data->colorBuffer[index] = (unsigned int*)context->renderTarget[index]->lockInternal(0, 0, q * ms, LOCK_READWRITE, MANAGED, written);
 						data->colorPitchB[index] = context->renderTarget[index]->getInternalPitchB();
 						data->colorSliceB[index] = context->renderTarget[index]->getInternalSliceB();
 					}
@@ -614,59 +683,343 @@ namespace sw
 
 				draw->depthBuffer = context->depthBuffer;
 				draw->stencilBuffer = context->stencilBuffer;
+				draw->depthClear.pending = false;
+				draw->stencilClear.pending = false;
 
 				if(draw->depthBuffer)
 				{
-					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, q * ms, LOCK_READWRITE, MANAGED);
+					draw->depthClear = context->depthBuffer->takeClear();
+					const Rect *written = draw->depthClear.pending ? nullptr : &region;
+					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, q * ms, LOCK_READWRITE, MANAGED, written);
 					data->depthPitchB = context->depthBuffer->getInternalPitchB();
 					data->depthSliceB = context->depthBuffer->getInternalSliceB();
 				}
 
 				if(draw->stencilBuffer)
 				{
+					draw->stencilClear = context->stencilBuffer->takeStencilClear();
 					data->stencilBuffer = (unsigned char*)context->stencilBuffer->lockStencil(q * ms, MANAGED);
 					data->stencilPitchB = context->stencilBuffer->getStencilPitchB();
 					data->stencilSliceB = context->stencilBuffer->getStencilSliceB();
 				}
 			}
 
-			// Scissor
-			{
-				data->scissorX0 = scissor.x0;
-				data->scissorX1 = scissor.x1;
-				data->scissorY0 = scissor.y0;
-				data->scissorY1 = scissor.y1;
-			}
-
 			draw->primitive = 0;
 			draw->count = count;
 
 			draw->references = (count + batch - 1) / batch;
 
-			schedulerMutex.lock();
-			nextDraw++;
-			schedulerMutex.unlock();
+			dispatchDrawCall();
+		}
+	}
+
+	void Renderer::resolve(Surface *renderTarget)
+	{
+		if(!renderTarget->requiresResolve())
+		{
+			return;
+		}
+
+		TraceScope scope("Renderer::resolve");
+
+		DrawCall *draw = acquireDrawCall();
+
+		draw->serial = Timeline::submit();
+		lastSerial = draw->serial;
+
+		// Runs as a single primitive whose pixel tasks each average the rows of their cluster,
+		// ordered after all previous draws into the same rows.
+		draw->resolve = true;
+		draw->blit = false;
+		draw->upload = nullptr;
+		draw->barrier = lastBarrier;
+		draw->batchSize = 1;
+		draw->vertexRoutine = 0;
+		draw->setupRoutine = 0;
+		draw->pixelRoutine = 0;
+
+		draw->renderTarget[0] = renderTarget;
+		draw->resolveRect = renderTarget->getUnresolvedRect();
+		renderTarget->lockInternal(0, 0, 0, LOCK_READWRITE, MANAGED, &draw->resolveRect);
+		renderTarget->markResolved();
+
+		for(int index = 1; index < RENDERTARGETS; index++)
+		{
+			draw->renderTarget[index] = 0;
+		}
+
+		draw->depthBuffer = 0;
+		draw->stencilBuffer = 0;
 
-			if(threadCount > 1)
+		draw->primitive = 0;
+		draw->count = 1;
+		draw->references = 1;
+
+		dispatchDrawCall();
+	}
+
+	void Renderer::dispatchBlit(const Blitter::Command &command)
+	{
+		TraceScope scope("Renderer::blit");
+
+		updateConfiguration();   // Starts the worker threads if this precedes any draw
+
+		DrawCall *draw = acquireDrawCall();
+
+		draw->serial = Timeline::submit();
+		lastSerial = draw->serial;
+
+		// Runs as a single primitive whose pixel tasks each handle a band of rows. The bands don't
+		// line up with the rows owned by each cluster, and the surfaces may be sampled by later draws,
+		// so all previous work has to complete first, and later work waits for the blit.
+		draw->resolve = false;
+		draw->blit = true;
+		draw->upload = nullptr;
+		draw->blitCommand = command;
+		Blitter::lock(draw->blitCommand, MANAGED);
+
+		draw->barrier = nextDraw;
+		lastBarrier = nextDraw + 1;
+
+		draw->batchSize = 1;
+		draw->vertexRoutine = 0;
+		draw->setupRoutine = 0;
+		draw->pixelRoutine = 0;
+
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			draw->renderTarget[index] = 0;
+		}
+
+		draw->depthBuffer = 0;
+		draw->stencilBuffer = 0;
+
+		draw->primitive = 0;
+		draw->count = 1;
+		draw->references = 1;
+
+		dispatchDrawCall();
+	}
+
+	void Renderer::upload(Upload *upload)
+	{
+		TraceScope scope("Renderer::upload");
+
+		updateConfiguration();   // Starts the worker threads if this precedes any draw
+
+		Surface *dest = upload->dest;
+		Resource *resource = dest->getResource();
+
+		retireUploads();
+
+		if(pendingUploads == DRAW_COUNT)
+		{
+			Timeline::wait(pendingUpload[0].serial);
+			retireUploads();
+		}
+
+		DrawCall *draw = acquireDrawCall();
+
+		draw->serial = Timeline::submit();
+		lastSerial = draw->serial;
+
+		// Draws in flight which sample any level of the texture, or render to this level, have to
+		// complete first. So do uploads to an overlapping region. Other work can run concurrently.
+		int barrier = lastBarrier;
+		int64_t lastUse = resource->lastUse();
+
+		for(int index = nextDraw - 1; index > nextDraw - DRAW_COUNT && index >= barrier; index--)
+		{
+			DrawCall *previous = drawList[index % DRAW_COUNT];
+
+			if(previous->upload)
+			{
+				continue;
+			}
+
+			bool target = previous->depthBuffer == dest || previous->stencilBuffer == dest;
+
+			for(int i = 0; i < RENDERTARGETS; i++)
+			{
+				target = target || previous->renderTarget[i] == dest;
+			}
+
+			if(target || previous->serial <= lastUse)   // Serials increase with the draw index
+			{
+				barrier = index + 1;
+				break;
+			}
+		}
+
+		for(int i = 0; i < pendingUploads; i++)
+		{
+			const PendingUpload &pending = pendingUpload[i];
+
+			if(pending.dest == dest && pending.z0 < upload->z1 && upload->z0 < pending.z1 &&
+			   pending.rect.x0 < upload->rect.x1 && upload->rect.x0 < pending.rect.x1 &&
+			   pending.rect.y0 < upload->rect.y1 && upload->rect.y0 < pending.rect.y1)
+			{
+				barrier = max(barrier, pending.draw + 1);
+			}
+		}
+
+		PendingUpload &pending = pendingUpload[pendingUploads++];
+		pending.dest = dest;
+		pending.resource = resource;
+		pending.rect = upload->rect;
+		pending.z0 = upload->z0;
+		pending.z1 = upload->z1;
+		pending.draw = nextDraw;
+		pending.serial = draw->serial;
+
+		// Runs as a single primitive whose pixel tasks each write a band of rows. The destination is
+		// held like a render target, so synchronous access by the application waits for the upload.
+		SliceRect rect(upload->rect);
+		rect.slice = upload->z0;
+		bool entire = dest->isEntire(rect) && upload->z1 - upload->z0 == dest->getDepth();
+
+		draw->resolve = false;
+		draw->blit = false;
+		draw->upload = upload;
+		draw->barrier = barrier;
+		draw->batchSize = 1;
+		draw->vertexRoutine = 0;
+		draw->setupRoutine = 0;
+		draw->pixelRoutine = 0;
+
+		draw->renderTarget[0] = dest;
+		draw->data->colorBuffer[0] = (unsigned int*)dest->lockInternal(0, 0, 0, entire ? LOCK_DISCARD : LOCK_WRITEONLY, MANAGED, &upload->rect);
+
+		for(int index = 1; index < RENDERTARGETS; index++)
+		{
+			draw->renderTarget[index] = 0;
+		}
+
+		draw->depthBuffer = 0;
+		draw->stencilBuffer = 0;
+
+		draw->primitive = 0;
+		draw->count = 1;
+		draw->references = 1;
+
+		Counters::increment(COUNTER_DEFERRED_UPLOADS);
+
+		dispatchDrawCall();
+	}
+
+	int Renderer::uploadBarrier()
+	{
+		if(pendingUploads == 0)
+		{
+			return lastBarrier;
+		}
+
+		retireUploads();
+
+		int barrier = lastBarrier;
+
+		for(int i = 0; i < pendingUploads; i++)
+		{
+			const PendingUpload &pending = pendingUpload[i];
+			bool access = false;
+
+			for(int sampler = 0; sampler < TEXTURE_IMAGE_UNITS; sampler++)
 			{
-				if(!threadsAwake)
+				access = access || (pixelState.sampler[sampler].textureType != TEXTURE_NULL && context->texture[sampler] == pending.resource);
+			}
+
+			for(int sampler = 0; sampler < VERTEX_TEXTURE_IMAGE_UNITS; sampler++)
+			{
+				access = access || (vertexState.samplerState[sampler].textureType != TEXTURE_NULL && context->texture[TEXTURE_IMAGE_UNITS + sampler] == pending.resource);
+			}
+
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				access = access || context->renderTarget[index] == pending.dest;
+			}
+
+			access = access || context->depthBuffer == pending.dest || context->stencilBuffer == pending.dest;
+
+			if(access)
+			{
+				barrier = max(barrier, pending.draw + 1);
+			}
+		}
+
+		return barrier;
+	}
+
+	void Renderer::retireUploads()
+	{
+		int retired = 0;
+
+		while(retired < pendingUploads && Timeline::retired(pendingUpload[retired].serial))
+		{
+			retired++;
+		}
+
+		if(retired > 0)
+		{
+			pendingUploads -= retired;
+			memmove(pendingUpload, pendingUpload + retired, pendingUploads * sizeof(PendingUpload));
+		}
+	}
+
+	DrawCall *Renderer::acquireDrawCall()
+	{
+		DrawCall *draw = 0;
+
+		do
+		{
+			for(int i = 0; i < DRAW_COUNT; i++)
+			{
+				if(drawCall[i]->references == -1)
 				{
-					suspend[0]->wait();
+					draw = drawCall[i];
+					drawList[nextDraw % DRAW_COUNT] = draw;
 
-					threadsAwake = 1;
-					task[0].type = Task::RESUME;
+					draw->dependency = dependency;
+					dependency = 0;
 
-					resume[0]->signal();
+					break;
 				}
 			}
-			else   // Use main thread for draw execution
+
+			if(!draw)
 			{
+				resumeApp->wait();
+			}
+		}
+		while(!draw);
+
+		return draw;
+	}
+
+	void Renderer::dispatchDrawCall()
+	{
+		schedulerMutex.lock();
+		nextDraw++;
+		schedulerMutex.unlock();
+
+		if(threadCount > 1)
+		{
+			if(!threadsAwake)
+			{
+				suspend[0]->wait();
+
 				threadsAwake = 1;
 				task[0].type = Task::RESUME;
 
-				taskLoop(0);
+				resume[0]->signal();
 			}
 		}
+		else   // Use main thread for draw execution
+		{
+			threadsAwake = 1;
+			task[0].type = Task::RESUME;
+
+			taskLoop(0);
+		}
 	}
 
 	void Renderer::threadFunction(void *parameters)
@@ -705,6 +1058,13 @@ namespace sw
 
 	void Renderer::findAvailableTasks()
 	{
+		int slowestCluster = pixelProgress[0].drawCall;
+
+		for(int cluster = 1; cluster < clusterCount; cluster++)
+		{
+			slowestCluster = min(slowestCluster, (int)pixelProgress[cluster].drawCall);
+		}
+
 		// Find pixel tasks
 		for(int cluster = 0; cluster < clusterCount; cluster++)
 		{
@@ -714,7 +1074,8 @@ namespace sw
 				{
 					if(primitiveProgress[unit].references > 0)   // Contains processed primitives
 					{
-						if(pixelProgress[cluster].drawCall == primitiveProgress[unit].drawCall)
+						if(pixelProgress[cluster].drawCall == primitiveProgress[unit].drawCall &&
+						   drawList[primitiveProgress[unit].drawCall % DRAW_COUNT]->barrier <= slowestCluster)
 						{
 							if(pixelProgress[cluster].processedPrimitives == primitiveProgress[unit].firstPrimitive)   // Previous primitives have been rendered
 							{
@@ -759,6 +1120,34 @@ namespace sw
 				draw = drawList[currentDraw % DRAW_COUNT];
 			}
 
+			if(draw->barrier > slowestCluster)
+			{
+				return;   // Vertex texture fetches could read rows of an unfinished copy
+			}
+
+			if(draw->dependency)
+			{
+				if(!Timeline::retired(draw->dependency))
+				{
+					if(!dependencyTask)   // Have one thread block until the other renderer is done
+					{
+						Task &task = taskQueue[qHead];
+						task.type = Task::DEPENDENCY;
+						task.dependency = draw->dependency;
+
+						dependencyTask = true;
+
+						qHead = (qHead + 1) % 32;
+						qSize++;
+					}
+
+					return;
+				}
+
+				draw->dependency = 0;
+				dependencyTask = false;
+			}
+
 			if(!primitiveProgress[unit].references)   // Task not already being executed and not still in use by a pixel unit
 			{
 				int primitive = draw->primitive;
@@ -828,14 +1217,14 @@ namespace sw
 
 	void Renderer::executeTask(int threadIndex)
 	{
-		#if PERF_HUD
-			int64_t startTick = Timer::ticks();
-		#endif
+		int64_t startTick = Timer::ticks();
 
 		switch(task[threadIndex].type)
 		{
 		case Task::PRIMITIVES:
 			{
+				TraceScope scope("Renderer::primitives");
+
 				int unit = task[threadIndex].primitiveUnit;
 
 				int input = primitiveProgress[unit].firstPrimitive;
@@ -843,13 +1232,21 @@ namespace sw
 				DrawCall *draw = drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
 				int (Renderer::*setupPrimitives)(int batch, int count) = draw->setupPrimitives;
 
+				if(draw->resolve || draw->blit || draw->upload)   // No geometry, just hand each cluster its rows
+				{
+					primitiveProgress[unit].visible = 1;
+					primitiveProgress[unit].references = clusterCount;
+					break;
+				}
+
 				processPrimitiveVertices(unit, input, count, draw->count, threadIndex);
 
+				int64_t time = Timer::ticks();
+				Counters::add(COUNTER_VERTEX_TICKS, time - startTick);
 				#if PERF_HUD
-					int64_t time = Timer::ticks();
 					vertexTime[threadIndex] += time - startTick;
-					startTick = time;
 				#endif
+				startTick = time;
 
 				int visible = 0;
 
@@ -861,34 +1258,90 @@ namespace sw
 				primitiveProgress[unit].visible = visible;
 				primitiveProgress[unit].references = clusterCount;
 
+				Counters::add(COUNTER_PRIMITIVES_CULLED, count - visible);
+
+				int64_t setupTicks = Timer::ticks() - startTick;
+				Counters::add(COUNTER_SETUP_TICKS, setupTicks);
 				#if PERF_HUD
-					setupTime[threadIndex] += Timer::ticks() - startTick;
+					setupTime[threadIndex] += setupTicks;
 				#endif
 			}
 			break;
 		case Task::PIXELS:
 			{
+				TraceScope scope("Renderer::pixels");
+
 				int unit = task[threadIndex].primitiveUnit;
 				int visible = primitiveProgress[unit].visible;
+				int cluster = task[threadIndex].pixelCluster;
+				DrawCall *draw = drawList[pixelProgress[cluster].drawCall % DRAW_COUNT];
+
+				if(primitiveProgress[unit].firstPrimitive == 0 && !draw->resolve && !draw->blit && !draw->upload)
+				{
+					// Write deferred clears while the rows are about to be rasterized anyway
+					for(int index = 0; index < RENDERTARGETS; index++)
+					{
+						if(draw->renderTargetClear[index].pending)
+						{
+							draw->renderTarget[index]->clearRows(draw->renderTargetClear[index], cluster, clusterCount);
+						}
+					}
+
+					if(draw->depthClear.pending)
+					{
+						draw->depthBuffer->clearRows(draw->depthClear, cluster, clusterCount);
+					}
+
+					if(draw->stencilClear.pending)
+					{
+						draw->stencilBuffer->clearStencilRows(draw->stencilClear, cluster, clusterCount);
+					}
+				}
 
 				if(visible > 0)
 				{
-					int cluster = task[threadIndex].pixelCluster;
 					Primitive *primitive = primitiveBatch[unit];
-					DrawCall *draw = drawList[pixelProgress[cluster].drawCall % DRAW_COUNT];
 					DrawData *data = draw->data;
 					PixelProcessor::RoutinePointer pixelRoutine = draw->pixelPointer;
 
-					pixelRoutine(primitive, visible, cluster, data);
+					if(draw->resolve)
+					{
+						draw->renderTarget[0]->resolve(draw->resolveRect, cluster, clusterCount);
+					}
+					else if(draw->blit)
+					{
+						const Blitter::Command &command = draw->blitCommand;
+						int rows = command.data.y1d - command.data.y0d;
+
+						Blitter::execute(command, command.data.y0d + rows * cluster / clusterCount, command.data.y0d + rows * (cluster + 1) / clusterCount);
+					}
+					else if(draw->upload)
+					{
+						const Rect &rect = draw->upload->rect;
+						int rows = rect.y1 - rect.y0;
+
+						draw->upload->execute(data->colorBuffer[0], rect.y0 + rows * cluster / clusterCount, rect.y0 + rows * (cluster + 1) / clusterCount);
+					}
+					else
+					{
+						pixelRoutine(primitive, visible, cluster, data);
+
+						Counters::add(COUNTER_PIXELS, data->pixels[cluster]);
+					}
 				}
 
 				finishRendering(task[threadIndex]);
 
+				int64_t pixelTicks = Timer::ticks() - startTick;
+				Counters::add(COUNTER_PIXEL_TICKS, pixelTicks);
 				#if PERF_HUD
-					pixelTime[threadIndex] += Timer::ticks() - startTick;
+					pixelTime[threadIndex] += pixelTicks;
 				#endif
 			}
 			break;
+		case Task::DEPENDENCY:
+			Timeline::wait(task[threadIndex].dependency);
+			break;
 		case Task::RESUME:
 			break;
 		case Task::SUSPEND:
@@ -900,12 +1353,26 @@ namespace sw
 
 	void Renderer::synchronize()
 	{
-		sync->lock(sw::PUBLIC);
-		sync->unlock();
+		Timeline::wait(lastSerial);
+	}
+
+	int64_t Renderer::getSerial() const
+	{
+		return lastSerial;
+	}
+
+	void Renderer::addDependency(int64_t serial)
+	{
+		if(!Timeline::retired(serial))
+		{
+			dependency = max(dependency, serial);
+		}
 	}
 
 	void Renderer::finishRendering(Task &pixelTask)
 	{
+		TraceScope scope("Renderer::finishRendering");
+
 		int unit = pixelTask.primitiveUnit;
 		int cluster = pixelTask.pixelCluster;
 
@@ -941,19 +1408,24 @@ namespace sw
 					}
 				#endif
 
-				if(draw.queries)
+				if(draw.queryCount)
 				{
-					for(std::list<Query*>::iterator q = draw.queries->begin(); q != draw.queries->end(); q++)
+					int occlusion = 0;
+
+					for(int cluster = 0; cluster < clusterCount; cluster++)
 					{
-						Query *query = *q;
+						occlusion += data.occlusion[cluster];
+					}
+
+					// Results become visible when the draw retires, so the sums only need to be atomic
+					for(int i = 0; i < draw.queryCount; i++)
+					{
+						Query *query = draw.queries[i];
 
 						switch(query->type)
 						{
 						case Query::FRAGMENTS_PASSED:
-							for(int cluster = 0; cluster < clusterCount; cluster++)
-							{
-								atomicAdd((volatile int*)&query->data, data.occlusion[cluster]);
-							}
+							atomicAdd((volatile int*)&query->data, occlusion);
 							break;
 						case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 							atomicAdd((volatile int*)&query->data, processedPrimitives);
@@ -961,12 +1433,9 @@ namespace sw
 						default:
 							break;
 						}
-
-						atomicDecrement(&query->reference);
 					}
 
-					delete draw.queries;
-					draw.queries = 0;
+					draw.queryCount = 0;
 				}
 
 				for(int i = 0; i < RENDERTARGETS; i++)
@@ -987,52 +1456,25 @@ namespace sw
 					draw.stencilBuffer->unlockStencil();
 				}
 
-				for(int i = 0; i < TOTAL_IMAGE_UNITS; i++)
+				if(draw.blit)
 				{
-					if(draw.texture[i])
-					{
-						draw.texture[i]->unlock();
-					}
-				}
-
-				for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
-				{
-					if(draw.vertexStream[i])
-					{
-						draw.vertexStream[i]->unlock();
-					}
+					Blitter::unlock(draw.blitCommand);
 				}
 
-				if(draw.indexBuffer)
+				if(!draw.resolve && !draw.blit && !draw.upload)
 				{
-					draw.indexBuffer->unlock();
-				}
-
-				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
-				{
-					if(draw.pUniformBuffers[i])
-					{
-						draw.pUniformBuffers[i]->unlock();
-					}
-					if(draw.vUniformBuffers[i])
-					{
-						draw.vUniformBuffers[i]->unlock();
-					}
+					draw.vertexRoutine->unbind();
+					draw.setupRoutine->unbind();
+					draw.pixelRoutine->unbind();
 				}
 
-				for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
+				if(draw.upload)
 				{
-					if(draw.transformFeedbackBuffers[i])
-					{
-						draw.transformFeedbackBuffers[i]->unlock();
-					}
+					delete draw.upload;   // Releases the source data
+					draw.upload = nullptr;
 				}
 
-				draw.vertexRoutine->unbind();
-				draw.setupRoutine->unbind();
-				draw.pixelRoutine->unbind();
-
-				sync->unlock();
+				Timeline::retire(draw.serial);
 
 				draw.references = -1;
 				resumeApp->signal();
@@ -1477,44 +1919,201 @@ namespace sw
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
 		SetupProcessor::State &state = draw.setupState;
-		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 
 		int ms = state.multiSample;
-		int pos = state.positionRegister;
-		const DrawData *data = draw.data;
 		int visible = 0;
+		int clipped = 0;
+		int backfacing = 0;
+		int scissored = 0;
 
-		for(int i = 0; i < count; i++, triangle++)
+		for(int i = 0; i < count; i += 4)
 		{
-			Vertex &v0 = triangle->v0;
-			Vertex &v1 = triangle->v1;
-			Vertex &v2 = triangle->v2;
+			unsigned int survivors = cullTriangles(&triangle[i], min(count - i, 4), draw, backfacing, scissored);
 
-			if((v0.clipFlags & v1.clipFlags & v2.clipFlags) == Clipper::CLIP_FINITE)
+			for(int j = 0; j < 4; j++)
 			{
-				Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
-
-				int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags;
-
-				if(clipFlagsOr != Clipper::CLIP_FINITE)
+				if(!(survivors & (1 << j)))
 				{
-					if(!clipper->clip(polygon, clipFlagsOr, draw))
-					{
-						continue;
-					}
+					continue;
 				}
 
-				if(setupRoutine(primitive, triangle, &polygon, data))
+				if(setupTriangle(primitive, &triangle[i + j], draw, clipped))
 				{
 					primitive += ms;
 					visible++;
 				}
 			}
+
+			#ifndef NDEBUG
+				// Culled triangles must not cover any pixels or samples when set up the regular way
+				for(int j = 0; j < min(count - i, 4); j++)
+				{
+					if(!(survivors & (1 << j)))
+					{
+						Primitive *culled = (Primitive*)allocate(ms * sizeof(Primitive));
+						bool covered = false;
+						int unclipped = 0;
+
+						if(setupTriangle(culled, &triangle[i + j], draw, unclipped))
+						{
+							for(int q = 0; q < ms; q++)
+							{
+								for(int y = culled->yMin; y < culled->yMax; y++)
+								{
+									covered |= culled[q].outline[y].left < culled[q].outline[y].right;
+								}
+							}
+						}
+
+						ASSERT(!covered);
+						deallocate(culled);
+					}
+				}
+			#endif
 		}
 
+		Counters::add(COUNTER_PRIMITIVES_CLIPPED, clipped);
+		Counters::add(COUNTER_PRIMITIVES_BACKFACING, backfacing);
+		Counters::add(COUNTER_PRIMITIVES_SCISSORED, scissored);
+
 		return visible;
 	}
 
+	bool Renderer::setupTriangle(Primitive *primitive, Triangle *triangle, const DrawCall &draw, int &clipped)
+	{
+		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
+		int pos = draw.setupState.positionRegister;
+
+		Vertex &v0 = triangle->v0;
+		Vertex &v1 = triangle->v1;
+		Vertex &v2 = triangle->v2;
+
+		if((v0.clipFlags & v1.clipFlags & v2.clipFlags & ~Clipper::CLIP_GUARD) != Clipper::CLIP_FINITE)
+		{
+			return false;
+		}
+
+		Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
+
+		int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags;
+
+		if(clipFlagsOr & Clipper::CLIP_GUARD)
+		{
+			clipFlagsOr &= ~Clipper::CLIP_GUARD;
+		}
+		else   // Leave the sides to the scissor rectangle
+		{
+			clipFlagsOr &= ~(Clipper::CLIP_LEFT | Clipper::CLIP_RIGHT | Clipper::CLIP_TOP | Clipper::CLIP_BOTTOM);
+		}
+
+		if(clipFlagsOr != Clipper::CLIP_FINITE)
+		{
+			clipped++;
+
+			if(!clipper->clip(polygon, clipFlagsOr, draw))
+			{
+				return false;
+			}
+		}
+
+		return setupRoutine(primitive, triangle, &polygon, draw.data);
+	}
+
+	// Culls up to four triangles at once, before clipping. The tests match those of
+	// the setup routine, or are conservative, so it still has the final say. Returns
+	// a mask of the triangles which have to be set up.
+	unsigned int Renderer::cullTriangles(const Triangle *triangle, int count, const DrawCall &draw, int &backfacing, int &scissored)
+	{
+		const SetupProcessor::State &state = draw.setupState;
+		const DrawData &data = *draw.data;
+		int pos = state.positionRegister;
+
+		int X[3][4], Y[3][4], W[3][4], flags[3][4];
+
+		for(int i = 0; i < 4; i++)
+		{
+			const Triangle &t = triangle[i < count ? i : 0];   // Unused lanes repeat the first triangle
+			const Vertex *v[3] = {&t.v0, &t.v1, &t.v2};
+
+			for(int j = 0; j < 3; j++)
+			{
+				X[j][i] = v[j]->X;
+				Y[j][i] = v[j]->Y;
+				W[j][i] = *(const int*)&v[j]->v[pos].w;
+				flags[j][i] = v[j]->clipFlags;
+			}
+		}
+
+		__m128i flags0 = _mm_loadu_si128((const __m128i*)flags[0]);
+		__m128i flags1 = _mm_loadu_si128((const __m128i*)flags[1]);
+		__m128i flags2 = _mm_loadu_si128((const __m128i*)flags[2]);
+		__m128i w0 = _mm_loadu_si128((const __m128i*)W[0]);
+		__m128i w1 = _mm_loadu_si128((const __m128i*)W[1]);
+		__m128i w2 = _mm_loadu_si128((const __m128i*)W[2]);
+
+		// All vertices outside the same frustum plane, or not finite
+		__m128i flagsAnd = _mm_and_si128(_mm_and_si128(flags0, flags1), flags2);
+		flagsAnd = _mm_and_si128(flagsAnd, _mm_set1_epi32(~Clipper::CLIP_GUARD));
+		unsigned int survivors = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(flagsAnd, _mm_set1_epi32(Clipper::CLIP_FINITE))));
+		survivors &= (1 << count) - 1;
+
+		__m128 x0 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)X[0]));
+		__m128 x1 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)X[1]));
+		__m128 x2 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)X[2]));
+		__m128 y0 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)Y[0]));
+		__m128 y1 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)Y[1]));
+		__m128 y2 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)Y[2]));
+
+		// Signed area, evaluated in the same order as the setup routine so the results are identical
+		__m128 A = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(y2, y0), x1), _mm_mul_ps(_mm_sub_ps(y1, y2), x0)), _mm_mul_ps(_mm_sub_ps(y0, y1), x2));
+		__m128i w0w1w2 = _mm_xor_si128(_mm_xor_si128(w0, w1), w2);
+		A = _mm_xor_ps(A, _mm_castsi128_ps(_mm_and_si128(w0w1w2, _mm_set1_epi32(0x80000000))));
+
+		__m128 zero = _mm_setzero_ps();
+		__m128 cull = _mm_cmpeq_ps(A, zero);
+
+		if(state.cullMode == CULL_CLOCKWISE)
+		{
+			cull = _mm_or_ps(cull, _mm_cmpge_ps(A, zero));
+		}
+		else if(state.cullMode == CULL_COUNTERCLOCKWISE)
+		{
+			cull = _mm_or_ps(cull, _mm_cmple_ps(A, zero));
+		}
+
+		unsigned int culled = survivors & _mm_movemask_ps(cull);
+		survivors &= ~culled;
+
+		// Projected coordinates are only meaningful in front of the eye and within the guard band. Clipping
+		// keeps the polygon within their bounds, up to a unit of rounding which the margins account for.
+		__m128i flagsOr = _mm_or_si128(_mm_or_si128(flags0, flags1), flags2);
+		__m128i inGuard = _mm_cmpeq_epi32(_mm_and_si128(flagsOr, _mm_set1_epi32(Clipper::CLIP_GUARD)), _mm_setzero_si128());
+		__m128i positive = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(w0, _mm_setzero_si128()), _mm_cmpgt_epi32(w1, _mm_setzero_si128())), _mm_cmpgt_epi32(w2, _mm_setzero_si128()));
+
+		__m128 xMin = _mm_min_ps(_mm_min_ps(x0, x1), x2);
+		__m128 xMax = _mm_max_ps(_mm_max_ps(x0, x1), x2);
+		__m128 yMin = _mm_min_ps(_mm_min_ps(y0, y1), y2);
+		__m128 yMax = _mm_max_ps(_mm_max_ps(y0, y1), y2);
+
+		// Rows and columns are covered from (min + 0x0A) >> 4 up to (max + 0x14) >> 4 at most, including multisample offsets
+		__m128 outside = _mm_cmplt_ps(xMax, _mm_set1_ps(16.0f * data.scissorX0 - 5.0f));
+		outside = _mm_or_ps(outside, _mm_cmpge_ps(xMin, _mm_set1_ps(16.0f * data.scissorX1 - 9.0f)));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(yMax, _mm_set1_ps(16.0f * data.scissorY0 - 5.0f)));
+		outside = _mm_or_ps(outside, _mm_cmpge_ps(yMin, _mm_set1_ps(16.0f * data.scissorY1 - 9.0f)));
+		outside = _mm_and_ps(outside, _mm_castsi128_ps(_mm_and_si128(inGuard, positive)));
+
+		unsigned int outsideScissor = survivors & _mm_movemask_ps(outside);
+		survivors &= ~outsideScissor;
+
+		for(int i = 0; i < 4; i++)
+		{
+			backfacing += (culled >> i) & 1;
+			scissored += (outsideScissor >> i) & 1;
+		}
+
+		return survivors;
+	}
+
 	int Renderer::setupWireframeTriangle(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
@@ -2118,24 +2717,6 @@ namespace sw
 		sw::transparencyAntialiasing = transparencyAntialiasing;
 	}
 
-	bool Renderer::isReadWriteTexture(int sampler)
-	{
-		for(int index = 0; index < RENDERTARGETS; index++)
-		{
-			if(context->renderTarget[index] && context->texture[sampler] == context->renderTarget[index]->getResource())
-			{
-				return true;
-			}
-		}
-
-		if(context->depthBuffer && context->texture[sampler] == context->depthBuffer->getResource())
-		{
-			return true;
-		}
-
-		return false;
-	}
-
 	void Renderer::updateClipper()
 	{
 		if(updateClipPlanes)
@@ -2395,6 +2976,11 @@ namespace sw
 	{
 		for(int i = 0; i < DRAW_COUNT; i++)
 		{
+			if(drawCall[i]->psDirtyConstFMin > index)
+			{
+				drawCall[i]->psDirtyConstFMin = index;
+			}
+
 			if(drawCall[i]->psDirtyConstF < index + count)
 			{
 				drawCall[i]->psDirtyConstF = index + count;
@@ -2446,6 +3032,11 @@ namespace sw
 	{
 		for(int i = 0; i < DRAW_COUNT; i++)
 		{
+			if(drawCall[i]->vsDirtyConstFMin > index)
+			{
+				drawCall[i]->vsDirtyConstFMin = index;
+			}
+
 			if(drawCall[i]->vsDirtyConstF < index + count)
 			{
 				drawCall[i]->vsDirtyConstF = index + count;
@@ -2516,14 +3107,36 @@ namespace sw
 		updateClipPlanes = true;
 	}
 
-	void Renderer::addQuery(Query *query)
+	bool Renderer::addQuery(Query *query)
 	{
-		queries.push_back(query);
+		for(int i = 0; i < queryCount; i++)
+		{
+			if(queries[i] == query)   // Restarted while active
+			{
+				return true;
+			}
+		}
+
+		if(queryCount == MAX_ACTIVE_QUERIES)
+		{
+			return false;
+		}
+
+		queries[queryCount++] = query;
+
+		return true;
 	}
 
 	void Renderer::removeQuery(Query *query)
 	{
-		queries.remove(query);
+		for(int i = 0; i < queryCount; i++)
+		{
+			if(queries[i] == query)
+			{
+				queries[i] = queries[--queryCount];   // Order doesn't matter
+				break;
+			}
+		}
 	}
 
 	#if PERF_HUD
@@ -2690,6 +3303,9 @@ namespace sw
 			postBlendSRGB = configuration.postBlendSRGB;
 			exactColorRounding = configuration.exactColorRounding;
 			forceClearRegisters = configuration.forceClearRegisters;
+			compressedTextureSampling = configuration.compressedTextureSampling;
+			jitProfiling = configuration.jitProfiling;
+			tierUpThreshold = configuration.tierUpThreshold;
 
 		#ifndef NDEBUG
 			minPrimitives = configuration.minPrimitives;
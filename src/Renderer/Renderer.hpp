@@ -21,11 +21,10 @@
 #include "Plane.hpp"
 #include "Blitter.hpp"
 #include "Common/MutexLock.hpp"
+#include "Common/Resource.hpp"
 #include "Common/Thread.hpp"
 #include "Main/Config.hpp"
 
-#include <list>
-
 namespace sw
 {
 	class Clipper;
@@ -91,12 +90,19 @@ namespace sw
 	{
 		enum Type { FRAGMENTS_PASSED, TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN };
 
-		Query(Type type) : building(false), reference(0), data(0), type(type)
+		Query(Type type) : building(false), serial(0), data(0), type(type)
+		{
+		}
+
+		~Query()
 		{
+			Timeline::wait(serial);   // Draws still accumulating into this query
 		}
 
 		void begin()
 		{
+			Timeline::wait(serial);
+
 			building = true;
 			data = 0;
 		}
@@ -106,8 +112,13 @@ namespace sw
 			building = false;
 		}
 
+		bool available() const
+		{
+			return !building && Timeline::retired(serial);
+		}
+
 		bool building;
-		volatile int reference;
+		int64_t serial;   // Last draw accumulating into this query, the result is available once it retired
 		volatile unsigned int data;
 
 		const Type type;
@@ -162,6 +173,7 @@ namespace sw
 		PixelProcessor::Fog fog;
 		PixelProcessor::Factor factor;
 		unsigned int occlusion[16];   // Number of pixels passing depth test
+		unsigned int pixels[16];      // Number of pixels covered by the last task
 
 		#if PERF_PROFILE
 			int64_t cycles[PERF_TIMERS][16];
@@ -177,6 +189,10 @@ namespace sw
 		float4 YYYY;
 		float4 halfPixelX;
 		float4 halfPixelY;
+		float4 guardBandX0;   // Guard band edges in normalized device coordinates
+		float4 guardBandX1;
+		float4 guardBandY0;
+		float4 guardBandY1;
 		float viewportHeight;
 		float slopeDepthBias;
 		float depthRange;
@@ -204,6 +220,23 @@ namespace sw
 		float4 a2c3;
 	};
 
+	// A write into a region of a surface's internal buffer, which the API layer hands to the
+	// worker threads. Each pixel cluster executes one band of the rows.
+	class Upload
+	{
+	public:
+		Upload(Surface *dest, const Rect &rect, int z0, int z1) : dest(dest), rect(rect), z0(z0), z1(z1) {}
+
+		virtual ~Upload() {}   // Deleted by the thread which completes the last band
+
+		virtual void execute(void *buffer, int y0, int y1) = 0;   // Rows [y0, y1) of the region, in the locked internal buffer
+
+		Surface *const dest;
+		const Rect rect;   // Written in slices z0 up to z1
+		const int z0;
+		const int z1;
+	};
+
 	struct DrawCall
 	{
 		DrawCall();
@@ -224,25 +257,38 @@ namespace sw
 		int (Renderer::*setupPrimitives)(int batch, int count);
 		SetupProcessor::State setupState;
 
-		Resource *vertexStream[MAX_VERTEX_INPUTS];
-		Resource *indexBuffer;
+		bool resolve;       // Average the samples of renderTarget[0] instead of drawing
+		Rect resolveRect;   // Bounds of the rows to average
+		bool blit;          // Execute blitCommand instead of drawing
+		Blitter::Command blitCommand;
+		Upload *upload;   // Execute upload instead of drawing, if not null
+
+		int barrier;   // Index of the draw call every pixel cluster has to reach before this one starts
+
+		int64_t serial;   // Timeline submission serial, stamped on every resource this draw reads or writes
+		int64_t dependency;   // Serial of other renderers' work which has to retire before this one starts
+
 		Surface *renderTarget[RENDERTARGETS];
 		Surface *depthBuffer;
 		Surface *stencilBuffer;
-		Resource *texture[TOTAL_IMAGE_UNITS];
-		Resource* pUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
-		Resource* vUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
-		Resource* transformFeedbackBuffers[MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS];
 
+		// Deferred clears, written by each pixel cluster before its first primitive
+		Surface::FastClear renderTargetClear[RENDERTARGETS];
+		Surface::FastClear depthClear;
+		Surface::FastClear stencilClear;
+
+		int vsDirtyConstFMin;   // Dirty float constants range from vsDirtyConstFMin up to vsDirtyConstF
 		int vsDirtyConstF;
 		int vsDirtyConstI;
 		int vsDirtyConstB;
 
+		int psDirtyConstFMin;
 		int psDirtyConstF;
 		int psDirtyConstI;
 		int psDirtyConstB;
 
-		std::list<Query*> *queries;
+		Query *queries[MAX_ACTIVE_QUERIES];
+		int queryCount;
 
 		int clipFlags;
 
@@ -271,6 +317,7 @@ namespace sw
 			{
 				PRIMITIVES,
 				PIXELS,
+				DEPENDENCY,
 
 				RESUME,
 				SUSPEND
@@ -279,6 +326,7 @@ namespace sw
 			volatile Type type;
 			volatile int primitiveUnit;
 			volatile int pixelCluster;
+			int64_t dependency;   // Serial a DEPENDENCY task waits for
 		};
 
 		struct PrimitiveProgress
@@ -322,6 +370,8 @@ namespace sw
 		virtual void blit(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter);
 		virtual void blit3D(Surface *source, Surface *dest);
 		virtual void draw(DrawType drawType, unsigned int indexOffset, unsigned int count, bool update = true);
+		virtual void resolve(Surface *renderTarget);
+		virtual void upload(Upload *upload);   // Takes ownership
 
 		virtual void setIndexBuffer(Resource *indexBuffer);
 
@@ -379,10 +429,12 @@ namespace sw
 		virtual void setBaseMatrix(const Matrix &B);
 		virtual void setProjectionMatrix(const Matrix &P);
 
-		virtual void addQuery(Query *query);
+		virtual bool addQuery(Query *query);   // False if MAX_ACTIVE_QUERIES are already active
 		virtual void removeQuery(Query *query);
 
 		void synchronize();
+		int64_t getSerial() const;   // Retires once all work submitted so far has completed
+		void addDependency(int64_t serial);   // Work submitted from now on starts after the serial retired
 
 		#if PERF_HUD
 			// Performance timers
@@ -397,6 +449,11 @@ namespace sw
 		static void threadFunction(void *parameters);
 		void threadLoop(int threadIndex);
 		void taskLoop(int threadIndex);
+		DrawCall *acquireDrawCall();
+		void dispatchDrawCall();
+		void dispatchBlit(const Blitter::Command &command);
+		int uploadBarrier();
+		void retireUploads();
 		void findAvailableTasks();
 		void scheduleTask(int threadIndex);
 		void executeTask(int threadIndex);
@@ -405,6 +462,8 @@ namespace sw
 		void processPrimitiveVertices(int unit, unsigned int start, unsigned int count, unsigned int loop, int thread);
 
 		int setupSolidTriangles(int batch, int count);
+		unsigned int cullTriangles(const Triangle *triangle, int count, const DrawCall &draw, int &backfacing, int &scissored);
+		bool setupTriangle(Primitive *primitive, Triangle *triangle, const DrawCall &draw, int &clipped);
 		int setupWireframeTriangle(int batch, int count);
 		int setupVertexTriangle(int batch, int count);
 		int setupLines(int batch, int count);
@@ -413,7 +472,6 @@ namespace sw
 		bool setupLine(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 		bool setupPoint(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 
-		bool isReadWriteTexture(int sampler);
 		void updateClipper();
 		void updateConfiguration(bool initialUpdate = false);
 		void initializeThreads();
@@ -453,6 +511,22 @@ namespace sw
 
 		volatile int currentDraw;
 		volatile int nextDraw;
+		int lastBarrier;   // Barrier for draw calls after the most recent blit
+
+		// Uploads which may still be executing. Later work waits for them only if it accesses their destination.
+		struct PendingUpload
+		{
+			Surface *dest;
+			Resource *resource;
+			Rect rect;
+			int z0;
+			int z1;
+			int draw;   // Index of the upload's draw call
+			int64_t serial;
+		};
+
+		PendingUpload pendingUpload[DRAW_COUNT];
+		int pendingUploads;
 
 		Task taskQueue[32];
 		unsigned int qHead;
@@ -470,12 +544,19 @@ namespace sw
 
 		SwiftConfig *swiftConfig;
 
-		std::list<Query*> queries;
-		Resource *sync;
+		Query *queries[MAX_ACTIVE_QUERIES];
+		int queryCount;
+		int64_t lastSerial;   // Most recent draw submitted by this renderer
+		int64_t dependency;   // For the next draw call
+		bool dependencyTask;   // A thread is waiting for the current draw call's dependency
 
 		VertexProcessor::State vertexState;
 		SetupProcessor::State setupState;
 		PixelProcessor::State pixelState;
+
+		Routine *vertexRoutine;
+		Routine *setupRoutine;
+		Routine *pixelRoutine;
 	};
 }
 
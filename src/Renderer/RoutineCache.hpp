@@ -18,6 +18,11 @@
 #include "LRUCache.hpp"
 
 #include "Reactor/Reactor.hpp"
+#include "Common/MutexLock.hpp"
+#include "Common/Thread.hpp"
+
+#include <deque>
+#include <functional>
 
 namespace sw
 {
@@ -28,7 +33,30 @@ namespace sw
 		RoutineCache(int n, const char *precache = 0);
 		~RoutineCache();
 
+		// Regenerates a routine at the optimized tier on a background thread,
+		// while draws keep using the cached one until update() swaps it out.
+		void tierUp(const State &state, const std::function<Routine*()> &generate);
+		void update();
+
 	private:
+		struct TierUp
+		{
+			State state;
+			std::function<Routine*()> generate;   // Owns copies of everything it needs
+			Routine *routine;
+		};
+
+		static void tierUpLoop(void *parameters);
+		void tierUpLoop();
+
+		Thread *tierUpThread;
+		Event tierUpEvent;
+		BackoffLock tierUpMutex;
+		std::deque<TierUp> pending;
+		std::deque<TierUp> finished;
+		volatile int finishedCount;
+		bool terminate;
+
 		const char *precache;
 		#if defined(_WIN32)
 		HMODULE precacheDLL;
@@ -46,6 +74,10 @@ namespace sw
 	template<class State>
 	RoutineCache<State>::RoutineCache(int n, const char *precache) : LRUCache<State, Routine>(n), precache(precache)
 	{
+		tierUpThread = nullptr;
+		finishedCount = 0;
+		terminate = false;
+
 		#if defined(_WIN32)
 			precacheDLL = 0;
 
@@ -93,6 +125,23 @@ namespace sw
 	template<class State>
 	RoutineCache<State>::~RoutineCache()
 	{
+		if(tierUpThread)
+		{
+			tierUpMutex.lock();
+			terminate = true;
+			tierUpMutex.unlock();
+
+			tierUpEvent.signal();
+			tierUpThread->join();
+			delete tierUpThread;
+			tierUpThread = nullptr;
+		}
+
+		for(TierUp &done : finished)
+		{
+			delete done.routine;   // Never bound
+		}
+
 		#if defined(_WIN32)
 			char dllName[1024]; sprintf(dllName, "%s.dll", precache);
 			char dirName[1024]; sprintf(dirName, "%s.dir", precache);
@@ -170,6 +219,93 @@ namespace sw
 			}
 		#endif
 	}
+
+	template<class State>
+	void RoutineCache<State>::tierUp(const State &state, const std::function<Routine*()> &generate)
+	{
+		TierUp job = {state, generate, nullptr};
+
+		tierUpMutex.lock();
+		pending.push_back(job);
+		tierUpMutex.unlock();
+
+		if(!tierUpThread)
+		{
+			tierUpThread = new Thread(tierUpLoop, this);
+		}
+
+		tierUpEvent.signal();
+	}
+
+	template<class State>
+	void RoutineCache<State>::update()
+	{
+		if(!finishedCount)
+		{
+			return;
+		}
+
+		tierUpMutex.lock();
+
+		while(!finished.empty())
+		{
+			TierUp &done = finished.front();
+			this->add(done.state, done.routine);   // In-flight draws keep their binding to the old routine
+			finished.pop_front();
+		}
+
+		finishedCount = 0;
+		tierUpMutex.unlock();
+	}
+
+	template<class State>
+	void RoutineCache<State>::tierUpLoop(void *parameters)
+	{
+		static_cast<RoutineCache<State>*>(parameters)->tierUpLoop();
+	}
+
+	template<class State>
+	void RoutineCache<State>::tierUpLoop()
+	{
+		while(true)
+		{
+			tierUpEvent.wait();
+
+			while(true)
+			{
+				tierUpMutex.lock();
+
+				if(terminate || pending.empty())
+				{
+					bool stop = terminate;
+					tierUpMutex.unlock();
+
+					if(stop)
+					{
+						return;   // Pending jobs are dropped with the cache
+					}
+
+					break;
+				}
+
+				TierUp job = pending.front();
+				pending.pop_front();
+				tierUpMutex.unlock();
+
+				{
+					TierScope tier(TIER_OPTIMIZED);
+					job.routine = job.generate();
+				}
+
+				job.generate = nullptr;
+
+				tierUpMutex.lock();
+				finished.push_back(job);
+				finishedCount++;
+				tierUpMutex.unlock();
+			}
+		}
+	}
 }
 
 #endif   // sw_RoutineCache_hpp
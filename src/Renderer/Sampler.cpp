@@ -378,6 +378,13 @@ namespace sw
 		return texture;
 	}
 
+	int64_t Sampler::getTextureBytes() const
+	{
+		const Mipmap &base = texture.mipmap[0];
+
+		return (int64_t)base.sliceP[0] * base.depth[0] * Surface::bytes(internalTextureFormat);
+	}
+
 	MipmapType Sampler::mipmapFilter() const
 	{
 		if(mipmapFilterState != MIPMAP_NONE)
@@ -189,6 +189,7 @@ namespace sw
 		bool hasVolumeTexture() const;
 
 		const Texture &getTextureData();
+		int64_t getTextureBytes() const;   // Footprint of the base level
 
 	private:
 		MipmapType mipmapFilter() const;
@@ -21,11 +21,14 @@
 #include "Renderer.hpp"
 #include "Constants.hpp"
 #include "Debug.hpp"
+#include "Counters.hpp"
+#include "Timer.hpp"
 
 namespace sw
 {
 	extern bool complementaryDepthBuffer;
 	extern bool fullPixelPositionRegister;
+	extern int tierUpThreshold;
 
 	bool precacheSetup = false;
 
@@ -224,21 +227,46 @@ namespace sw
 
 	Routine *SetupProcessor::routine(const State &state)
 	{
+		routineCache->update();
+
 		Routine *routine = routineCache->query(state);
 
 		if(!routine)
 		{
-			SetupRoutine *generator = new SetupRoutine(state);
-			generator->generate();
-			routine = generator->getRoutine();
-			delete generator;
+			TierScope tier(tierUpThreshold > 0 ? TIER_FAST : TIER_OPTIMIZED);
 
+			routine = generate(state);
 			routineCache->add(state, routine);
+
+			Counters::increment(COUNTER_ROUTINE_MISSES);
+		}
+		else
+		{
+			if(routine->getTier() == TIER_FAST && routine->incrementUses() == tierUpThreshold)
+			{
+				routineCache->tierUp(state, [=]() { return generate(state); });
+			}
+
+			Counters::increment(COUNTER_ROUTINE_HITS);
 		}
 
 		return routine;
 	}
 
+	Routine *SetupProcessor::generate(const State &state)
+	{
+		int64_t startTime = Timer::counter();
+
+		SetupRoutine *generator = new SetupRoutine(state);
+		generator->generate();
+		Routine *routine = generator->getRoutine();
+		delete generator;
+
+		Counters::add(COUNTER_JIT_MICROSECONDS, (Timer::counter() - startTime) * 1000000 / Timer::frequency());
+
+		return routine;
+	}
+
 	void SetupProcessor::setRoutineCacheSize(int cacheSize)
 	{
 		delete routineCache;
@@ -92,6 +92,7 @@ namespace sw
 	protected:
 		State update() const;
 		Routine *routine(const State &state);
+		static Routine *generate(const State &state);   // Also called on the tier-up thread
 
 		void setRoutineCacheSize(int cacheSize);
 
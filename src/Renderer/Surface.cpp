@@ -18,11 +18,13 @@
 #include "Context.hpp"
 #include "ETC_Decoder.hpp"
 #include "Renderer.hpp"
+#include "Common/Counters.hpp"
 #include "Common/Half.hpp"
 #include "Common/Memory.hpp"
 #include "Common/CPUID.hpp"
 #include "Common/Resource.hpp"
 #include "Common/Debug.hpp"
+#include "Common/Trace.hpp"
 #include "Reactor/Reactor.hpp"
 
 #include <xmmintrin.h>
@@ -35,6 +37,7 @@ namespace sw
 {
 	extern bool quadLayoutEnabled;
 	extern bool complementaryDepthBuffer;
+	extern bool compressedTextureSampling;
 	extern TranscendentalPrecision logPrecision;
 
 	unsigned int *Surface::palette = 0;
@@ -48,6 +51,14 @@ namespace sw
 		y1 = clamp(y1, minY, maxY);
 	}
 
+	void Rect::merge(const Rect &rect)
+	{
+		x0 = min(x0, rect.x0);
+		y0 = min(y0, rect.y0);
+		x1 = max(x1, rect.x1);
+		y1 = max(y1, rect.y1);
+	}
+
 	void Surface::Buffer::write(int x, int y, int z, const Color<float> &color)
 	{
 		void *element = (unsigned char*)buffer + x * bytes + y * pitchB + z * sliceB;
@@ -1066,7 +1077,7 @@ namespace sw
 		return c00 + c10 + c01 + c11;
 	}
 
-	void *Surface::Buffer::lockRect(int x, int y, int z, Lock lock)
+	void *Surface::Buffer::lockRect(int x, int y, int z, Lock lock, const Rect *region)
 	{
 		this->lock = lock;
 
@@ -1078,7 +1089,20 @@ namespace sw
 		case LOCK_WRITEONLY:
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
-			dirty = true;
+			{
+				Rect rect = region ? *region : Rect(0, 0, width, height);
+
+				if(dirty)
+				{
+					dirtyRect.merge(rect);
+				}
+				else
+				{
+					dirtyRect = rect;
+				}
+
+				dirty = true;
+			}
 			break;
 		default:
 			ASSERT(false);
@@ -1170,6 +1194,7 @@ namespace sw
 		resource = new Resource(0);
 		hasParent = false;
 		ownExternal = false;
+		ownInternal = true;
 		depth = max(1, depth);
 
 		external.buffer = pixels;
@@ -1184,6 +1209,7 @@ namespace sw
 		external.sliceP = external.bytes ? slice / external.bytes : 0;
 		external.lock = LOCK_UNLOCKED;
 		external.dirty = true;
+		external.dirtyRect = Rect(0, 0, width, height);
 
 		internal.buffer = 0;
 		internal.width = width;
@@ -1197,6 +1223,7 @@ namespace sw
 		internal.sliceP = sliceP(internal.width, internal.height, internal.format, false);
 		internal.lock = LOCK_UNLOCKED;
 		internal.dirty = false;
+		internal.dirtyRect = Rect(0, 0, width, height);
 
 		stencil.buffer = 0;
 		stencil.width = width;
@@ -1210,8 +1237,14 @@ namespace sw
 		stencil.sliceP = sliceP(stencil.width, stencil.height, stencil.format, false);
 		stencil.lock = LOCK_UNLOCKED;
 		stencil.dirty = false;
+		stencil.dirtyRect = Rect(0, 0, width, height);
 
 		dirtyMipmaps = true;
+		dirtyMipmapRect = Rect(0, 0, width, height);
+		resolved = false;
+		unresolvedRect = Rect(0, 0, width, height);
+		internalClear.pending = false;
+		stencilClear.pending = false;
 		paletteUsed = 0;
 	}
 
@@ -1220,6 +1253,7 @@ namespace sw
 		resource = texture ? texture : new Resource(0);
 		hasParent = texture != 0;
 		ownExternal = true;
+		ownInternal = true;
 		depth = max(1, depth);
 
 		external.buffer = 0;
@@ -1234,6 +1268,7 @@ namespace sw
 		external.sliceP = sliceP(external.width, external.height, external.format, renderTarget && !texture);
 		external.lock = LOCK_UNLOCKED;
 		external.dirty = false;
+		external.dirtyRect = Rect(0, 0, width, height);
 
 		internal.buffer = 0;
 		internal.width = width;
@@ -1247,6 +1282,7 @@ namespace sw
 		internal.sliceP = sliceP(internal.width, internal.height, internal.format, renderTarget);
 		internal.lock = LOCK_UNLOCKED;
 		internal.dirty = false;
+		internal.dirtyRect = Rect(0, 0, width, height);
 
 		stencil.buffer = 0;
 		stencil.width = width;
@@ -1260,8 +1296,14 @@ namespace sw
 		stencil.sliceP = sliceP(stencil.width, stencil.height, stencil.format, renderTarget);
 		stencil.lock = LOCK_UNLOCKED;
 		stencil.dirty = false;
+		stencil.dirtyRect = Rect(0, 0, width, height);
 
 		dirtyMipmaps = true;
+		dirtyMipmapRect = Rect(0, 0, width, height);
+		resolved = false;
+		unresolvedRect = Rect(0, 0, width, height);
+		internalClear.pending = false;
+		stencilClear.pending = false;
 		paletteUsed = 0;
 	}
 
@@ -1276,12 +1318,12 @@ namespace sw
 			resource->destruct();
 		}
 
-		if(ownExternal)
+		if(ownExternal && (ownInternal || external.buffer != internal.buffer))
 		{
 			deallocate(external.buffer);
 		}
 
-		if(internal.buffer != external.buffer)
+		if(ownInternal && internal.buffer != external.buffer)
 		{
 			deallocate(internal.buffer);
 		}
@@ -1293,8 +1335,13 @@ namespace sw
 		stencil.buffer = 0;
 	}
 
-	void *Surface::lockExternal(int x, int y, int z, Lock lock, Accessor client)
+	void *Surface::lockExternal(int x, int y, int z, Lock lock, Accessor client, const Rect *region)
 	{
+		if(internalClear.pending)
+		{
+			flushClear(internalClear);
+		}
+
 		resource->lock(client);
 
 		if(!external.buffer)
@@ -1313,6 +1360,7 @@ namespace sw
 		{
 			if(lock != LOCK_DISCARD)
 			{
+				resolve();
 				update(external, internal);
 			}
 
@@ -1326,13 +1374,13 @@ namespace sw
 		case LOCK_WRITEONLY:
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
-			dirtyMipmaps = true;
+			markMipmapsDirty(region ? *region : getRect());
 			break;
 		default:
 			ASSERT(false);
 		}
 
-		return external.lockRect(x, y, z, lock);
+		return external.lockRect(x, y, z, lock, region);
 	}
 
 	void Surface::unlockExternal()
@@ -1342,8 +1390,20 @@ namespace sw
 		external.unlockRect();
 	}
 
-	void *Surface::lockInternal(int x, int y, int z, Lock lock, Accessor client)
+	void *Surface::lockInternal(int x, int y, int z, Lock lock, Accessor client, const Rect *region)
 	{
+		if(internalClear.pending)
+		{
+			if(lock == LOCK_DISCARD)
+			{
+				internalClear.pending = false;
+			}
+			else
+			{
+				flushClear(internalClear);
+			}
+		}
+
 		if(lock != LOCK_UNLOCKED)
 		{
 			resource->lock(client);
@@ -1386,7 +1446,13 @@ namespace sw
 			}
 		}
 
-		if(external.dirty || (isPalette(external.format) && paletteUsed != Surface::paletteID))
+		if(isPalette(external.format) && paletteUsed != Surface::paletteID)
+		{
+			external.dirty = true;   // Every texel changes with the palette
+			external.dirtyRect = getRect();
+		}
+
+		if(external.dirty)
 		{
 			if(lock != LOCK_DISCARD)
 			{
@@ -1405,7 +1471,22 @@ namespace sw
 		case LOCK_WRITEONLY:
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
-			dirtyMipmaps = true;
+			{
+				Rect rect = region ? *region : getRect();
+
+				markMipmapsDirty(rect);
+
+				if(resolved)
+				{
+					unresolvedRect = rect;
+				}
+				else
+				{
+					unresolvedRect.merge(rect);
+				}
+
+				resolved = false;
+			}
 			break;
 		default:
 			ASSERT(false);
@@ -1416,7 +1497,7 @@ namespace sw
 			resolve();
 		}
 
-		return internal.lockRect(x, y, z, lock);
+		return internal.lockRect(x, y, z, lock, region);
 	}
 
 	void Surface::unlockInternal()
@@ -1428,6 +1509,11 @@ namespace sw
 
 	void *Surface::lockStencil(int front, Accessor client)
 	{
+		if(stencilClear.pending)
+		{
+			flushClear(stencilClear);
+		}
+
 		resource->lock(client);
 
 		if(!stencil.buffer)
@@ -1435,7 +1521,7 @@ namespace sw
 			stencil.buffer = allocateBuffer(stencil.width, stencil.height, stencil.depth, stencil.format);
 		}
 
-		return stencil.lockRect(0, 0, front, LOCK_READWRITE);   // FIXME
+		return stencil.lockRect(0, 0, front, LOCK_READWRITE, nullptr);   // FIXME
 	}
 
 	void Surface::unlockStencil()
@@ -1773,65 +1859,128 @@ namespace sw
 		{
 			ASSERT(source.dirty && !destination.dirty);
 
-			switch(source.format)
+			int width = min(destination.width, source.width);
+			int height = min(destination.height, source.height);
+
+			Rect region = source.dirtyRect;
+			region.clip(0, 0, width, height);
+
+			bool entire = region.x0 == 0 && region.y0 == 0 && region.x1 == width && region.y1 == height;
+
+			// Compressed blocks and planar formats are decoded as a whole
+			bool partial = !isCompressed(source.format) &&
+			               source.format != FORMAT_YV12_BT601 && source.format != FORMAT_YV12_BT709 && source.format != FORMAT_YV12_JFIF;
+
+			if(!entire && partial)
 			{
-			case FORMAT_R8G8B8:		decodeR8G8B8(destination, source);		break;   // FIXME: Check destination format
-			case FORMAT_X1R5G5B5:	decodeX1R5G5B5(destination, source);	break;   // FIXME: Check destination format
-			case FORMAT_A1R5G5B5:	decodeA1R5G5B5(destination, source);	break;   // FIXME: Check destination format
-			case FORMAT_X4R4G4B4:	decodeX4R4G4B4(destination, source);	break;   // FIXME: Check destination format
-			case FORMAT_A4R4G4B4:	decodeA4R4G4B4(destination, source);	break;   // FIXME: Check destination format
-			case FORMAT_P8:			decodeP8(destination, source);			break;   // FIXME: Check destination format
-			#if S3TC_SUPPORT
-			case FORMAT_DXT1:		decodeDXT1(destination, source);		break;   // FIXME: Check destination format
-			case FORMAT_DXT3:		decodeDXT3(destination, source);		break;   // FIXME: Check destination format
-			case FORMAT_DXT5:		decodeDXT5(destination, source);		break;   // FIXME: Check destination format
-			#endif
-			case FORMAT_ATI1:		decodeATI1(destination, source);		break;   // FIXME: Check destination format
-			case FORMAT_ATI2:		decodeATI2(destination, source);		break;   // FIXME: Check destination format
-			case FORMAT_R11_EAC:         decodeEAC(destination, source, 1, false); break; // FIXME: Check destination format
-			case FORMAT_SIGNED_R11_EAC:  decodeEAC(destination, source, 1, true);  break; // FIXME: Check destination format
-			case FORMAT_RG11_EAC:        decodeEAC(destination, source, 2, false); break; // FIXME: Check destination format
-			case FORMAT_SIGNED_RG11_EAC: decodeEAC(destination, source, 2, true);  break; // FIXME: Check destination format
-			case FORMAT_ETC1:
-			case FORMAT_RGB8_ETC2:                      decodeETC2(destination, source, 0, false); break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ETC2:                     decodeETC2(destination, source, 0, true);  break; // FIXME: Check destination format
-			case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:  decodeETC2(destination, source, 1, false); break; // FIXME: Check destination format
-			case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: decodeETC2(destination, source, 1, true);  break; // FIXME: Check destination format
-			case FORMAT_RGBA8_ETC2_EAC:                 decodeETC2(destination, source, 8, false); break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ETC2_EAC:          decodeETC2(destination, source, 8, true);  break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_4x4_KHR:           decodeASTC(destination, source, 4,  4,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_5x4_KHR:           decodeASTC(destination, source, 5,  4,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_5x5_KHR:           decodeASTC(destination, source, 5,  5,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_6x5_KHR:           decodeASTC(destination, source, 6,  5,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_6x6_KHR:           decodeASTC(destination, source, 6,  6,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_8x5_KHR:           decodeASTC(destination, source, 8,  5,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_8x6_KHR:           decodeASTC(destination, source, 8,  6,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_8x8_KHR:           decodeASTC(destination, source, 8,  8,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_10x5_KHR:          decodeASTC(destination, source, 10, 5,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_10x6_KHR:          decodeASTC(destination, source, 10, 6,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_10x8_KHR:          decodeASTC(destination, source, 10, 8,  1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_10x10_KHR:         decodeASTC(destination, source, 10, 10, 1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_12x10_KHR:         decodeASTC(destination, source, 12, 10, 1, false); break; // FIXME: Check destination format
-			case FORMAT_RGBA_ASTC_12x12_KHR:         decodeASTC(destination, source, 12, 12, 1, false); break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_4x4_KHR:   decodeASTC(destination, source, 4,  4,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_5x4_KHR:   decodeASTC(destination, source, 5,  4,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_5x5_KHR:   decodeASTC(destination, source, 5,  5,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_6x5_KHR:   decodeASTC(destination, source, 6,  5,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_6x6_KHR:   decodeASTC(destination, source, 6,  6,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_8x5_KHR:   decodeASTC(destination, source, 8,  5,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_8x6_KHR:   decodeASTC(destination, source, 8,  6,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_8x8_KHR:   decodeASTC(destination, source, 8,  8,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_10x5_KHR:  decodeASTC(destination, source, 10, 5,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_10x6_KHR:  decodeASTC(destination, source, 10, 6,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_10x8_KHR:  decodeASTC(destination, source, 10, 8,  1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_10x10_KHR: decodeASTC(destination, source, 10, 10, 1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_12x10_KHR: decodeASTC(destination, source, 12, 10, 1, true);  break; // FIXME: Check destination format
-			case FORMAT_SRGB8_ALPHA8_ASTC_12x12_KHR: decodeASTC(destination, source, 12, 12, 1, true);  break; // FIXME: Check destination format
-			default:				genericUpdate(destination, source);		break;
+				if(region.x0 >= region.x1 || region.y0 >= region.y1)
+				{
+					return;
+				}
+
+				Buffer sourceRegion = source;
+				sourceRegion.buffer = (unsigned char*)source.buffer + region.x0 * source.bytes + region.y0 * source.pitchB;
+				sourceRegion.width = region.width();
+				sourceRegion.height = region.height();
+
+				Buffer destinationRegion = destination;
+				destinationRegion.buffer = (unsigned char*)destination.buffer + region.x0 * destination.bytes + region.y0 * destination.pitchB;
+				destinationRegion.width = region.width();
+				destinationRegion.height = region.height();
+
+				decode(destinationRegion, sourceRegion);
+
+				return;
 			}
+
+			decode(destination, source);
 		}
 	}
 
+	void Surface::decode(Buffer &destination, Buffer &source)
+	{
+		switch(source.format)
+		{
+		case FORMAT_R8G8B8:		decodeR8G8B8(destination, source);		break;   // FIXME: Check destination format
+		case FORMAT_X1R5G5B5:	decodeX1R5G5B5(destination, source);	break;   // FIXME: Check destination format
+		case FORMAT_A1R5G5B5:	decodeA1R5G5B5(destination, source);	break;   // FIXME: Check destination format
+		case FORMAT_X4R4G4B4:	decodeX4R4G4B4(destination, source);	break;   // FIXME: Check destination format
+		case FORMAT_A4R4G4B4:	decodeA4R4G4B4(destination, source);	break;   // FIXME: Check destination format
+		case FORMAT_P8:			decodeP8(destination, source);			break;   // FIXME: Check destination format
+		#if S3TC_SUPPORT
+		case FORMAT_DXT1:		decodeDXT1(destination, source);		break;   // FIXME: Check destination format
+		case FORMAT_DXT3:		decodeDXT3(destination, source);		break;   // FIXME: Check destination format
+		case FORMAT_DXT5:		decodeDXT5(destination, source);		break;   // FIXME: Check destination format
+		#endif
+		case FORMAT_ATI1:		decodeATI1(destination, source);		break;   // FIXME: Check destination format
+		case FORMAT_ATI2:		decodeATI2(destination, source);		break;   // FIXME: Check destination format
+		case FORMAT_R11_EAC:         decodeEAC(destination, source, 1, false); break; // FIXME: Check destination format
+		case FORMAT_SIGNED_R11_EAC:  decodeEAC(destination, source, 1, true);  break; // FIXME: Check destination format
+		case FORMAT_RG11_EAC:        decodeEAC(destination, source, 2, false); break; // FIXME: Check destination format
+		case FORMAT_SIGNED_RG11_EAC: decodeEAC(destination, source, 2, true);  break; // FIXME: Check destination format
+		case FORMAT_ETC1:
+		case FORMAT_RGB8_ETC2:                      decodeETC2(destination, source, 0, false); break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ETC2:                     decodeETC2(destination, source, 0, true);  break; // FIXME: Check destination format
+		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:  decodeETC2(destination, source, 1, false); break; // FIXME: Check destination format
+		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: decodeETC2(destination, source, 1, true);  break; // FIXME: Check destination format
+		case FORMAT_RGBA8_ETC2_EAC:                 decodeETC2(destination, source, 8, false); break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ETC2_EAC:          decodeETC2(destination, source, 8, true);  break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_4x4_KHR:           decodeASTC(destination, source, 4,  4,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_5x4_KHR:           decodeASTC(destination, source, 5,  4,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_5x5_KHR:           decodeASTC(destination, source, 5,  5,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_6x5_KHR:           decodeASTC(destination, source, 6,  5,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_6x6_KHR:           decodeASTC(destination, source, 6,  6,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_8x5_KHR:           decodeASTC(destination, source, 8,  5,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_8x6_KHR:           decodeASTC(destination, source, 8,  6,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_8x8_KHR:           decodeASTC(destination, source, 8,  8,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_10x5_KHR:          decodeASTC(destination, source, 10, 5,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_10x6_KHR:          decodeASTC(destination, source, 10, 6,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_10x8_KHR:          decodeASTC(destination, source, 10, 8,  1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_10x10_KHR:         decodeASTC(destination, source, 10, 10, 1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_12x10_KHR:         decodeASTC(destination, source, 12, 10, 1, false); break; // FIXME: Check destination format
+		case FORMAT_RGBA_ASTC_12x12_KHR:         decodeASTC(destination, source, 12, 12, 1, false); break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_4x4_KHR:   decodeASTC(destination, source, 4,  4,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_5x4_KHR:   decodeASTC(destination, source, 5,  4,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_5x5_KHR:   decodeASTC(destination, source, 5,  5,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_6x5_KHR:   decodeASTC(destination, source, 6,  5,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_6x6_KHR:   decodeASTC(destination, source, 6,  6,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_8x5_KHR:   decodeASTC(destination, source, 8,  5,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_8x6_KHR:   decodeASTC(destination, source, 8,  6,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_8x8_KHR:   decodeASTC(destination, source, 8,  8,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_10x5_KHR:  decodeASTC(destination, source, 10, 5,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_10x6_KHR:  decodeASTC(destination, source, 10, 6,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_10x8_KHR:  decodeASTC(destination, source, 10, 8,  1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_10x10_KHR: decodeASTC(destination, source, 10, 10, 1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_12x10_KHR: decodeASTC(destination, source, 12, 10, 1, true);  break; // FIXME: Check destination format
+		case FORMAT_SRGB8_ALPHA8_ASTC_12x12_KHR: decodeASTC(destination, source, 12, 12, 1, true);  break; // FIXME: Check destination format
+		default:				genericUpdate(destination, source);		break;
+		}
+	}
+
+	void Surface::setInternalBuffer(void *buffer)
+	{
+		if(internal.buffer || external.buffer)
+		{
+			// Brings the internal buffer up to date, and waits for draws which use it
+			void *previous = lockInternal(0, 0, 0, LOCK_READWRITE, PUBLIC);
+			memcpy(buffer, previous, internal.sliceB * internal.depth);
+			unlockInternal();
+
+			if(external.buffer == previous && ownExternal)
+			{
+				external.buffer = 0;   // Shares the new buffer on the next lock
+			}
+
+			if(ownInternal && external.buffer != previous)
+			{
+				deallocate(previous);
+			}
+		}
+
+		internal.buffer = buffer;
+		ownInternal = false;
+	}
+
 	void Surface::genericUpdate(Buffer &destination, Buffer &source)
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
@@ -2702,6 +2851,12 @@ namespace sw
 		case FORMAT_X32B32G32R32UI:
 		case FORMAT_A32B32G32R32I:
 		case FORMAT_A32B32G32R32UI:
+		#if S3TC_SUPPORT
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		#endif
+		case FORMAT_ETC1:
 			return false;
 		case FORMAT_R32F:
 		case FORMAT_G32R32F:
@@ -2767,6 +2922,12 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		#if S3TC_SUPPORT
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		#endif
+		case FORMAT_ETC1:
 			return true;
 		case FORMAT_A8B8G8R8I:
 		case FORMAT_A16B16G16R16I:
@@ -3012,6 +3173,12 @@ namespace sw
 		case FORMAT_YV12_BT601:     return 3;
 		case FORMAT_YV12_BT709:     return 3;
 		case FORMAT_YV12_JFIF:      return 3;
+		#if S3TC_SUPPORT
+		case FORMAT_DXT1:           return 4;
+		case FORMAT_DXT3:           return 4;
+		case FORMAT_DXT5:           return 4;
+		#endif
+		case FORMAT_ETC1:           return 3;
 		default:
 			ASSERT(false);
 		}
@@ -3096,6 +3263,122 @@ namespace sw
 		}
 	}
 
+	void Surface::memfill(void *buffer, const void *pattern, int patternBytes, int bytes)
+	{
+		// Unlike memfill4() this leaves the data in the cache, for rows that are about to be rasterized
+		if(patternBytes == 1)
+		{
+			memset(buffer, *(const unsigned char*)pattern, bytes);
+		}
+		else if(bytes >= patternBytes)
+		{
+			// Replicate the pattern by doubling the filled part
+			memcpy(buffer, pattern, patternBytes);
+
+			for(int filled = patternBytes; filled < bytes; filled *= 2)
+			{
+				memcpy((unsigned char*)buffer + filled, buffer, min(filled, bytes - filled));
+			}
+		}
+	}
+
+	bool Surface::fastClear(const void *value, int bytes)
+	{
+		// Memory provided through setInternalBuffer() can be read by other processes at any time
+		if(bytes != internal.bytes || !ownInternal)
+		{
+			return false;
+		}
+
+		return fastClear(internalClear, value, bytes);
+	}
+
+	Surface::FastClear Surface::takeClear()
+	{
+		FastClear clear = internalClear;
+		internalClear.pending = false;
+
+		return clear;
+	}
+
+	Surface::FastClear Surface::takeStencilClear()
+	{
+		FastClear clear = stencilClear;
+		stencilClear.pending = false;
+
+		return clear;
+	}
+
+	void Surface::clearRows(const FastClear &clear, int cluster, int clusterCount)
+	{
+		clearRows(internal, clear, cluster, clusterCount);
+	}
+
+	void Surface::clearStencilRows(const FastClear &clear, int cluster, int clusterCount)
+	{
+		clearRows(stencil, clear, cluster, clusterCount);
+	}
+
+	bool Surface::fastClear(FastClear &clear, const void *value, int bytes)
+	{
+		// The external buffer would overwrite the clear on the next internal lock
+		if(&clear == &internalClear && isExternalDirty())
+		{
+			return false;
+		}
+
+		if(bytes > (int)sizeof(clear.value))
+		{
+			return false;
+		}
+
+		// Draws submitted earlier may still be writing to the buffer, so only the value is recorded
+		clear.pending = true;
+		clear.bytes = bytes;
+		memcpy(clear.value, value, bytes);
+
+		markMipmapsDirty(getRect());
+
+		Counters::increment(COUNTER_FAST_CLEARS);
+
+		return true;
+	}
+
+	void Surface::flushClear(FastClear &clear)
+	{
+		TraceScope scope("Surface::flushClear");
+
+		clear.pending = false;
+
+		// Waits for the draws submitted before the clear
+		if(&clear == &stencilClear)
+		{
+			memfill(lockStencil(0, PUBLIC), clear.value, clear.bytes, stencil.sliceB * stencil.depth);
+			unlockStencil();
+		}
+		else
+		{
+			memfill(lockInternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC), clear.value, clear.bytes, internal.sliceB * internal.depth);
+			unlockInternal();
+		}
+
+		Counters::increment(COUNTER_FAST_CLEAR_FLUSHES);
+	}
+
+	void Surface::clearRows(const Buffer &buffer, const FastClear &clear, int cluster, int clusterCount)
+	{
+		// Pixel clusters own interleaved pairs of rows, which are also contiguous in quad layout
+		for(int z = 0; z < buffer.depth; z++)
+		{
+			unsigned char *slice = (unsigned char*)buffer.buffer + z * buffer.sliceB;
+
+			for(int y = 2 * cluster; y < buffer.height; y += 2 * clusterCount)
+			{
+				memfill(slice + y * buffer.pitchB, clear.value, clear.bytes, min(2 * buffer.pitchB, buffer.sliceB - y * buffer.pitchB));
+			}
+		}
+	}
+
 	bool Surface::isEntire(const SliceRect& rect) const
 	{
 		return (rect.x0 == 0 && rect.y0 == 0 && rect.x1 == internal.width && rect.y1 == internal.height && internal.depth == 1);
@@ -3125,14 +3408,26 @@ namespace sw
 		const bool entire = x0 == 0 && y0 == 0 && width == internal.width && height == internal.height;
 		const Lock lock = entire ? LOCK_DISCARD : LOCK_WRITEONLY;
 
+		const bool quadLayout = internal.format != FORMAT_D32F_LOCKABLE &&
+		                        internal.format != FORMAT_D32FS8_TEXTURE &&
+		                        internal.format != FORMAT_D32FS8_SHADOW;
+
+		if(entire)
+		{
+			float value = (quadLayout && complementaryDepthBuffer) ? 1 - depth : depth;
+
+			if(fastClear(internalClear, &value, sizeof(value)))
+			{
+				return;
+			}
+		}
+
 		int width2 = (internal.width + 1) & ~1;
 
 		int x1 = x0 + width;
 		int y1 = y0 + height;
 
-		if(internal.format == FORMAT_D32F_LOCKABLE ||
-		   internal.format == FORMAT_D32FS8_TEXTURE ||
-		   internal.format == FORMAT_D32FS8_SHADOW)
+		if(!quadLayout)
 		{
 			float *target = (float*)lockInternal(0, 0, 0, lock, PUBLIC) + x0 + width2 * y0;
 
@@ -3247,6 +3542,14 @@ namespace sw
 		if(y0 < 0) {height += y0; y0 = 0;}
 		if(y0 + height > internal.height) height = internal.height - y0;
 
+		if(mask == 0xFF && x0 == 0 && y0 == 0 && width == internal.width && height == internal.height)
+		{
+			if(fastClear(stencilClear, &s, sizeof(s)))
+			{
+				return;
+			}
+		}
+
 		int width2 = (internal.width + 1) & ~1;
 
 		int x1 = x0 + width;
@@ -3308,15 +3611,16 @@ namespace sw
 	{
 		unsigned char *row;
 		Buffer *buffer;
+		Rect region(x0, y0, x0 + width, y0 + height);
 
 		if(internal.dirty)
 		{
-			row = (unsigned char*)lockInternal(x0, y0, 0, LOCK_WRITEONLY, PUBLIC);
+			row = (unsigned char*)lockInternal(x0, y0, 0, LOCK_WRITEONLY, PUBLIC, &region);
 			buffer = &internal;
 		}
 		else
 		{
-			row = (unsigned char*)lockExternal(x0, y0, 0, LOCK_WRITEONLY, PUBLIC);
+			row = (unsigned char*)lockExternal(x0, y0, 0, LOCK_WRITEONLY, PUBLIC, &region);
 			buffer = &external;
 		}
 
@@ -3423,6 +3727,28 @@ namespace sw
 		return dirtyMipmaps;
 	}
 
+	Rect Surface::getDirtyMipmapRect() const
+	{
+		Rect rect = dirtyMipmapRect;
+		rect.clip(0, 0, internal.width, internal.height);
+
+		return rect;
+	}
+
+	void Surface::markMipmapsDirty(const Rect &rect)
+	{
+		if(dirtyMipmaps)
+		{
+			dirtyMipmapRect.merge(rect);
+		}
+		else
+		{
+			dirtyMipmapRect = rect;
+		}
+
+		dirtyMipmaps = true;
+	}
+
 	void Surface::cleanMipmaps()
 	{
 		dirtyMipmaps = false;
@@ -3559,6 +3885,7 @@ namespace sw
 		case FORMAT_DXT1:
 		case FORMAT_DXT3:
 		case FORMAT_DXT5:
+			return compressedTextureSampling ? format : FORMAT_A8R8G8B8;
 		#endif
 		case FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
 		case FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
@@ -3606,6 +3933,7 @@ namespace sw
 		case FORMAT_SIGNED_RG11_EAC:
 			return FORMAT_G32R32F; // FIXME: Signed 8bit format would be sufficient
 		case FORMAT_ETC1:
+			return compressedTextureSampling ? FORMAT_ETC1 : FORMAT_X8R8G8B8;
 		case FORMAT_RGB8_ETC2:
 		case FORMAT_SRGB8_ETC2:
 			return FORMAT_X8R8G8B8;
@@ -3678,22 +4006,64 @@ namespace sw
 		Surface::paletteID++;
 	}
 
+	bool Surface::requiresResolve() const
+	{
+		return internal.depth > 1 && internal.dirty && !resolved && renderTarget && internal.format != FORMAT_NULL;
+	}
+
+	Rect Surface::getUnresolvedRect() const
+	{
+		Rect rect = unresolvedRect;
+		rect.clip(0, 0, internal.width, internal.height);
+
+		return rect;
+	}
+
+	void Surface::markResolved()
+	{
+		resolved = true;
+	}
+
 	void Surface::resolve()
 	{
-		if(internal.depth <= 1 || !internal.dirty || !renderTarget || internal.format == FORMAT_NULL)
+		if(!requiresResolve())
 		{
 			return;
 		}
 
-		void *source = internal.lockRect(0, 0, 0, LOCK_READWRITE);
+		Rect rows = getUnresolvedRect();
+
+		resolveRows(rows.y0, rows.y1);
 
+		resolved = true;
+	}
+
+	void Surface::resolve(const Rect &rows, int cluster, int clusterCount)
+	{
+		// Pixel clusters own interleaved pairs of rows
+		int y = 2 * cluster + 2 * clusterCount * (rows.y0 / (2 * clusterCount));
+
+		for(; y < rows.y1; y += 2 * clusterCount)
+		{
+			int y0 = max(y, rows.y0);
+			int y1 = min(y + 2, rows.y1);
+
+			if(y0 < y1)
+			{
+				resolveRows(y0, y1);
+			}
+		}
+	}
+
+	void Surface::resolveRows(int y0, int y1)
+	{
 		int quality = internal.depth;
 		int width = internal.width;
-		int height = internal.height;
+		int height = y1 - y0;
 		int pitch = internal.pitchB;
 		int slice = internal.sliceB;
 
-		unsigned char *source0 = (unsigned char*)source;
+		unsigned char *source0 = (unsigned char*)internal.buffer + y0 * pitch;
 		unsigned char *source1 = source0 + slice;
 		unsigned char *source2 = source1 + slice;
 		unsigned char *source3 = source2 + slice;
@@ -29,6 +29,7 @@ namespace sw
 		Rect(int x0i, int y0i, int x1i, int y1i) : x0(x0i), y0(y0i), x1(x1i), y1(y1i) {}
 
 		void clip(int minX, int minY, int maxX, int maxY);
+		void merge(const Rect &rect);   // Grows to the bounding rectangle of both
 
 		int width() const  { return x1 - x0; }
 		int height() const { return y1 - y0; }
@@ -232,7 +233,7 @@ namespace sw
 			Color<float> sample(float x, float y, float z) const;
 			Color<float> sample(float x, float y) const;
 
-			void *lockRect(int x, int y, int z, Lock lock);
+			void *lockRect(int x, int y, int z, Lock lock, const Rect *region);
 			void unlockRect();
 
 			void *buffer;
@@ -248,6 +249,7 @@ namespace sw
 			Lock lock;
 
 			bool dirty;
+			Rect dirtyRect;   // Bounds of the modified texels in every slice, valid while dirty
 		};
 
 	public:
@@ -256,7 +258,7 @@ namespace sw
 
 		virtual ~Surface();
 
-		inline void *lock(int x, int y, int z, Lock lock, Accessor client, bool internal = false);
+		inline void *lock(int x, int y, int z, Lock lock, Accessor client, bool internal = false, const Rect *region = nullptr);
 		inline void unlock(bool internal = false);
 		inline int getWidth() const;
 		inline int getHeight() const;
@@ -267,7 +269,7 @@ namespace sw
 		inline int getSliceB(bool internal = false) const;
 		inline int getSliceP(bool internal = false) const;
 
-		void *lockExternal(int x, int y, int z, Lock lock, Accessor client);
+		void *lockExternal(int x, int y, int z, Lock lock, Accessor client, const Rect *region = nullptr);   // Writes stay within the region, if provided
 		void unlockExternal();
 		inline Format getExternalFormat() const;
 		inline int getExternalPitchB() const;
@@ -275,13 +277,14 @@ namespace sw
 		inline int getExternalSliceB() const;
 		inline int getExternalSliceP() const;
 
-		virtual void *lockInternal(int x, int y, int z, Lock lock, Accessor client);
+		virtual void *lockInternal(int x, int y, int z, Lock lock, Accessor client, const Rect *region = nullptr);
 		virtual void unlockInternal();
 		inline Format getInternalFormat() const;
 		inline int getInternalPitchB() const;
 		inline int getInternalPitchP() const;
 		inline int getInternalSliceB() const;
 		inline int getInternalSliceP() const;
+		void setInternalBuffer(void *buffer);   // Memory owned by the caller, of at least getInternalSliceB() * depth + 4 bytes. Current contents are moved into it.
 
 		void *lockStencil(int front, Accessor client);
 		void unlockStencil();
@@ -291,6 +294,26 @@ namespace sw
 		inline int getMultiSampleCount() const;
 		inline int getSuperSampleCount() const;
 
+		bool requiresResolve() const;
+		Rect getUnresolvedRect() const;                                 // Bounds of the samples written since the last resolve
+		void markResolved();                                            // A resolve of the current samples has been scheduled
+		void resolve(const Rect &rows, int cluster, int clusterCount);  // Rows rasterized by one pixel cluster, within the given ones
+
+		// Clears of an entire buffer only record the value. The next draw writes the rows of each pixel
+		// cluster just before rasterizing them, while any other lock writes the whole buffer first.
+		struct FastClear
+		{
+			bool pending;
+			int bytes;
+			unsigned char value[16];   // One element in the buffer's format
+		};
+
+		bool fastClear(const void *value, int bytes);   // Internal buffer, returns false if it has to be cleared right away
+		FastClear takeClear();                          // Hands the pending clear over to a draw
+		FastClear takeStencilClear();
+		void clearRows(const FastClear &clear, int cluster, int clusterCount);
+		void clearStencilRows(const FastClear &clear, int cluster, int clusterCount);
+
 		bool isEntire(const SliceRect& rect) const;
 		SliceRect getRect() const;
 		void clearDepth(float depth, int x0, int y0, int width, int height);
@@ -313,6 +336,7 @@ namespace sw
 		bool isRenderTarget() const;
 
 		bool hasDirtyMipmaps() const;
+		Rect getDirtyMipmapRect() const;   // Bounds of the texels modified since the mipmaps were cleaned
 		void cleanMipmaps();
 		inline bool isExternalDirty() const;
 		Resource *getResource();
@@ -440,15 +464,23 @@ namespace sw
 		static void decodeETC2(Buffer &internal, const Buffer &external, int nbAlphaBits, bool isSRGB);
 		static void decodeASTC(Buffer &internal, const Buffer &external, int xSize, int ySize, int zSize, bool isSRGB);
 
-		static void update(Buffer &destination, Buffer &source);
+		static void update(Buffer &destination, Buffer &source);   // Converts the dirty region of the source
+		static void decode(Buffer &destination, Buffer &source);
 		static void genericUpdate(Buffer &destination, Buffer &source);
 		static void *allocateBuffer(int width, int height, int depth, Format format);
 		static void memfill4(void *buffer, int pattern, int bytes);
+		static void memfill(void *buffer, const void *pattern, int patternBytes, int bytes);
 
 		bool identicalFormats() const;
 		Format selectInternalFormat(Format format) const;
 
 		void resolve();
+		void resolveRows(int y0, int y1);
+		void markMipmapsDirty(const Rect &rect);
+
+		bool fastClear(FastClear &clear, const void *value, int bytes);
+		void flushClear(FastClear &clear);
+		static void clearRows(const Buffer &buffer, const FastClear &clear, int cluster, int clusterCount);
 
 		Buffer external;
 		Buffer internal;
@@ -458,6 +490,11 @@ namespace sw
 		const bool renderTarget;
 
 		bool dirtyMipmaps;
+		Rect dirtyMipmapRect;   // Valid while dirtyMipmaps
+		bool resolved;          // First slice holds the average of the current samples
+		Rect unresolvedRect;    // Valid while !resolved
+		FastClear internalClear;
+		FastClear stencilClear;
 		unsigned int paletteUsed;
 
 		static unsigned int *palette;   // FIXME: Not multi-device safe
@@ -465,6 +502,7 @@ namespace sw
 
 		bool hasParent;
 		bool ownExternal;
+		bool ownInternal;
 	};
 }
 
@@ -473,9 +511,9 @@ namespace sw
 
 namespace sw
 {
-	void *Surface::lock(int x, int y, int z, Lock lock, Accessor client, bool internal)
+	void *Surface::lock(int x, int y, int z, Lock lock, Accessor client, bool internal, const Rect *region)
 	{
-		return internal ? lockInternal(x, y, z, lock, client) : lockExternal(x, y, z, lock, client);
+		return internal ? lockInternal(x, y, z, lock, client, region) : lockExternal(x, y, z, lock, client, region);
 	}
 
 	void Surface::unlock(bool internal)
@@ -21,11 +21,16 @@
 #include "PixelShader.hpp"
 #include "Constants.hpp"
 #include "Debug.hpp"
+#include "Counters.hpp"
+#include "Timer.hpp"
 
+#include <memory>
 #include <string.h>
 
 namespace sw
 {
+	extern int tierUpThreshold;
+
 	bool precacheVertex = false;
 
 	void VertexCache::clear()
@@ -182,12 +187,11 @@ namespace sw
 		uniformBufferInfo[index].offset = offset;
 	}
 
-	void VertexProcessor::lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[])
+	void VertexProcessor::useUniformBuffers(byte** u, int64_t serial)
 	{
 		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; ++i)
 		{
-			u[i] = uniformBufferInfo[i].buffer ? static_cast<byte*>(uniformBufferInfo[i].buffer->lock(PUBLIC, PRIVATE)) + uniformBufferInfo[i].offset : nullptr;
-			uniformBuffers[i] = uniformBufferInfo[i].buffer;
+			u[i] = uniformBufferInfo[i].buffer ? static_cast<byte*>(uniformBufferInfo[i].buffer->use(serial)) + uniformBufferInfo[i].offset : nullptr;
 		}
 	}
 
@@ -201,12 +205,11 @@ namespace sw
 		transformFeedbackInfo[index].stride = stride;
 	}
 
-	void VertexProcessor::lockTransformFeedbackBuffers(byte** t, unsigned int* v, unsigned int* r, unsigned int* c, unsigned int* s, sw::Resource* transformFeedbackBuffers[])
+	void VertexProcessor::useTransformFeedbackBuffers(byte** t, unsigned int* v, unsigned int* r, unsigned int* c, unsigned int* s, int64_t serial)
 	{
 		for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; ++i)
 		{
-			t[i] = transformFeedbackInfo[i].buffer ? static_cast<byte*>(transformFeedbackInfo[i].buffer->lock(PUBLIC, PRIVATE)) + transformFeedbackInfo[i].offset : nullptr;
-			transformFeedbackBuffers[i] = transformFeedbackInfo[i].buffer;
+			t[i] = transformFeedbackInfo[i].buffer ? static_cast<byte*>(transformFeedbackInfo[i].buffer->use(serial)) + transformFeedbackInfo[i].offset : nullptr;
 			v[i] = transformFeedbackInfo[i].reg;
 			r[i] = transformFeedbackInfo[i].row;
 			c[i] = transformFeedbackInfo[i].col;
@@ -1027,27 +1030,54 @@ namespace sw
 
 	Routine *VertexProcessor::routine(const State &state)
 	{
+		routineCache->update();
+
 		Routine *routine = routineCache->query(state);
 
 		if(!routine)   // Create one
 		{
-			VertexRoutine *generator = 0;
+			TierScope tier(tierUpThreshold > 0 ? TIER_FAST : TIER_OPTIMIZED);
 
-			if(state.fixedFunction)
-			{
-				generator = new VertexPipeline(state);
-			}
-			else
+			routine = generate(state, context->vertexShader);
+			routineCache->add(state, routine);
+
+			Counters::increment(COUNTER_ROUTINE_MISSES);
+		}
+		else
+		{
+			if(routine->getTier() == TIER_FAST && routine->incrementUses() == tierUpThreshold)   // Replace a fast tier one in the background
 			{
-				generator = new VertexProgram(state, context->vertexShader);
+				// Copy the shader, as it may be deleted before the background compile gets to it
+				std::shared_ptr<VertexShader> shader(!state.fixedFunction ? new VertexShader(context->vertexShader) : nullptr);
+
+				routineCache->tierUp(state, [=]() { return generate(state, shader.get()); });
 			}
 
-			generator->generate();
-			routine = (*generator)(L"VertexRoutine_%0.8X", state.shaderID);
-			delete generator;
+			Counters::increment(COUNTER_ROUTINE_HITS);
+		}
 
-			routineCache->add(state, routine);
+		return routine;
+	}
+
+	Routine *VertexProcessor::generate(const State &state, const VertexShader *shader)
+	{
+		int64_t startTime = Timer::counter();
+		VertexRoutine *generator = 0;
+
+		if(state.fixedFunction)
+		{
+			generator = new VertexPipeline(state);
 		}
+		else
+		{
+			generator = new VertexProgram(state, shader);
+		}
+
+		generator->generate();
+		Routine *routine = (*generator)(L"VertexRoutine<%0.8X,%0.8X>", state.shaderID, state.hash);
+		delete generator;
+
+		Counters::add(COUNTER_JIT_MICROSECONDS, (Timer::counter() - startTime) * 1000000 / Timer::frequency());
 
 		return routine;
 	}
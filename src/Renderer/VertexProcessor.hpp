@@ -193,10 +193,10 @@ namespace sw
 		virtual void setBooleanConstant(unsigned int index, int boolean);
 
 		virtual void setUniformBuffer(int index, sw::Resource* uniformBuffer, int offset);
-		virtual void lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[]);
+		virtual void useUniformBuffers(byte** u, int64_t serial);
 
 		virtual void setTransformFeedbackBuffer(int index, sw::Resource* transformFeedbackBuffer, int offset, unsigned int reg, unsigned int row, unsigned int col, size_t stride);
-		virtual void lockTransformFeedbackBuffers(byte** t, unsigned int* v, unsigned int* r, unsigned int* c, unsigned int* s, sw::Resource* transformFeedbackBuffers[]);
+		virtual void useTransformFeedbackBuffers(byte** t, unsigned int* v, unsigned int* r, unsigned int* c, unsigned int* s, int64_t serial);
 
 		// Transformations
 		virtual void setModelMatrix(const Matrix &M, int i = 0);
@@ -277,6 +277,7 @@ namespace sw
 
 		const State update(DrawType drawType);
 		Routine *routine(const State &state);
+		static Routine *generate(const State &state, const VertexShader *shader);   // Also called on the tier-up thread
 
 		bool isFixedFunction();
 		void setRoutineCacheSize(int cacheSize);
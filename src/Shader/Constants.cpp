@@ -298,6 +298,17 @@ namespace sw
 			sRGBtoLinear12_16[i] = (unsigned short)(clamp(sw::sRGBtoLinear((float)i / 0x0FFF) * 0xFFFF + 0.5f, 0.0f, (float)0xFFFF));
 		}
 
+		static const int etcModifier[8][4] = {{2, 8, -2, -8},
+		                                      {5, 17, -5, -17},
+		                                      {9, 29, -9, -29},
+		                                      {13, 42, -13, -42},
+		                                      {18, 60, -18, -60},
+		                                      {24, 80, -24, -80},
+		                                      {33, 106, -33, -106},
+		                                      {47, 183, -47, -183}};
+
+		memcpy(&this->etcModifier, &etcModifier, sizeof(etcModifier));
+
 		for(int q = 0; q < 4; q++)
 		{
 			for(int c = 0; c < 16; c++)
@@ -340,6 +351,7 @@ namespace sw
 		const dword minY[16] = {0x00000000, 0x00000010, 0x00001000, 0x00001010, 0x00100000, 0x00100010, 0x00101000, 0x00101010, 0x10000000, 0x10000010, 0x10001000, 0x10001010, 0x10100000, 0x10100010, 0x10101000, 0x10101010};
 		const dword minZ[16] = {0x00000000, 0x00000020, 0x00002000, 0x00002020, 0x00200000, 0x00200020, 0x00202000, 0x00202020, 0x20000000, 0x20000020, 0x20002000, 0x20002020, 0x20200000, 0x20200020, 0x20202000, 0x20202020};
 		const dword fini[16] = {0x00000000, 0x00000080, 0x00008000, 0x00008080, 0x00800000, 0x00800080, 0x00808000, 0x00808080, 0x80000000, 0x80000080, 0x80008000, 0x80008080, 0x80800000, 0x80800080, 0x80808000, 0x80808080};
+		const dword guard[16] = {0x00000000, 0x00000040, 0x00004000, 0x00004040, 0x00400000, 0x00400040, 0x00404000, 0x00404040, 0x40000000, 0x40000040, 0x40004000, 0x40004040, 0x40400000, 0x40400040, 0x40404000, 0x40404040};
 
 		memcpy(&this->maxX, &maxX, sizeof(maxX));
 		memcpy(&this->maxY, &maxY, sizeof(maxY));
@@ -348,6 +360,7 @@ namespace sw
 		memcpy(&this->minY, &minY, sizeof(minY));
 		memcpy(&this->minZ, &minZ, sizeof(minZ));
 		memcpy(&this->fini, &fini, sizeof(fini));
+		memcpy(&this->guard, &guard, sizeof(guard));
 
 		static const dword4 maxPos = {0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFE};
 
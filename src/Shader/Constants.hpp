@@ -77,6 +77,8 @@ namespace sw
 		unsigned short linearToSRGB12_16[4096];
 		unsigned short sRGBtoLinear12_16[4096];
 
+		int etcModifier[8][4];   // ETC1 intensity modifiers, indexed by codeword and pixel index
+
 		// Centroid parameters
 		float4 sampleX[4][16];
 		float4 sampleY[4][16];
@@ -96,6 +98,7 @@ namespace sw
 		dword minY[16];
 		dword minZ[16];
 		dword fini[16];
+		dword guard[16];
 
 		dword4 maxPos;
 
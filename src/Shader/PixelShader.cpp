@@ -29,6 +29,8 @@ namespace sw
 
 		if(ps)   // Make a copy
 		{
+			version = ps->version;
+
 			for(size_t i = 0; i < ps->getLength(); i++)
 			{
 				append(new sw::Shader::Instruction(*ps->getInstruction(i)));
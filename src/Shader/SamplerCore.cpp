@@ -227,6 +227,10 @@ namespace sw
 				case FORMAT_A8B8G8R8:
 				case FORMAT_SRGB8_X8:
 				case FORMAT_SRGB8_A8:
+				case FORMAT_DXT1:
+				case FORMAT_DXT3:
+				case FORMAT_DXT5:
+				case FORMAT_ETC1:
 				case FORMAT_V8U8:
 				case FORMAT_Q8W8V8U8:
 				case FORMAT_X8L8V8U8:
@@ -487,6 +491,10 @@ namespace sw
 				case FORMAT_A8B8G8R8:
 				case FORMAT_SRGB8_X8:
 				case FORMAT_SRGB8_A8:
+				case FORMAT_DXT1:
+				case FORMAT_DXT3:
+				case FORMAT_DXT5:
+				case FORMAT_ETC1:
 				case FORMAT_V8U8:
 				case FORMAT_Q8W8V8U8:
 				case FORMAT_X8L8V8U8:
@@ -1644,7 +1652,7 @@ namespace sw
 	{
 		Short4 uuu2;
 
-		if(!state.hasNPOTTexture && !hasFloatTexture())
+		if(!state.hasNPOTTexture && !hasFloatTexture() && !hasCompressedTextureFormat())
 		{
 			vvvv = As<UShort4>(vvvv) >> *Pointer<Long1>(mipmap + OFFSET(Mipmap,vFrac));
 			uuu2 = uuuu;
@@ -1657,6 +1665,14 @@ namespace sw
 		{
 			uuuu = MulHigh(As<UShort4>(uuuu), *Pointer<UShort4>(mipmap + OFFSET(Mipmap,width)));
 			vvvv = MulHigh(As<UShort4>(vvvv), *Pointer<UShort4>(mipmap + OFFSET(Mipmap,height)));
+
+			if(hasCompressedTextureFormat())
+			{
+				// Address the 4x4 block, which spans four Surface::bytes() units per block row
+				uuuu &= Short4(0xFFFCu);
+				vvvv = As<Short4>(As<UShort4>(vvvv) >> 2);
+			}
+
 			uuu2 = uuuu;
 			uuuu = As<Short4>(UnpackLow(uuuu, vvvv));
 			uuu2 = As<Short4>(UnpackHigh(uuu2, vvvv));
@@ -1696,7 +1712,30 @@ namespace sw
 		int f2 = state.textureType == TEXTURE_CUBE ? 2 : 0;
 		int f3 = state.textureType == TEXTURE_CUBE ? 3 : 0;
 
-		if(has16bitTextureFormat())
+		if(hasCompressedTextureFormat())
+		{
+			int blockUnit = Surface::bytes(state.textureFormat);
+
+			Pointer<Byte> block[4];
+			block[0] = buffer[f0] + blockUnit * index[0];
+			block[1] = buffer[f1] + blockUnit * index[1];
+			block[2] = buffer[f2] + blockUnit * index[2];
+			block[3] = buffer[f3] + blockUnit * index[3];
+
+			// Texel coordinates within the block
+			Int4 x = Int4(MulHigh(As<UShort4>(uuuu), *Pointer<UShort4>(mipmap + OFFSET(Mipmap,width)))) & Int4(3);
+			Int4 y = Int4(MulHigh(As<UShort4>(vvvv), *Pointer<UShort4>(mipmap + OFFSET(Mipmap,height)))) & Int4(3);
+
+			if(state.textureFormat == FORMAT_ETC1)
+			{
+				decodeETC1(c, x, y, block);
+			}
+			else
+			{
+				decodeDXT(c, x, y, block);
+			}
+		}
+		else if(has16bitTextureFormat())
 		{
 			c.x = Insert(c.x, *Pointer<Short>(buffer[f0] + 2 * index[0]), 0);
 			c.x = Insert(c.x, *Pointer<Short>(buffer[f1] + 2 * index[1]), 1);
@@ -1962,6 +2001,168 @@ namespace sw
 		else ASSERT(false);
 	}
 
+	void SamplerCore::decodeDXT(Vector4s &c, Int4 &x, Int4 &y, Pointer<Byte> block[4])
+	{
+		bool dxt1 = state.textureFormat == FORMAT_DXT1;
+		int colorOffset = dxt1 ? 0 : 8;   // DXT3 and DXT5 blocks start with 64 bits of alpha
+
+		Int4 endpoints;
+		Int4 lut;
+		Int4 alphaLow;
+		Int4 alphaHigh;
+
+		for(int i = 0; i < 4; i++)
+		{
+			endpoints = Insert(endpoints, *Pointer<Int>(block[i] + colorOffset), i);
+			lut = Insert(lut, *Pointer<Int>(block[i] + colorOffset + 4), i);
+
+			if(!dxt1)
+			{
+				alphaLow = Insert(alphaLow, *Pointer<Int>(block[i] + 0), i);
+				alphaHigh = Insert(alphaHigh, *Pointer<Int>(block[i] + 4), i);
+			}
+		}
+
+		Int4 t = (y << 2) | x;
+		Int4 select = (lut >> (t << 1)) & Int4(3);
+
+		Int4 is0 = CmpEQ(select, Int4(0));
+		Int4 is1 = CmpEQ(select, Int4(1));
+		Int4 is2 = CmpEQ(select, Int4(2));
+		Int4 is3 = CmpEQ(select, Int4(3));
+
+		Int4 c0 = endpoints & Int4(0xFFFF);
+		Int4 c1 = (endpoints >> 16) & Int4(0xFFFF);
+
+		Int4 fourColors = Int4(0xFFFFFFFF);
+
+		if(dxt1)
+		{
+			fourColors = CmpNLE(c0, c1);   // Otherwise three colors and transparent black
+		}
+
+		Int4 e0[3];
+		Int4 e1[3];
+
+		e0[0] = ((c0 & Int4(0xF800)) >> 8) | ((c0 & Int4(0xE000)) >> 13);
+		e0[1] = ((c0 & Int4(0x07E0)) >> 3) | ((c0 & Int4(0x0600)) >> 9);
+		e0[2] = ((c0 & Int4(0x001F)) << 3) | ((c0 & Int4(0x001C)) >> 2);
+		e1[0] = ((c1 & Int4(0xF800)) >> 8) | ((c1 & Int4(0xE000)) >> 13);
+		e1[1] = ((c1 & Int4(0x07E0)) >> 3) | ((c1 & Int4(0x0600)) >> 9);
+		e1[2] = ((c1 & Int4(0x001F)) << 3) | ((c1 & Int4(0x001C)) >> 2);
+
+		Int4 rgb[3];
+
+		for(int i = 0; i < 3; i++)
+		{
+			Int4 third = ((e0[i] + e0[i] + e1[i] + Int4(1)) * Int4(0x5556)) >> 16;   // (2 * c0 + c1 + 1) / 3
+			Int4 twoThirds = ((e0[i] + e1[i] + e1[i] + Int4(1)) * Int4(0x5556)) >> 16;   // (c0 + 2 * c1 + 1) / 3
+			Int4 half = (e0[i] + e1[i]) >> 1;
+
+			Int4 e2 = (third & fourColors) | (half & ~fourColors);
+			Int4 e3 = twoThirds & fourColors;
+
+			rgb[i] = (e0[i] & is0) | (e1[i] & is1) | (e2 & is2) | (e3 & is3);
+		}
+
+		Int4 alpha;
+
+		switch(state.textureFormat)
+		{
+		case FORMAT_DXT1:
+			alpha = ~(is3 & ~fourColors) & Int4(0xFF);
+			break;
+		case FORMAT_DXT3:
+			{
+				Int4 high = CmpNLT(t, Int4(8));
+				Int4 shift = (t << 2) & Int4(31);
+
+				alpha = (((alphaLow >> shift) & ~high) | ((alphaHigh >> shift) & high)) & Int4(0x0F);
+				alpha = alpha | (alpha << 4);
+			}
+			break;
+		case FORMAT_DXT5:
+			{
+				Int4 a0 = alphaLow & Int4(0xFF);
+				Int4 a1 = (alphaLow >> 8) & Int4(0xFF);
+
+				// 3-bit indices start at bit 16 of the 64-bit alpha field and can straddle its halves
+				Int4 bit = t + t + t + Int4(16);
+				Int4 low = CmpLT(bit, Int4(32));
+				Int4 lowIndex = As<Int4>(As<UInt4>(alphaLow) >> As<UInt4>(Min(bit, Int4(31)))) | (alphaHigh << Max(Int4(32) - bit, Int4(1)));
+				Int4 highIndex = alphaHigh >> Max(bit - Int4(32), Int4(0));
+				Int4 index = ((lowIndex & low) | (highIndex & ~low)) & Int4(7);
+
+				Int4 eightAlphas = CmpNLE(a0, a1);
+				Int4 interpolated7 = (((Int4(8) - index) * a0 + (index - Int4(1)) * a1 + Int4(3)) * Int4(9363)) >> 16;    // Divide by 7
+				Int4 interpolated5 = (((Int4(6) - index) * a0 + (index - Int4(1)) * a1 + Int4(2)) * Int4(13108)) >> 16;   // Divide by 5
+				interpolated5 = (interpolated5 & CmpLT(index, Int4(6))) | (Int4(0xFF) & CmpEQ(index, Int4(7)));
+
+				alpha = (interpolated7 & eightAlphas) | (interpolated5 & ~eightAlphas);
+				alpha = (a0 & CmpEQ(index, Int4(0))) | (a1 & CmpEQ(index, Int4(1))) | (alpha & CmpNLT(index, Int4(2)));
+			}
+			break;
+		default:
+			ASSERT(false);
+		}
+
+		c.x = Short4(rgb[0] | (rgb[0] << 8));
+		c.y = Short4(rgb[1] | (rgb[1] << 8));
+		c.z = Short4(rgb[2] | (rgb[2] << 8));
+		c.w = Short4(alpha | (alpha << 8));
+	}
+
+	void SamplerCore::decodeETC1(Vector4s &c, Int4 &x, Int4 &y, Pointer<Byte> block[4])
+	{
+		Int4 hi;   // Base colors and control bits
+		Int4 lo;   // Pixel index bits
+
+		for(int i = 0; i < 4; i++)
+		{
+			hi = Insert(hi, *Pointer<Int>(block[i] + 0), i);
+			lo = Insert(lo, *Pointer<Int>(block[i] + 4), i);
+		}
+
+		Int4 flip = CmpNEQ(hi & Int4(0x01000000), Int4(0));
+		Int4 differential = CmpNEQ(hi & Int4(0x02000000), Int4(0));
+		Int4 second = CmpNEQ(((y & flip) | (x & ~flip)) & Int4(2), Int4(0));   // Sub-block 2
+		Int4 codeword = (((hi >> 26) & second) | ((hi >> 29) & ~second)) & Int4(7);
+
+		// Pixel indices are stored column-major, with the most significant bits first
+		Int4 bit = ((x << 2) | y) ^ Int4(8);
+		Int4 index = (((lo >> bit) & Int4(1)) << 1) | ((lo >> (bit + Int4(16))) & Int4(1));
+		Int4 offset = (codeword << 4) | (index << 2);
+
+		Int4 modifier;
+
+		for(int i = 0; i < 4; i++)
+		{
+			modifier = Insert(modifier, *Pointer<Int>(constants + OFFSET(Constants,etcModifier) + Extract(offset, i)), i);
+		}
+
+		Int4 rgb[3];
+
+		for(int i = 0; i < 3; i++)
+		{
+			Int4 b = (hi >> (8 * i)) & Int4(0xFF);
+
+			Int4 individual = ((b >> 4) & ~second) | (b & second & Int4(0x0F));
+			individual = individual | (individual << 4);
+
+			Int4 delta = ((b & Int4(7)) ^ Int4(4)) - Int4(4);
+			Int4 base = (b >> 3) + (delta & second);
+			base = (base << 3) | (base >> 2);
+
+			Int4 color = (individual & ~differential) | (base & differential);
+
+			rgb[i] = Min(Max(color + modifier, Int4(0)), Int4(0xFF));
+		}
+
+		c.x = Short4(rgb[0] | (rgb[0] << 8));
+		c.y = Short4(rgb[1] | (rgb[1] << 8));
+		c.z = Short4(rgb[2] | (rgb[2] << 8));
+	}
+
 	void SamplerCore::sampleTexel(Vector4f &c, Short4 &uuuu, Short4 &vvvv, Short4 &wwww, Float4 &z, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4])
 	{
 		Int index[4];
@@ -2256,6 +2457,10 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ETC1:
 			return false;
 		default:
 			ASSERT(false);
@@ -2294,6 +2499,10 @@ namespace sw
 		case FORMAT_X8B8G8R8UI:
 		case FORMAT_A8B8G8R8I:
 		case FORMAT_A8B8G8R8UI:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ETC1:
 			return true;
 		case FORMAT_R5G6B5:
 		case FORMAT_R32F:
@@ -2387,6 +2596,10 @@ namespace sw
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ETC1:
 			return false;
 		case FORMAT_L16:
 		case FORMAT_G16R16:
@@ -2475,6 +2688,10 @@ namespace sw
 		case FORMAT_V16U16:
 		case FORMAT_A16W16V16U16:
 		case FORMAT_Q16W16V16U16:
+		case FORMAT_DXT1:
+		case FORMAT_DXT3:
+		case FORMAT_DXT5:
+		case FORMAT_ETC1:
 			return false;
 		default:
 			ASSERT(false);
@@ -2483,6 +2700,11 @@ namespace sw
 		return false;
 	}
 
+	bool SamplerCore::hasCompressedTextureFormat() const
+	{
+		return Surface::isCompressed(state.textureFormat);
+	}
+
 	bool SamplerCore::isRGBComponent(int component) const
 	{
 		switch(state.textureFormat)
@@ -2544,6 +2766,10 @@ namespace sw
 		case FORMAT_V16U16:         return false;
 		case FORMAT_A16W16V16U16:   return false;
 		case FORMAT_Q16W16V16U16:   return false;
+		case FORMAT_DXT1:           return component < 3;
+		case FORMAT_DXT3:           return component < 3;
+		case FORMAT_DXT5:           return component < 3;
+		case FORMAT_ETC1:           return component < 3;
 		case FORMAT_YV12_BT601:     return component < 3;
 		case FORMAT_YV12_BT709:     return component < 3;
 		case FORMAT_YV12_JFIF:      return component < 3;
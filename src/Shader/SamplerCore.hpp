@@ -59,6 +59,8 @@ namespace sw
 		void computeIndices(Int index[4], Short4 uuuu, Short4 vvvv, Short4 wwww, const Pointer<Byte> &mipmap);
 		void sampleTexel(Vector4s &c, Short4 &u, Short4 &v, Short4 &s, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4]);
 		void sampleTexel(Vector4f &c, Short4 &u, Short4 &v, Short4 &s, Float4 &z, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4]);
+		void decodeDXT(Vector4s &c, Int4 &x, Int4 &y, Pointer<Byte> block[4]);
+		void decodeETC1(Vector4s &c, Int4 &x, Int4 &y, Pointer<Byte> block[4]);
 		void selectMipmap(Pointer<Byte> &texture, Pointer<Byte> buffer[4], Pointer<Byte> &mipmap, Float &lod, Int face[4], bool secondLOD);
 		Short4 address(Float4 &uw, AddressingMode addressingMode, Pointer<Byte>& mipmap);
 
@@ -78,6 +80,7 @@ namespace sw
 		bool has8bitTextureComponents() const;
 		bool has16bitTextureComponents() const;
 		bool hasYuvFormat() const;
+		bool hasCompressedTextureFormat() const;
 		bool isRGBComponent(int component) const;
 
 		Pointer<Byte> &constants;
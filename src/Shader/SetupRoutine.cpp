@@ -197,6 +197,11 @@ namespace sw
 			yMin = Max(yMin, *Pointer<Int>(data + OFFSET(DrawData,scissorY0)));
 			yMax = Min(yMax, *Pointer<Int>(data + OFFSET(DrawData,scissorY1)));
 
+			If(yMin >= yMax)   // Outside the scissor rectangle
+			{
+				Return(false);
+			}
+
 			For(Int q = 0, q < state.multiSample, q++)
 			{
 				Array<Int> Xq(16);
@@ -224,7 +229,7 @@ namespace sw
 
 				if(state.multiSample > 1)
 				{
-					Short x = Short((X[0] + 0xF) >> 4);
+					Short x = Short(Clamp((X[0] + 0xF) >> 4, *Pointer<Int>(data + OFFSET(DrawData,scissorX0)), *Pointer<Int>(data + OFFSET(DrawData,scissorX1))));
 
 					For(Int y = yMin - 1, y < yMax + 1, y++)
 					{
@@ -474,7 +479,7 @@ namespace sw
 			Return(true);
 		}
 
-		routine = function(L"SetupRoutine");
+		routine = function(L"SetupRoutine<%0.8X>", state.hash);
 	}
 
 	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool perspective, bool wrap, int component)
@@ -587,12 +592,23 @@ namespace sw
 				Int FDX12 = DX12 << 4;
 				Int FDY12 = DY12 << 4;
 
-				Int X = DX12 * ((y1 << 4) - Y1) + X1 * DY12;
+				// The edge at row y1 is at (DX12 * ((y1 << 4) - Y1) + X1 * DY12) / FDY12. Vertices in the guard band
+				// make those products overflow, so whole multiples of FDY12 are split off into A first.
+				Int Y1i = Y1 >> 4;
+				Int Y1f = Y1 & 0xF;
+				Int X1i = X1 >> 4;
+				Int X1f = X1 & 0xF;
+
+				Int DXY = DX12 * (y1 - Y1i);   // Fits for coordinates within the guard band
+				Int A = X1i + DXY / DY12;
+				Int X = ((DXY % DY12) << 4) - DX12 * Y1f + X1f * DY12;
+
 				Int x = X / FDY12;     // Edge
 				Int d = X % FDY12;     // Error-term
 				Int ceil = -d >> 31;   // Ceiling division: remainder <= 0
 				x -= ceil;
 				d -= ceil & FDY12;
+				x += A;
 
 				Int Q = FDX12 / FDY12;   // Edge-step
 				Int R = FDX12 % FDY12;   // Error-step
@@ -18,6 +18,7 @@
 #include "PixelShader.hpp"
 #include "Math.hpp"
 #include "Debug.hpp"
+#include "Thread.hpp"
 
 #include <set>
 #include <fstream>
@@ -26,7 +27,7 @@
 
 namespace sw
 {
-	volatile int Shader::serialCounter = 1;
+	volatile int Shader::serialCounter = 0;   // Shaders may be compiled concurrently
 
 	Shader::Opcode Shader::OPCODE_DP(int i)
 	{
@@ -1109,7 +1110,7 @@ namespace sw
 		       analysisLeave;
 	}
 
-	Shader::Shader() : serialID(serialCounter++)
+	Shader::Shader() : serialID(atomicIncrement(&serialCounter))
 	{
 		usedSamplers = 0;
 	}
@@ -131,6 +131,12 @@ namespace sw
 		Int4 finiteXYZ = finiteX & finiteY & finiteZ;
 		clipFlags |= *Pointer<Int>(constants + OFFSET(Constants,fini) + SignMask(finiteXYZ) * 4);
 
+		// Vertices behind the eye are never within the guard band
+		Int4 guardX = CmpNLE(o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandX0)), o[pos].x) | CmpLT(o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandX1)), o[pos].x);
+		Int4 guardY = CmpNLE(o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandY0)), o[pos].y) | CmpLT(o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandY1)), o[pos].y);
+		Int4 guardW = CmpLE(o[pos].w, Float4(0.0f));
+		clipFlags |= *Pointer<Int>(constants + OFFSET(Constants,guard) + SignMask(guardX | guardY | guardW) * 4);
+
 		if(state.preTransformed)
 		{
 			clipFlags &= 0xFBFBFBFB;   // Don't clip against far clip plane
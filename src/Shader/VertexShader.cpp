@@ -35,6 +35,8 @@ namespace sw
 
 		if(vs)   // Make a copy
 		{
+			version = vs->version;
+
 			for(size_t i = 0; i < vs->getLength(); i++)
 			{
 				append(new sw::Shader::Instruction(*vs->getInstruction(i)));
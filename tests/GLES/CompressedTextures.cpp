@@ -0,0 +1,221 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that the sampler decodes compressed textures exactly like the decoders
+// used at upload. Textures of random blocks are sampled with point and linear
+// filtering, first by a context which decompresses them, then by one created
+// after enabling the CompressedTextureSampling option. The test writes that
+// option to SwiftShader.ini in its working directory, so it gets run from a
+// directory of its own.
+
+#include "GLESTest.hpp"
+
+#include <GLES2/gl2ext.h>
+
+#include <string.h>
+
+const int width = 64;
+const int height = 64;
+
+struct Format
+{
+	GLenum format;
+	const char *extension;
+	int blockSize;
+};
+
+const Format formats[] =
+{
+	{GL_ETC1_RGB8_OES, "GL_OES_compressed_ETC1_RGB8_texture", 8},
+	{GL_COMPRESSED_RGB_S3TC_DXT1_EXT, "GL_EXT_texture_compression_dxt1", 8},
+	{GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, "GL_EXT_texture_compression_dxt1", 8},
+	{GL_COMPRESSED_RGBA_S3TC_DXT3_ANGLE, "GL_ANGLE_texture_compression_dxt3", 16},
+	{GL_COMPRESSED_RGBA_S3TC_DXT5_ANGLE, "GL_ANGLE_texture_compression_dxt5", 16},
+};
+
+const int sizes[][2] = {{20, 12}, {13, 7}};   // Including partial blocks
+
+static bool supported(const char *extension)
+{
+	const char *extensions = (const char*)glGetString(GL_EXTENSIONS);
+
+	return extensions && strstr(extensions, extension);
+}
+
+// Draws the texture over the whole framebuffer, with texture coordinates from -0.3 to 1.7 for linear filtering
+static std::vector<unsigned char> draw(GLuint texture, GLenum filter)
+{
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+	const float scale = (filter == GL_LINEAR) ? 2.0f : 1.0f;
+	const float offset = (filter == GL_LINEAR) ? -0.3f : 0.0f;
+	const float quad[] =
+	{
+		-1.0f, -1.0f, offset,         offset,
+		 1.0f, -1.0f, offset + scale, offset,
+		-1.0f,  1.0f, offset,         offset + scale,
+		 1.0f,  1.0f, offset + scale, offset + scale,
+	};
+
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, quad);
+	glEnableVertexAttribArray(0);
+
+	glClearColor(0.5f, 0.5f, 0.5f, 0.5f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+	return readPixels(width, height);
+}
+
+// Renders every supported format with the current context, in a fixed order
+static std::vector<std::vector<unsigned char>> renderAll()
+{
+	std::vector<std::vector<unsigned char>> images;
+
+	GLuint program = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec4 position;\n"
+		"out vec2 coordinates;\n"
+		"void main() { gl_Position = vec4(position.xy, 0.0, 1.0); coordinates = position.zw; }\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D image;\n"
+		"in vec2 coordinates;\n"
+		"out vec4 color;\n"
+		"void main() { color = texture(image, coordinates); }\n");
+
+	glUseProgram(program);
+
+	for(const Format &format : formats)
+	{
+		if(!supported(format.extension))
+		{
+			continue;
+		}
+
+		for(const int *size : sizes)
+		{
+			int blocks = ((size[0] + 3) / 4) * ((size[1] + 3) / 4);
+			std::vector<unsigned char> data(blocks * format.blockSize);
+
+			Random random(format.format + size[0]);
+
+			for(unsigned char &byte : data)
+			{
+				byte = (unsigned char)random.next();
+			}
+
+			if(format.format == GL_ETC1_RGB8_OES)
+			{
+				// Differential mode colors out of range aren't valid ETC1, they select the other ETC2 modes
+				for(int i = 0; i < blocks; i++)
+				{
+					unsigned char *block = &data[8 * i];
+
+					if(block[3] & 0x02)
+					{
+						for(int c = 0; c < 3; c++)
+						{
+							int base = block[c] >> 3;
+							int delta = ((block[c] & 0x07) ^ 0x04) - 0x04;
+
+							if(base + delta < 0 || base + delta > 31)
+							{
+								block[c] &= 0xF8;
+							}
+						}
+					}
+				}
+
+				// Individual mode with base colors of 0x88 and the smallest modifier of +2
+				const unsigned char solid[8] = {0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00};
+				memcpy(data.data(), solid, sizeof(solid));
+			}
+
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glCompressedTexImage2D(GL_TEXTURE_2D, 0, format.format, size[0], size[1], 0, (GLsizei)data.size(), data.data());
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			EXPECT(glGetError() == GL_NO_ERROR);
+
+			images.push_back(draw(texture, GL_NEAREST));
+			images.push_back(draw(texture, GL_LINEAR));
+
+			if(format.format == GL_ETC1_RGB8_OES)
+			{
+				// The bottom left texel is the first of the solid block
+				const std::vector<unsigned char> &nearest = images[images.size() - 2];
+				EXPECT(nearest[0] == 0x8A && nearest[1] == 0x8A && nearest[2] == 0x8A && nearest[3] == 0xFF);
+			}
+
+			glDeleteTextures(1, &texture);
+		}
+	}
+
+	glDeleteProgram(program);
+
+	return images;
+}
+
+int main()
+{
+	remove("SwiftShader.ini");
+
+	if(!initializeContext(width, height))
+	{
+		return 1;
+	}
+
+	std::vector<std::vector<unsigned char>> decompressed = renderAll();
+
+	// Contexts read the configuration when they're created
+	FILE *ini = fopen("SwiftShader.ini", "w");
+
+	if(!ini)
+	{
+		printf("Writing SwiftShader.ini failed\n");
+		return 1;
+	}
+
+	fprintf(ini, "[Testing]\nCompressedTextureSampling=1\n");
+	fclose(ini);
+
+	bool initialized = initializeContext(width, height);
+	remove("SwiftShader.ini");
+
+	if(!initialized)
+	{
+		return 1;
+	}
+
+	std::vector<std::vector<unsigned char>> compressed = renderAll();
+
+	printf("Compared %d images\n", (int)decompressed.size());
+
+	EXPECT(!decompressed.empty());
+	EXPECT(compressed.size() == decompressed.size());
+
+	for(size_t i = 0; i < decompressed.size() && i < compressed.size(); i++)
+	{
+		EXPECT(compressed[i] == decompressed[i]);
+	}
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that culling triangles before setup doesn't change what gets rendered.
+// Random triangles of all sizes, including degenerate ones, ones crossing the
+// guard band and ones behind the eye, are drawn with additive blending. Front
+// facing fragments add to red and back facing ones to green, as decided by
+// the setup routine. Culling either face must remove exactly the fragments of
+// that face, and scissoring must only remove the fragments outside of the
+// rectangle. Debug builds also assert that every culled triangle would not
+// have covered any samples when set up the regular way.
+
+#include "GLESTest.hpp"
+
+const int width = 128;
+const int height = 128;
+const int triangleCount = 4000;
+
+static std::vector<float> randomTriangles()
+{
+	Random random(1);
+	std::vector<float> positions;
+
+	for(int i = 0; i < triangleCount; i++)
+	{
+		float size = (i % 3 == 0) ? 0.02f : 0.5f;   // Down to subpixel size
+		size = (i % 20 == 0) ? 8.0f : size;         // Beyond the viewport
+		size = (i % 97 == 0) ? 4000.0f : size;      // Beyond the guard band
+
+		float x = random.uniform(-1.0f, 1.0f);
+		float y = random.uniform(-1.0f, 1.0f);
+
+		for(int j = 0; j < 3; j++)
+		{
+			float w = (i % 13 == 0) ? random.uniform(-0.7f, 1.3f) : 1.0f;   // Possibly behind the eye
+
+			positions.push_back((x + random.uniform(-size, size)) * w);
+			positions.push_back((y + random.uniform(-size, size)) * w);
+			positions.push_back(random.uniform(-1.0f, 1.0f) * w);
+			positions.push_back(w);
+		}
+
+		if(i % 17 == 0)   // Zero area
+		{
+			int v0 = 12 * i;
+			int v2 = 12 * i + 8;
+			positions[v2 + 0] = positions[v0 + 0];
+			positions[v2 + 1] = positions[v0 + 1];
+		}
+	}
+
+	return positions;
+}
+
+// Renders the triangles with the given face culled, or none, and returns the (resolved) result
+static std::vector<unsigned char> render(GLuint framebuffer, GLuint resolveFramebuffer, GLenum cullFace, const GLint *scissor)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glDisable(GL_SCISSOR_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if(cullFace != GL_NONE)
+	{
+		glEnable(GL_CULL_FACE);
+		glCullFace(cullFace);
+	}
+	else
+	{
+		glDisable(GL_CULL_FACE);
+	}
+
+	if(scissor)
+	{
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+	}
+
+	glDrawArrays(GL_TRIANGLES, 0, 3 * triangleCount);
+	glDisable(GL_SCISSOR_TEST);
+
+	if(resolveFramebuffer)
+	{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFramebuffer);
+		glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, resolveFramebuffer);
+	}
+
+	return readPixels(width, height);
+}
+
+// Counts the pixels of which the given channel differs, within the given rectangle or outside of it
+static int differences(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b, int channel, const GLint *rectangle = nullptr, bool inside = true)
+{
+	int count = 0;
+
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			if(rectangle)
+			{
+				bool within = x >= rectangle[0] && x < rectangle[0] + rectangle[2] &&
+				              y >= rectangle[1] && y < rectangle[1] + rectangle[3];
+
+				if(within != inside)
+				{
+					continue;
+				}
+			}
+
+			int i = 4 * (y * width + x) + channel;
+			count += (a[i] != b[i]) ? 1 : 0;
+		}
+	}
+
+	return count;
+}
+
+int main()
+{
+	if(!initializeContext(width, height))
+	{
+		return 1;
+	}
+
+	GLuint program = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec4 position;\n"
+		"void main() { gl_Position = position; }\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"out vec4 color;\n"
+		"void main() { color = gl_FrontFacing ? vec4(1.0, 0.0, 0.0, 0.0) / 255.0 : vec4(0.0, 1.0, 0.0, 0.0) / 255.0; }\n");
+
+	glUseProgram(program);
+
+	std::vector<float> positions = randomTriangles();
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, positions.data());
+	glEnableVertexAttribArray(0);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+
+	GLuint framebuffers[2];
+	GLuint renderbuffers[2];
+	glGenFramebuffers(2, framebuffers);
+	glGenRenderbuffers(2, renderbuffers);
+
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGBA8, width, height);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[0]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[1]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[1]);
+
+	const std::vector<unsigned char> blank(width * height * 4, 0);
+
+	const GLint scissors[][4] =
+	{
+		{37, 61, 40, 23},
+		{100, 3, 1, 120},
+		{0, 0, 1, 1},
+		{width - 1, 0, 1, height},
+		{5, height - 2, width - 10, 2},
+	};
+
+	for(int multisample = 0; multisample < 2; multisample++)
+	{
+		GLuint framebuffer = multisample ? framebuffers[0] : 0;
+		GLuint resolveFramebuffer = multisample ? framebuffers[1] : 0;
+
+		// The random triangles face both ways, so this culls both clockwise and counter-clockwise ones
+		std::vector<unsigned char> none = render(framebuffer, resolveFramebuffer, GL_NONE, nullptr);
+		std::vector<unsigned char> back = render(framebuffer, resolveFramebuffer, GL_BACK, nullptr);
+		std::vector<unsigned char> front = render(framebuffer, resolveFramebuffer, GL_FRONT, nullptr);
+
+		printf("Culling with %d samples\n", multisample ? 4 : 1);
+
+		EXPECT(differences(none, blank, 0) != 0 && differences(none, blank, 1) != 0);
+		EXPECT(differences(back, none, 0) == 0);
+		EXPECT(differences(back, blank, 1) == 0);
+		EXPECT(differences(front, none, 1) == 0);
+		EXPECT(differences(front, blank, 0) == 0);
+
+		for(const GLint *scissor : scissors)
+		{
+			std::vector<unsigned char> scissored = render(framebuffer, resolveFramebuffer, GL_NONE, scissor);
+
+			printf("Scissoring with %d samples to %d, %d, %d x %d\n", multisample ? 4 : 1, scissor[0], scissor[1], scissor[2], scissor[3]);
+
+			for(int channel = 0; channel < 2; channel++)
+			{
+				EXPECT(differences(scissored, none, channel, scissor, true) == 0);
+				EXPECT(differences(scissored, blank, channel, scissor, false) == 0);
+			}
+		}
+	}
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Helpers shared by the OpenGL ES tests. Each test is a separate program which
+// renders to a pbuffer and returns a non-zero exit code when a check failed.
+
+#ifndef GLESTest_hpp
+#define GLESTest_hpp
+
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+#define EXPECT(expression) \
+	do \
+	{ \
+		if(!(expression)) \
+		{ \
+			printf("%s(%d): Expected %s\n", __FILE__, __LINE__, #expression); \
+			failures++; \
+		} \
+	} \
+	while(false)
+
+// Makes an OpenGL ES 3.0 context current, rendering to a pbuffer of the given size
+inline bool initializeContext(int width, int height)
+{
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if(!eglInitialize(display, nullptr, nullptr))
+	{
+		printf("eglInitialize failed\n");
+		return false;
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+
+	if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		printf("eglChooseConfig failed\n");
+		return false;
+	}
+
+	const EGLint surfaceAttributes[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+	const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+	if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+	{
+		printf("Creating the context failed\n");
+		return false;
+	}
+
+	return true;
+}
+
+inline GLuint compileProgram(const char *vertexSource, const char *fragmentSource)
+{
+	const char *sources[2] = {vertexSource, fragmentSource};
+	const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+	GLuint program = glCreateProgram();
+
+	for(int i = 0; i < 2; i++)
+	{
+		GLuint shader = glCreateShader(types[i]);
+		glShaderSource(shader, 1, &sources[i], nullptr);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+		EXPECT(compiled == GL_TRUE);
+
+		glAttachShader(program, shader);
+		glDeleteShader(shader);
+	}
+
+	glLinkProgram(program);
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	EXPECT(linked == GL_TRUE);
+
+	return program;
+}
+
+// Reads back the RGBA8 contents of the current read framebuffer
+inline std::vector<unsigned char> readPixels(int width, int height)
+{
+	std::vector<unsigned char> pixels(width * height * 4);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+	return pixels;
+}
+
+// Deterministic on every platform, unlike rand()
+class Random
+{
+public:
+	explicit Random(unsigned int seed) : state(seed) {}
+
+	unsigned int next()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return state;
+	}
+
+	float uniform(float minimum, float maximum)   // [minimum, maximum]
+	{
+		return minimum + (maximum - minimum) * (next() & 0xFFFFFF) / (float)0xFFFFFF;
+	}
+
+private:
+	unsigned int state;
+};
+
+#endif   // GLESTest_hpp
@@ -0,0 +1,184 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that the counters can be scraped from the SwiftConfig server. The
+// server is enabled, on a port of its own, by writing SwiftShader.ini to the
+// working directory before creating the context. After a few draws, the text
+// and JSON metrics are fetched over HTTP and have to account for them.
+
+#include "GLESTest.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#if defined(_WIN32)
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#include <process.h>
+	#define getpid _getpid
+	#define close closesocket
+#else
+	#include <unistd.h>
+	#include <netdb.h>
+	#include <sys/socket.h>
+#endif
+
+const int width = 64;
+const int height = 64;
+const int drawCount = 5;
+
+// Sends a GET request for the path and returns the response, headers included
+static std::string fetch(int port, const char *path)
+{
+	std::string response;
+
+	addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	addrinfo *info = nullptr;
+
+	if(getaddrinfo("localhost", std::to_string(port).c_str(), &hints, &info) != 0 || !info)
+	{
+		return response;
+	}
+
+	// The server starts listening on a thread of its own
+	for(int attempt = 0; attempt < 50 && response.empty(); attempt++)
+	{
+		int client = (int)socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+
+		if(connect(client, info->ai_addr, (int)info->ai_addrlen) == 0)
+		{
+			std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+			send(client, request.c_str(), (int)request.size(), 0);
+
+			// The server closes the connection once it sees ours closed for writing
+			shutdown(client, 1);
+
+			char buffer[4096];
+			int length;
+
+			while((length = recv(client, buffer, sizeof(buffer), 0)) > 0)
+			{
+				response.append(buffer, length);
+			}
+		}
+		else
+		{
+			#if defined(_WIN32)
+				Sleep(100);
+			#else
+				usleep(100000);
+			#endif
+		}
+
+		close(client);
+	}
+
+	freeaddrinfo(info);
+
+	return response;
+}
+
+// Returns the value following the name at the start of a line, or -1
+static long long value(const std::string &text, const std::string &name)
+{
+	size_t position = text.find("\n" + name + " ");
+
+	if(position == std::string::npos)
+	{
+		return -1;
+	}
+
+	return atoll(text.c_str() + position + name.size() + 2);
+}
+
+int main()
+{
+	#if defined(_WIN32)
+		WSADATA winsockData;
+		WSAStartup(MAKEWORD(2, 2), &winsockData);
+	#endif
+
+	int port = 20000 + getpid() % 10000;
+
+	// Contexts read the configuration when they're created
+	FILE *ini = fopen("SwiftShader.ini", "w");
+
+	if(!ini)
+	{
+		printf("Writing SwiftShader.ini failed\n");
+		return 1;
+	}
+
+	fprintf(ini, "[Testing]\nDisableServer=0\nServerPort=%d\n", port);
+	fclose(ini);
+
+	bool initialized = initializeContext(width, height);
+	remove("SwiftShader.ini");
+
+	if(!initialized)
+	{
+		return 1;
+	}
+
+	GLuint program = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec4 position;\n"
+		"void main() { gl_Position = position; }\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"out vec4 color;\n"
+		"void main() { color = vec4(1.0); }\n");
+
+	glUseProgram(program);
+
+	const float quad[] = {-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, quad);
+	glEnableVertexAttribArray(0);
+
+	for(int i = 0; i < drawCount; i++)
+	{
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+	glFinish();
+
+	std::string text = fetch(port, "/swiftshader/metrics");
+	std::string json = fetch(port, "/swiftshader/metrics.json");
+	std::string missing = fetch(port, "/swiftshader/missing");
+
+	printf("Fetched %d bytes of metrics from port %d\n", (int)text.size(), port);
+
+	EXPECT(text.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+	EXPECT(text.find("Content-Type: text/plain") != std::string::npos);
+	EXPECT(value(text, "swiftshader_draws") >= drawCount);
+	EXPECT(value(text, "swiftshader_pixels") >= drawCount * width * height);
+	EXPECT(value(text, "swiftshader_primitives") >= 2 * drawCount);
+
+	EXPECT(json.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+	EXPECT(json.find("Content-Type: application/json") != std::string::npos);
+	EXPECT(json.find("\"swiftshader_draws\": ") != std::string::npos);
+
+	EXPECT(missing.compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,315 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that texture uploads from a pixel unpack buffer take effect in API
+// order. Random areas of two levels are uploaded from the buffer, several in a
+// row, from client memory, or rendered to, and after each step both levels are
+// drawn into a framebuffer of their own. The buffer is overwritten right after
+// the uploads. Every framebuffer is only read back at the end, and must match
+// the contents the texture had when it was drawn.
+
+#include "GLESTest.hpp"
+
+#include <string.h>
+
+const int size = 64;
+const int levels = 2;
+const int scale = 8;   // Pixels per texel, to keep the draws busy while the texture is uploaded to
+const int width = (size + size / 2) * scale;
+const int height = size * scale;
+const int stepCount = 40;
+const int bufferSize = 196608;
+const int maxUploads = 3;   // Uploads in a row, which use separate parts of the buffer
+
+// Contents of both levels, as one RGBA8 texel per integer
+struct Texture
+{
+	std::vector<unsigned int> level[levels];
+};
+
+struct Area
+{
+	int level;
+	int x, y, width, height;
+};
+
+static Area randomArea(Random &random, int level)
+{
+	Area area;
+	area.level = level;
+
+	int levelSize = size >> area.level;
+	area.x = random.next() % levelSize;
+	area.y = random.next() % levelSize;
+	area.width = 1 + random.next() % (levelSize - area.x);
+	area.height = 1 + random.next() % (levelSize - area.y);
+
+	return area;
+}
+
+// Uploads random texels to the area, from the given part of the bound unpack buffer when there is one, using random unpack parameters
+static void upload(Random &random, Texture &texture, const Area &area, bool unpackBuffer, int part)
+{
+	int rowLength = (random.next() % 2) ? area.width + random.next() % 16 : 0;
+	int skipPixels = random.next() % 8;
+	int skipRows = random.next() % 8;
+	int offset = unpackBuffer ? part * (bufferSize / maxUploads) + 4 * (random.next() % 1024) : 0;
+
+	int pitch = (rowLength ? rowLength : area.width) + skipPixels;
+	std::vector<unsigned int> source(pitch * (skipRows + area.height));
+
+	for(unsigned int &texel : source)
+	{
+		texel = random.next();
+	}
+
+	int levelSize = size >> area.level;
+
+	for(int j = 0; j < area.height; j++)
+	{
+		for(int i = 0; i < area.width; i++)
+		{
+			texture.level[area.level][(area.y + j) * levelSize + area.x + i] = source[(skipRows + j) * pitch + skipPixels + i];
+		}
+	}
+
+	// Skipped pixels are part of the row length
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, skipPixels);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, skipRows);
+
+	const void *pixels = source.data();
+
+	if(unpackBuffer)
+	{
+		glBufferSubData(GL_PIXEL_UNPACK_BUFFER, offset, source.size() * 4, source.data());
+		pixels = reinterpret_cast<const void*>((size_t)offset);
+	}
+
+	glTexSubImage2D(GL_TEXTURE_2D, area.level, area.x, area.y, area.width, area.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+// Renders a solid color into the area of level 0
+static void fill(Random &random, Texture &texture, const Area &area, GLuint framebuffer, GLuint program)
+{
+	unsigned int texel = random.next();
+	const unsigned char *color = reinterpret_cast<const unsigned char*>(&texel);
+
+	for(int j = 0; j < area.height; j++)
+	{
+		for(int i = 0; i < area.width; i++)
+		{
+			texture.level[0][(area.y + j) * size + area.x + i] = texel;
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, size, size);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(area.x, area.y, area.width, area.height);
+
+	glUseProgram(program);
+	glUniform4f(glGetUniformLocation(program, "fillColor"), color[0] / 255.0f, color[1] / 255.0f, color[2] / 255.0f, color[3] / 255.0f);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+	glDisable(GL_SCISSOR_TEST);
+}
+
+// Draws level 0 at the left of the framebuffer, and level 1 next to it, magnified
+static void draw(GLuint framebuffer, GLuint program)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glUseProgram(program);
+
+	for(int level = 0; level < levels; level++)
+	{
+		glViewport(level ? size * scale : 0, 0, (size >> level) * scale, (size >> level) * scale);
+		glUniform1f(glGetUniformLocation(program, "lod"), (float)level);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+}
+
+static int differences(const std::vector<unsigned char> &pixels, const Texture &texture)
+{
+	int count = 0;
+
+	for(int level = 0; level < levels; level++)
+	{
+		int levelSize = size >> level;
+
+		for(int y = 0; y < levelSize * scale; y++)
+		{
+			for(int x = 0; x < levelSize * scale; x++)
+			{
+				unsigned int pixel;
+				memcpy(&pixel, &pixels[4 * (y * width + (level ? size * scale : 0) + x)], 4);
+				count += (pixel != texture.level[level][(y / scale) * levelSize + x / scale]) ? 1 : 0;
+			}
+		}
+	}
+
+	return count;
+}
+
+int main()
+{
+	if(!initializeContext(size, size))
+	{
+		return 1;
+	}
+
+	const char *vertexShader =
+		"#version 300 es\n"
+		"layout(location = 0) in vec2 position;\n"
+		"out vec2 coordinates;\n"
+		"void main() { gl_Position = vec4(position, 0.0, 1.0); coordinates = position * 0.5 + 0.5; }\n";
+
+	GLuint drawProgram = compileProgram(vertexShader,
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D image;\n"
+		"uniform float lod;\n"
+		"in vec2 coordinates;\n"
+		"out vec4 color;\n"
+		"void main() { color = textureLod(image, coordinates, lod); }\n");
+
+	GLuint fillProgram = compileProgram(vertexShader,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 fillColor;\n"
+		"out vec4 color;\n"
+		"void main() { color = fillColor; }\n");
+
+	const float quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, quad);
+	glEnableVertexAttribArray(0);
+
+	Random random(1);
+	Texture texture;
+
+	GLuint buffer;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+
+	// Both levels are initially specified from the unpack buffer too
+	GLuint name;
+	glGenTextures(1, &name);
+	glBindTexture(GL_TEXTURE_2D, name);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+	for(int level = 0; level < levels; level++)
+	{
+		int levelSize = size >> level;
+		texture.level[level].resize(levelSize * levelSize);
+
+		for(unsigned int &texel : texture.level[level])
+		{
+			texel = random.next();
+		}
+
+		glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, levelSize * levelSize * 4, texture.level[level].data());
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, levelSize, levelSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+
+	GLuint textureFramebuffer;
+	glGenFramebuffers(1, &textureFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, textureFramebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, name, 0);
+	EXPECT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+	GLuint framebuffers[stepCount + 1];
+	GLuint renderbuffers[stepCount + 1];
+	glGenFramebuffers(stepCount + 1, framebuffers);
+	glGenRenderbuffers(stepCount + 1, renderbuffers);
+
+	for(int step = 0; step <= stepCount; step++)
+	{
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[step]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[step]);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[step]);
+	}
+
+	std::vector<Texture> expected;
+
+	for(int step = 0; step <= stepCount; step++)
+	{
+		if(step > 0)
+		{
+			int level = (random.next() % 4 == 0) ? 1 : 0;
+
+			if(step % 5 == 0)
+			{
+				fill(random, texture, randomArea(random, 0), textureFramebuffer, fillProgram);
+			}
+			else if(step % 7 == 0)
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				upload(random, texture, randomArea(random, level), false, 0);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+			}
+			else
+			{
+				// Uploads to the same level, which likely overlap, aren't separated by draws
+				int uploads = 1 + step % maxUploads;
+
+				for(int part = 0; part < uploads; part++)
+				{
+					upload(random, texture, randomArea(random, level), true, part);
+				}
+
+				// The uploads must have taken a copy, or be ordered before this write
+				std::vector<unsigned char> garbage(bufferSize, (unsigned char)random.next());
+				glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, garbage.data());
+			}
+		}
+
+		draw(framebuffers[step], drawProgram);
+		expected.push_back(texture);
+	}
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+	for(int step = 0; step <= stepCount; step++)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[step]);
+		std::vector<unsigned char> pixels = readPixels(width, height);
+
+		int count = differences(pixels, expected[step]);
+		EXPECT(count == 0);
+
+		if(count != 0)
+		{
+			printf("Step %d differs in %d pixels\n", step, count);
+		}
+	}
+
+	// The texture itself is read back last, through the framebuffer it's attached to
+	glBindFramebuffer(GL_FRAMEBUFFER, textureFramebuffer);
+	std::vector<unsigned char> pixels = readPixels(size, size);
+	EXPECT(memcmp(pixels.data(), texture.level[0].data(), pixels.size()) == 0);
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,158 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures texture sampling throughput for nearest, bilinear and trilinear
+// filtering, with the texture rotated by 0, 45 and 90 degrees. Rotated texture
+// coordinates walk the row-linear texels across rows instead of along them, so
+// the ratio to the unrotated time is the cost of the layout's poor locality
+// which a tiled layout would have to win back.
+//
+// Usage: TextureSamplingBenchmark [frames]
+
+#include "GLESTest.hpp"
+
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+
+const int size = 512;
+const int textureSize = 1024;
+
+struct Filter
+{
+	const char *name;
+	GLenum minFilter;
+	GLenum magFilter;
+};
+
+const Filter filters[] =
+{
+	{"nearest", GL_NEAREST, GL_NEAREST},
+	{"bilinear", GL_LINEAR, GL_LINEAR},
+	{"trilinear", GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR},
+};
+
+const int angles[] = {0, 45, 90};
+const int angleCount = sizeof(angles) / sizeof(angles[0]);
+
+// Milliseconds per frame of drawing the rotated texture over the whole target
+static double measure(GLuint program, int angle, int frames)
+{
+	float radians = angle * 3.14159265f / 180.0f;
+	glUniform2f(glGetUniformLocation(program, "rotation"), cosf(radians), sinf(radians));
+
+	// Generates the routines for this state before timing
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glFinish();
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(int frame = 0; frame < frames; frame++)
+	{
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+	glFinish();
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / frames;
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = (argc > 1) ? atoi(argv[1]) : 20;
+
+	if(frames <= 0 || !initializeContext(size, size))
+	{
+		return 1;
+	}
+
+	// Twice the texels of the target in each direction, so trilinear filtering blends levels 0 and 1
+	GLuint program = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec2 position;\n"
+		"uniform vec2 rotation;\n"
+		"out vec2 coordinates;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = vec4(position, 0.0, 1.0);\n"
+		"	coordinates = mat2(rotation.x, rotation.y, -rotation.y, rotation.x) * position * 0.5 + 0.5;\n"
+		"}\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D image;\n"
+		"in vec2 coordinates;\n"
+		"out vec4 color;\n"
+		"void main() { color = texture(image, coordinates); }\n");
+
+	glUseProgram(program);
+
+	const float quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, quad);
+	glEnableVertexAttribArray(0);
+
+	Random random(1);
+	std::vector<unsigned int> texels(textureSize * textureSize);
+
+	for(unsigned int &texel : texels)
+	{
+		texel = random.next();
+	}
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	printf("%-10s", "filter");
+
+	for(int angle : angles)
+	{
+		printf("%9d deg", angle);
+	}
+
+	printf("   (ms per %dx%d frame, ratio to 0 deg)\n", size, size);
+
+	for(const Filter &filter : filters)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter.minFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter.magFilter);
+
+		double times[angleCount];
+		printf("%-10s", filter.name);
+
+		for(int i = 0; i < angleCount; i++)
+		{
+			times[i] = measure(program, angles[i], frames);
+			printf("%13.2f", times[i]);
+		}
+
+		printf("\n%-10s", "");
+
+		for(double time : times)
+		{
+			printf("%12.2fx", time / times[0]);
+		}
+
+		printf("\n");
+	}
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	return failures ? 1 : 0;
+}
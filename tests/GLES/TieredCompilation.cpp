@@ -0,0 +1,258 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares JIT compile time and runtime with TierUpThreshold=0, where every
+// routine is generated optimized, against a non-zero threshold, where routines
+// start at the fast tier. Each configuration gets a context of its own, created
+// after writing SwiftShader.ini. The first draw of each program is made into a
+// single pixel, so its time is the routine generation. Full frames are timed
+// before the threshold is reached, and again once the optimized routines have
+// replaced the fast ones.
+//
+// Usage: TieredCompilationBenchmark [threshold]
+
+#include "GLESTest.hpp"
+
+#include <chrono>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+const int size = 512;
+const int programCount = 4;
+const int frameCount = 8;   // Per program, in each timed pass
+
+static double milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Time to draw every program, each into a single pixel on first use
+static double compile(const GLuint *programs)
+{
+	glViewport(0, 0, 1, 1);
+	glFinish();
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < programCount; i++)
+	{
+		glUseProgram(programs[i]);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		glFinish();
+	}
+
+	double time = milliseconds(start);
+	glViewport(0, 0, size, size);
+
+	return time;
+}
+
+// Milliseconds per full frame, drawing frameCount of them with every program
+static double run(const GLuint *programs)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < programCount; i++)
+	{
+		glUseProgram(programs[i]);
+
+		for(int frame = 0; frame < frameCount; frame++)
+		{
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+
+	glFinish();
+
+	return milliseconds(start) / (programCount * frameCount);
+}
+
+static bool createContext(int threshold)
+{
+	// Contexts read the configuration when they're created
+	FILE *ini = fopen("SwiftShader.ini", "w");
+
+	if(!ini)
+	{
+		printf("Writing SwiftShader.ini failed\n");
+		return false;
+	}
+
+	fprintf(ini, "[Testing]\nTierUpThreshold=%d\n", threshold);
+	fclose(ini);
+
+	bool initialized = initializeContext(size, size);
+	remove("SwiftShader.ini");
+
+	return initialized;
+}
+
+// Lit and textured, with enough arithmetic that optimization matters
+static void createPrograms(GLuint *programs)
+{
+	const char *vertexShader =
+		"#version 300 es\n"
+		"layout(location = 0) in vec2 position;\n"
+		"out vec2 coordinates;\n"
+		"out vec3 normal;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = vec4(position, 0.0, 1.0);\n"
+		"	coordinates = position * 0.5 + 0.5;\n"
+		"	normal = normalize(vec3(position, 1.0));\n"
+		"}\n";
+
+	for(int i = 0; i < programCount; i++)
+	{
+		// Distinct sources, so no shader is shared between the programs
+		std::string fragmentShader =
+			"#version 300 es\n"
+			"precision highp float;\n"
+			"#define VARIANT " + std::to_string(i + 1) + ".0\n"
+			"uniform sampler2D image;\n"
+			"in vec2 coordinates;\n"
+			"in vec3 normal;\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	vec3 n = normalize(normal);\n"
+			"	vec4 sum = vec4(0.0);\n"
+			"	for(int j = 0; j < 4; j++)\n"
+			"	{\n"
+			"		vec3 light = normalize(vec3(cos(float(j) * VARIANT), sin(float(j) * VARIANT), 1.0));\n"
+			"		vec3 halfway = normalize(light + vec3(0.0, 0.0, 1.0));\n"
+			"		float diffuse = max(dot(n, light), 0.0);\n"
+			"		float specular = pow(max(dot(n, halfway), 0.0), 16.0 * VARIANT);\n"
+			"		vec4 texel = texture(image, coordinates * VARIANT + vec2(float(j) * 0.25));\n"
+			"		sum += texel * diffuse + vec4(specular);\n"
+			"	}\n"
+			"	color = sqrt(clamp(sum * 0.25, 0.0, 1.0));\n"
+			"}\n";
+
+		programs[i] = compileProgram(vertexShader, fragmentShader.c_str());
+	}
+}
+
+static void createTexture()
+{
+	Random random(1);
+	std::vector<unsigned int> texels(256 * 256);
+
+	for(unsigned int &texel : texels)
+	{
+		texel = random.next();
+	}
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+static bool setUp(int threshold, GLuint *programs)
+{
+	if(!createContext(threshold))
+	{
+		return false;
+	}
+
+	createPrograms(programs);
+	createTexture();
+
+	static const float quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, quad);
+	glEnableVertexAttribArray(0);
+
+	// Starts the worker threads, and generates the routines which all programs share
+	GLuint warmUp = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec2 position;\n"
+		"void main() { gl_Position = vec4(position, 0.0, 1.0); }\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D image;\n"
+		"out vec4 color;\n"
+		"void main() { color = texture(image, vec2(0.5)); }\n");
+
+	glUseProgram(warmUp);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glFinish();
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	int threshold = (argc > 1) ? atoi(argv[1]) : 16;
+
+	// The fast tier pass has to stay below the threshold
+	if(threshold <= frameCount)
+	{
+		printf("The threshold has to exceed %d draws\n", frameCount);
+		return 1;
+	}
+
+	GLuint programs[programCount];
+
+	if(!setUp(0, programs))
+	{
+		return 1;
+	}
+
+	double optimizedCompile = compile(programs);
+	double optimizedRun = run(programs);
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	if(!setUp(threshold, programs))
+	{
+		return 1;
+	}
+
+	double fastCompile = compile(programs);
+	double fastRun = run(programs);
+
+	// Crosses the threshold, and gives the background thread at least the time the optimized routines took above
+	for(int i = 0; i < programCount; i++)
+	{
+		glUseProgram(programs[i]);
+
+		for(int draw = frameCount; draw < threshold; draw++)
+		{
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+
+	glFinish();
+	std::this_thread::sleep_for(std::chrono::milliseconds(2 * (int)optimizedCompile + 100));
+
+	run(programs);   // Swaps in the optimized routines
+	double tieredRun = run(programs);
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	printf("%d programs, %dx%d frames\n", programCount, size, size);
+	printf("%-22s%14s%22s%22s\n", "", "compile (ms)", "fast tier (ms/frame)", "optimized (ms/frame)");
+	printf("%-22s%14.1f%22s%22.2f\n", "TierUpThreshold=0", optimizedCompile, "-", optimizedRun);
+	printf("TierUpThreshold=%-6d%14.1f%22.2f%22.2f\n", threshold, fastCompile, fastRun, tieredRun);
+	printf("Fast tier: %.2fx less compile time, %.2fx the runtime\n", optimizedCompile / fastCompile, fastRun / optimizedRun);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks the bounds of primitives which extend past the viewport. Triangles
+// reaching far beyond it, into the guard band, must not cover pixels outside of
+// it, nor outside of a scissor rectangle within it. Wide points centered near
+// its edges must still cover the pixels up to the edges, and nothing outside
+// of the scissor rectangle.
+
+#include "GLESTest.hpp"
+
+const int width = 64;
+const int height = 64;
+const GLint viewport[4] = {16, 16, 32, 32};
+
+// Counts the covered pixels outside of the given rectangle
+static int outside(const std::vector<unsigned char> &pixels, const GLint *rectangle)
+{
+	int count = 0;
+
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			bool within = x >= rectangle[0] && x < rectangle[0] + rectangle[2] &&
+			              y >= rectangle[1] && y < rectangle[1] + rectangle[3];
+
+			count += (!within && pixels[4 * (y * width + x)] != 0) ? 1 : 0;
+		}
+	}
+
+	return count;
+}
+
+static bool covered(const std::vector<unsigned char> &pixels, int x, int y)
+{
+	return pixels[4 * (y * width + x)] != 0;
+}
+
+static std::vector<unsigned char> render(GLenum mode, const float *positions, int count, const GLint *scissor)
+{
+	glDisable(GL_SCISSOR_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if(scissor)
+	{
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+	}
+
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, positions);
+	glEnableVertexAttribArray(0);
+	glDrawArrays(mode, 0, count);
+	glDisable(GL_SCISSOR_TEST);
+
+	return readPixels(width, height);
+}
+
+int main()
+{
+	if(!initializeContext(width, height))
+	{
+		return 1;
+	}
+
+	GLuint program = compileProgram(
+		"#version 300 es\n"
+		"layout(location = 0) in vec4 position;\n"
+		"void main() { gl_Position = position; gl_PointSize = 9.0; }\n",
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"out vec4 color;\n"
+		"void main() { color = vec4(1.0); }\n");
+
+	glUseProgram(program);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+	// Within the guard band, but far outside of the viewport
+	const float triangle[] =
+	{
+		-30.0f, -30.0f, 0.0f, 1.0f,
+		 30.0f, -30.0f, 0.0f, 1.0f,
+		  0.0f,  30.0f, 0.0f, 1.0f,
+	};
+
+	std::vector<unsigned char> triangles = render(GL_TRIANGLES, triangle, 3, nullptr);
+	EXPECT(covered(triangles, viewport[0], viewport[1]));
+	EXPECT(covered(triangles, viewport[0] + viewport[2] - 1, viewport[1] + viewport[3] - 1));
+	EXPECT(outside(triangles, viewport) == 0);
+
+	const GLint scissor[4] = {20, 12, 9, 40};   // Crossing the bottom and top of the viewport
+	std::vector<unsigned char> scissoredTriangles = render(GL_TRIANGLES, triangle, 3, scissor);
+	EXPECT(covered(scissoredTriangles, scissor[0], viewport[1]));
+	EXPECT(outside(scissoredTriangles, viewport) == 0);
+	EXPECT(outside(scissoredTriangles, scissor) == 0);
+
+	// Centered inside of the viewport, near its left and right edges
+	const float points[] =
+	{
+		-0.95f, 0.0f, 0.0f, 1.0f,
+		 0.95f, 0.0f, 0.0f, 1.0f,
+	};
+
+	int centerY = viewport[1] + viewport[3] / 2;
+
+	std::vector<unsigned char> wide = render(GL_POINTS, points, 2, nullptr);
+	EXPECT(covered(wide, viewport[0], centerY));
+	EXPECT(covered(wide, viewport[0] + viewport[2] - 1, centerY));
+
+	const GLint pointScissor[4] = {0, centerY - 2, width, 4};
+	std::vector<unsigned char> scissoredPoints = render(GL_POINTS, points, 2, pointScissor);
+	EXPECT(covered(scissoredPoints, viewport[0], centerY));
+	EXPECT(covered(scissoredPoints, viewport[0] + viewport[2] - 1, centerY));
+	EXPECT(outside(scissoredPoints, pointScissor) == 0);
+
+	EXPECT(glGetError() == GL_NO_ERROR);
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+
+	return failures ? 1 : 0;
+}